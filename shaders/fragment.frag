@@ -5,9 +5,13 @@
  * This shader samples the texture containing the ray-traced black hole
  * image and outputs it to the screen. Can apply post-processing effects
  * like tone mapping or color correction.
+ * 
+ * With reconstructSparse set it instead runs at the ray tracing resolution
+ * and fills in the pixels a variable-rate dispatch skipped, writing the
+ * result unprocessed to a texture.
  */
 
-#version 330 core
+#version 430 core
 
 // Input from vertex shader
 in vec2 TexCoord;
@@ -23,6 +27,78 @@ uniform float exposure = 1.0;      // HDR exposure adjustment
 uniform float gamma = 2.2;         // Gamma correction
 uniform bool enableToneMapping = false;
 
+// Variable-rate reconstruction pass
+uniform bool reconstructSparse = false;
+
+// Same block as geodesic.comp; only the variable-rate fields are used here
+layout(std140, binding = 4) uniform Scene {
+    ivec2 renderSize;
+    int maxSteps;
+    float geodesicTolerance;
+    vec2 deflectionLogRadiusRange;
+    int useDeflectionTable;
+    int _pad0;
+    vec2 jitter;
+    vec2 rateCenter;
+    float fullRateRadius;
+    int variableRate;
+    vec2 _pad1;
+} scene;
+
+const float EDGE_SIGMA = 0.08;     // Luminance difference treated as an edge
+
+/**
+ * @brief Sampling rate of a pixel's 4x4 block (must match geodesic.comp)
+ */
+int pixelRate(ivec2 pixel) {
+    if (scene.variableRate == 0) return 1;
+    float distanceToHole = distance(vec2((pixel / 4) * 4) + 2.0, scene.rateCenter);
+    if (distanceToHole < scene.fullRateRadius) return 1;
+    return distanceToHole < 2.0 * scene.fullRateRadius ? 2 : 4;
+}
+
+/**
+ * @brief Edge-aware interpolation of a pixel from the traced samples around it
+ *
+ * Bilinear weights of the four surrounding samples are scaled down by their
+ * luminance difference to the nearest sample, so the shadow edge, the disk
+ * rim and bodies stay sharp instead of bleeding into the background.
+ *
+ * @param pixel Pixel in the ray tracing resolution
+ * @return Reconstructed color
+ */
+vec4 reconstruct(ivec2 pixel) {
+    int rate = pixelRate(pixel);
+    ivec2 offset = pixel % rate;
+    if (offset == ivec2(0)) return texelFetch(screenTexture, pixel, 0);
+    
+    ivec2 origin = pixel - offset;
+    vec2 f = vec2(offset) / float(rate);
+    ivec2 corners[4] = ivec2[4](origin, origin + ivec2(rate, 0), origin + ivec2(0, rate), origin + ivec2(rate));
+    float weights[4] = float[4]((1.0 - f.x) * (1.0 - f.y), f.x * (1.0 - f.y), (1.0 - f.x) * f.y, f.x * f.y);
+    
+    vec4 samples[4];
+    int nearest = 0;
+    for (int i = 0; i < 4; ++i) {
+        // Samples past the right or top edge do not exist
+        if (any(greaterThanEqual(corners[i], scene.renderSize))) weights[i] = 0.0;
+        samples[i] = texelFetch(screenTexture, min(corners[i], scene.renderSize - 1), 0);
+        if (weights[i] > weights[nearest]) nearest = i;
+    }
+    
+    const vec3 luma = vec3(0.2126, 0.7152, 0.0722);
+    float reference = dot(samples[nearest].rgb, luma);
+    vec4 sum = vec4(0.0);
+    float total = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        float difference = (dot(samples[i].rgb, luma) - reference) / EDGE_SIGMA;
+        float weight = weights[i] * exp(-difference * difference);
+        sum += weight * samples[i];
+        total += weight;
+    }
+    return sum / max(total, 1e-6);
+}
+
 /**
  * @brief Simple Reinhard tone mapping
  * @param color HDR color to tone map
@@ -42,6 +118,11 @@ vec3 gammaCorrection(vec3 color) {
 }
 
 void main() {
+    if (reconstructSparse) {
+        FragColor = reconstruct(ivec2(gl_FragCoord.xy));
+        return;
+    }
+    
     // Sample the ray-traced texture
     vec4 color = texture(screenTexture, TexCoord);
     
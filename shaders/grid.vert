@@ -4,25 +4,74 @@
  * 
  * This shader renders the warped spacetime grid that shows how massive
  * objects curve the fabric of spacetime around them. Vertices are
- * displaced based on the gravitational field strength.
+ * displaced based on the gravitational field strength, evaluated here from
+ * the objects storage buffer so the CPU never rebuilds the grid per frame.
  */
 
-#version 330 core
+#version 430 core
 
-// Input vertex attributes
-layout (location = 0) in vec3 aPos;        // World space position (pre-warped)
+// No vertex attributes: the grid point is derived from gl_VertexID, so only
+// the line index buffer lives on the GPU and never changes for a given size
 
 // Uniforms
 uniform mat4 viewProj;                      // Combined view-projection matrix
 uniform float time;                         // Animation time
 uniform float gridAlpha = 0.3;             // Grid transparency
+uniform int gridSize;                       // Cells per side
+uniform float gridSpacing;                  // Cell size in meters
+uniform vec4 blackHole;                     // xyz = position, w = Schwarzschild radius
+
+/**
+ * @brief Per-object record in the objects storage buffer (matches geodesic.comp)
+ */
+struct ObjectData {
+    vec4 posRadius;             // xyz = position, w = radius
+    vec4 color;                 // rgba = color
+    float mass;                 // Object mass
+    float _pad0, _pad1, _pad2;  // Padding for alignment
+};
+
+layout(std430, binding = 3) readonly buffer Objects {
+    int numObjects;
+    int _pad0, _pad1, _pad2;    // Padding for alignment
+    ObjectData data[];          // Runtime-sized object array
+} objects;
+
+// Schwarzschild radius per kilogram, 2G / c^2
+const float SCHWARZSCHILD_PER_KG = 1.48523e-27;
+
+// Depth of the flat grid below the orbital plane
+const float GRID_DEPTH = 3e10;
 
 // Output to fragment shader
 out float vertexAlpha;
 out float distanceFromCenter;
 
+/**
+ * @brief Height of Flamm's paraboloid around a mass, 2 * sqrt(rs * (r - rs))
+ * @param center Position of the mass
+ * @param rs Schwarzschild radius of the mass
+ * @param xz Grid point in the orbital plane
+ */
+float embeddingHeight(vec3 center, float rs, vec2 xz) {
+    float dist = length(xz - center.xz);
+    return 2.0 * sqrt(rs * max(dist - rs, 0.0));
+}
+
 void main() {
-    vec3 worldPos = aPos;
+    int x = gl_VertexID % (gridSize + 1);
+    int z = gl_VertexID / (gridSize + 1);
+    vec3 worldPos = vec3(float(x - gridSize / 2) * gridSpacing, 0.0, float(z - gridSize / 2) * gridSpacing);
+    
+    // Spacetime curvature from the black hole and every massive body
+    float height = embeddingHeight(blackHole.xyz, blackHole.w, worldPos.xz);
+    for (int i = 0; i < objects.numObjects; ++i) {
+        float mass = objects.data[i].mass;
+        if (mass > 0.0) {
+            height += embeddingHeight(objects.data[i].posRadius.xyz, mass * SCHWARZSCHILD_PER_KG, worldPos.xz);
+        }
+    }
+    worldPos.y = height - GRID_DEPTH;
     
     // Calculate distance from black hole center for fading
     distanceFromCenter = length(worldPos.xz);
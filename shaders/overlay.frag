@@ -0,0 +1,17 @@
+/**
+ * @file overlay.frag
+ * @brief Draws overlay text over a translucent backdrop
+ */
+
+#version 430 core
+
+in vec2 TexCoord;
+
+out vec4 FragColor;
+
+uniform sampler2D glyphs;   // Text coverage from OverlayFont (R8)
+
+void main() {
+    float coverage = texture(glyphs, TexCoord).r;
+    FragColor = mix(vec4(0.0, 0.0, 0.0, 0.6), vec4(0.9, 1.0, 0.9, 1.0), coverage);
+}
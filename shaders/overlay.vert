@@ -0,0 +1,19 @@
+/**
+ * @file overlay.vert
+ * @brief Screen-space quad for the debug text overlay
+ * 
+ * Generates the four corners of the overlay rectangle from gl_VertexID, so
+ * no vertex buffer is needed (draw as a 4-vertex triangle strip).
+ */
+
+#version 430 core
+
+uniform vec4 rect;      // Overlay rectangle in NDC: (left, bottom, right, top)
+
+out vec2 TexCoord;
+
+void main() {
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    TexCoord = corner;
+    gl_Position = vec4(mix(rect.xy, rect.zw, corner), 0.0, 1.0);
+}
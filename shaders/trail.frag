@@ -0,0 +1,16 @@
+/**
+ * @file trail.frag
+ * @brief Fragment shader for body trails
+ */
+
+#version 430 core
+
+// Input from vertex shader
+in vec4 trailColor;
+
+// Output color
+out vec4 FragColor;
+
+void main() {
+    FragColor = trailColor;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file trail.vert
+ * @brief Vertex shader for body trails, drawn as one instanced line strip per body
+ * 
+ * Every trail lives in one shared sample buffer laid out as fixed-length
+ * rings (see TrailPool). Instance i is body i: its ring is unrolled oldest to
+ * newest from gl_VertexID, and the last vertex is the body's current
+ * (interpolated) position from the objects buffer, so trails stay attached to
+ * the bodies between samples. Vertices past a ring's valid samples collapse
+ * onto that last point.
+ */
+
+#version 430 core
+
+// Uniforms
+uniform mat4 viewProj;                      // Combined view-projection matrix
+uniform uint trailLength;                   // Samples per ring
+uniform float trailAlpha = 0.8;             // Opacity of the newest segment
+
+/**
+ * @brief Per-object record in the objects storage buffer (matches geodesic.comp)
+ */
+struct ObjectData {
+    vec4 posRadius;             // xyz = position, w = radius
+    vec4 color;                 // rgba = color
+    float mass;                 // Object mass
+    float _pad0, _pad1, _pad2;  // Padding for alignment
+};
+
+layout(std430, binding = 3) readonly buffer Objects {
+    int numObjects;
+    int _pad0, _pad1, _pad2;    // Padding for alignment
+    ObjectData data[];          // Runtime-sized object array
+} objects;
+
+// Ring storage of every trail, tightly packed xyz
+layout(std430, binding = 6) readonly buffer TrailSamples {
+    float samples[];
+};
+
+// Per body: x = ring slot, y = ring head (next write), z = valid samples
+layout(std430, binding = 7) readonly buffer Trails {
+    uvec4 trails[];
+};
+
+// Output to fragment shader
+out vec4 trailColor;
+
+void main() {
+    uvec4 trail = trails[gl_InstanceID];
+    uint count = trail.z;
+    uint vertex = min(uint(gl_VertexID), count);
+    
+    vec3 worldPos;
+    if (vertex == count) {
+        worldPos = objects.data[gl_InstanceID].posRadius.xyz;
+    } else {
+        uint index = trail.x * trailLength + (trail.y + trailLength - count + vertex) % trailLength;
+        worldPos = vec3(samples[3u * index], samples[3u * index + 1u], samples[3u * index + 2u]);
+    }
+    
+    // Fade from transparent at the oldest sample to trailAlpha at the body
+    float age = 1.0 - float(vertex) / float(max(count, 1u));
+    vec4 color = objects.data[gl_InstanceID].color;
+    trailColor = vec4(color.rgb, color.a * trailAlpha * (1.0 - age));
+    
+    gl_Position = viewProj * vec4(worldPos, 1.0);
+}
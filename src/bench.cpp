@@ -0,0 +1,374 @@
+/**
+ * @file bench.cpp
+ * @brief Benchmark harness - runs scripted scenes and reports timings as JSON
+ *
+ * Every scene in the scenes file (config/benchmark.json by default) is
+ * expanded over its body counts, and render scenes also over their
+ * resolutions. Each run starts from the base configuration, the scenes
+ * file's shared "config" block and the scene's own "config" block, in that
+ * order, and its bodies come from a seeded generator, so a run is the same
+ * work on every machine and every release.
+ *
+ * Physics runs step a Physics instance directly, without a window or a GL
+ * context, and time every step. Render runs create a headless engine, keep
+ * the bodies frozen and render along the scene's camera path, finishing
+ * every frame on the GPU. Warm-up frames are excluded from all numbers.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "engine/CameraPath.h"
+#include "engine/Engine.h"
+#include "physics/Physics.h"
+#include "utils/Config.h"
+#include "utils/Logger.h"
+#include "utils/Metrics.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+/**
+ * @brief Command line settings shared by every run
+ */
+struct Options {
+    std::string configFile = "config/simulation.json";     ///< Base configuration
+    std::string scenesFile = "config/benchmark.json";      ///< Scripted scenes
+    std::string outputFile;                                 ///< Results file (empty: stdout)
+    std::string mode = "all";                               ///< physics, render or all
+    std::string scene;                                      ///< Only run this scene (empty: all)
+    int frames = 0;                                         ///< Measured frames (0: scenes file)
+};
+
+/**
+ * @brief Print command line usage
+ * @param program Executable name
+ */
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --config <file>    Base configuration (default: config/simulation.json)\n"
+              << "  --scenes <file>    Scripted scenes (default: config/benchmark.json)\n"
+              << "  --output <file>    Write the JSON results to a file instead of stdout\n"
+              << "  --mode <name>      Run physics, render or all scenes (default: all)\n"
+              << "  --scene <name>     Run a single scene\n"
+              << "  --frames <count>   Measured frames or steps per run\n"
+              << "  --help             Show this message\n";
+}
+
+/**
+ * @brief Nearest-rank percentile of sorted samples (same definition as the Profiler)
+ */
+double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+/**
+ * @brief Summarize a distribution of durations
+ * @param samples Durations in milliseconds (sorted in place)
+ * @return Mean, extremes and percentiles in milliseconds
+ */
+nlohmann::json summarize(std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double sample : samples) total += sample;
+    return {
+        {"samples", samples.size()},
+        {"mean", samples.empty() ? 0.0 : total / samples.size()},
+        {"min", samples.empty() ? 0.0 : samples.front()},
+        {"p50", percentile(samples, 0.50)},
+        {"p95", percentile(samples, 0.95)},
+        {"p99", percentile(samples, 0.99)},
+        {"max", samples.empty() ? 0.0 : samples.back()}
+    };
+}
+
+/**
+ * @brief Totals of the Metrics scopes measured during a run
+ * @param ids Scopes to report (scopes that never ran are left out)
+ * @return One object per scope, keyed by its trace name
+ */
+nlohmann::json metricStages(std::initializer_list<Metrics::Id> ids) {
+    nlohmann::json stages = nlohmann::json::object();
+    for (Metrics::Id id : ids) {
+        Metrics::Summary summary = Metrics::getInstance().getSummary(id);
+        if (summary.count == 0) continue;
+        stages[Metrics::getName(id)] = {
+            {"count", summary.count},
+            {"total", summary.totalMilliseconds},
+            {"mean", summary.totalMilliseconds / summary.count},
+            {"max", summary.maxMilliseconds}
+        };
+    }
+    return stages;
+}
+
+/**
+ * @brief Merge a JSON object of configuration values into a Config
+ */
+void mergeJson(Config& config, const nlohmann::json& values) {
+    if (!values.is_object() || values.empty()) return;
+    Config overrides;
+    if (!overrides.loadFromString(values.dump())) {
+        throw std::runtime_error("Invalid scene configuration: " + values.dump());
+    }
+    config.merge(overrides);
+}
+
+/**
+ * @brief Step the physics of one scene and time every step
+ * @param config Fully merged run configuration
+ * @param warmup Steps excluded from the results
+ * @param steps Measured steps
+ * @param result Receives the timings
+ */
+void runPhysics(const Config& config, int warmup, int steps, nlohmann::json& result) {
+    Physics physics(config);
+    const float timeStep = physics.getTimeStep();
+    for (int i = 0; i < warmup; ++i) {
+        physics.update(timeStep);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(steps));
+    const uint64_t interactionsBefore = physics.getInteractionCount();
+
+    Metrics::getInstance().start(config);
+    auto start = Clock::now();
+    for (int i = 0; i < steps; ++i) {
+        auto stepStart = Clock::now();
+        physics.update(timeStep);
+        samples.push_back(Milliseconds(Clock::now() - stepStart).count());
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    Metrics::getInstance().stop();
+
+    const uint64_t interactions = physics.getInteractionCount() - interactionsBefore;
+    result["finalBodies"] = physics.getParticles().size();
+    result["seconds"] = seconds;
+    result["step"] = summarize(samples);
+    result["stages"] = metricStages({Metrics::Id::Forces, Metrics::Id::OctreeBuild, Metrics::Id::Collisions});
+    result["stepsPerSecond"] = seconds > 0.0 ? steps / seconds : 0.0;
+    result["interactions"] = interactions;
+    result["interactionsPerSecond"] = seconds > 0.0 ? interactions / seconds : 0.0;
+}
+
+/**
+ * @brief Render one scene headless and collect the per-stage frame timings
+ * @param config Fully merged run configuration (headless section set)
+ * @param path Camera keyframes (empty for a still camera)
+ * @param fps Rate the camera path is sampled at
+ * @param warmup Frames excluded from the results
+ * @param frames Measured frames
+ * @param result Receives the timings
+ */
+void runRender(const Config& config, const CameraPath& path, double fps, int warmup, int frames,
+               nlohmann::json& result) {
+    Engine engine(config);
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    result["glRenderer"] = renderer ? reinterpret_cast<const char*>(renderer) : "";
+
+    // Shader compilation, first uploads and driver warm-up stay out of the window
+    engine.runBenchmark(path, fps, warmup);
+
+    Metrics::getInstance().start(config);
+    auto start = Clock::now();
+    engine.runBenchmark(path, fps, frames);
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    Metrics::getInstance().stop();
+
+    // profiler.window equals the measured frame count, so warm-up samples have rotated out
+    const Profiler& profiler = engine.getProfiler();
+    nlohmann::json stages = nlohmann::json::object();
+    for (size_t i = 0; i < static_cast<size_t>(Profiler::Stage::Count); ++i) {
+        Profiler::Stage stage = static_cast<Profiler::Stage>(i);
+        Profiler::Percentiles stats = profiler.getPercentiles(stage);
+        if (stats.samples == 0) continue;
+        stages[Profiler::getStageName(stage)] = {
+            {"gpu", Profiler::isGpuStage(stage)},
+            {"samples", stats.samples},
+            {"p50", stats.p50},
+            {"p95", stats.p95},
+            {"p99", stats.p99}
+        };
+    }
+
+    // Headless mode traces every pixel at full resolution, one ray each
+    const double rays = static_cast<double>(config.getInt("headless.width", 1920)) *
+                        config.getInt("headless.height", 1080) * frames;
+    result["seconds"] = seconds;
+    result["stages"] = stages;
+    result["framesPerSecond"] = seconds > 0.0 ? frames / seconds : 0.0;
+    result["raysPerSecond"] = seconds > 0.0 ? rays / seconds : 0.0;
+}
+
+}
+
+/**
+ * @brief Benchmark entry point
+ *
+ * Exits with a failure status if the scenes file cannot be read or any run
+ * failed; failed runs are still listed in the results with their error.
+ */
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        } else if (arg == "--config" && hasValue) {
+            options.configFile = argv[++i];
+        } else if (arg == "--scenes" && hasValue) {
+            options.scenesFile = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            options.outputFile = argv[++i];
+        } else if (arg == "--mode" && hasValue) {
+            options.mode = argv[++i];
+        } else if (arg == "--scene" && hasValue) {
+            options.scene = argv[++i];
+        } else if (arg == "--frames" && hasValue) {
+            options.frames = std::stoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << "\n";
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Results go to stdout, so only problems are logged
+    Logger::getInstance().setLevel(Logger::Level::WARNING);
+    Metrics::getInstance().setThreadName("main");
+
+    nlohmann::json scenes;
+    try {
+        std::ifstream file(options.scenesFile);
+        if (!file) {
+            std::cerr << "Cannot open scenes file: " << options.scenesFile << "\n";
+            return EXIT_FAILURE;
+        }
+        file >> scenes;
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid scenes file " << options.scenesFile << ": " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    Config base;
+    if (!base.loadFromFile(options.configFile)) {
+        Logger::getInstance().log(Logger::Level::WARNING, "Could not load config file, using defaults");
+    }
+    mergeJson(base, scenes.value("config", nlohmann::json::object()));
+
+    const int frames = options.frames > 0 ? options.frames : scenes.value("frames", 200);
+    const int warmup = std::max(0, scenes.value("warmupFrames", 20));
+    const double fps = std::max(1.0, scenes.value("fps", 30.0));
+
+    nlohmann::json report;
+    report["scenesFile"] = options.scenesFile;
+    report["frames"] = frames;
+    report["warmupFrames"] = warmup;
+    report["hardwareThreads"] = std::thread::hardware_concurrency();
+    nlohmann::json& results = report["results"];
+    results = nlohmann::json::array();
+
+    bool success = true;
+    for (const nlohmann::json& scene : scenes.value("scenes", nlohmann::json::array())) {
+        const std::string name = scene.value("name", "unnamed");
+        const std::string mode = scene.value("mode", "physics");
+        if (!options.scene.empty() && options.scene != name) continue;
+        if (options.mode != "all" && options.mode != mode) continue;
+
+        std::vector<int> bodyCounts = scene.value("bodyCounts", std::vector<int>{2});
+        std::vector<std::vector<int>> resolutions = mode == "render"
+            ? scene.value("resolutions", std::vector<std::vector<int>>{{1280, 720}})
+            : std::vector<std::vector<int>>{{0, 0}};
+        const std::string cameraPathFile = scene.value("cameraPath", "");
+
+        CameraPath path;
+        if (!cameraPathFile.empty() && !path.loadFromFile(cameraPathFile)) {
+            Logger::getInstance().log(Logger::Level::ERROR, "Scene " + name + ": cannot load " + cameraPathFile);
+            success = false;
+            continue;
+        }
+
+        for (int bodies : bodyCounts) {
+            for (const std::vector<int>& resolution : resolutions) {
+                nlohmann::json result;
+                std::string id = name + "/n" + std::to_string(bodies);
+                result["scene"] = name;
+                result["mode"] = mode;
+                result["bodies"] = bodies;
+                result["frames"] = frames;
+
+                try {
+                    Config config = base;
+                    mergeJson(config, scene.value("config", nlohmann::json::object()));
+                    config.setInt("initialConditions.count", bodies);
+                    result["threads"] = config.getInt("performance.threads", 0);
+                    result["forceSolver"] = config.getString("physics.forceSolver", "direct");
+                    result["integrationMethod"] = config.getString("physics.integrationMethod", "rk4");
+
+                    if (mode == "render") {
+                        if (resolution.size() != 2) {
+                            throw std::runtime_error("resolutions entries must be [width, height]");
+                        }
+                        id += "/" + std::to_string(resolution[0]) + "x" + std::to_string(resolution[1]);
+                        config.setBool("headless.enabled", true);
+                        config.setInt("headless.width", resolution[0]);
+                        config.setInt("headless.height", resolution[1]);
+                        config.setBool("profiler.enabled", true);
+                        config.setInt("profiler.window", frames);
+                        result["width"] = resolution[0];
+                        result["height"] = resolution[1];
+                        result["cameraPath"] = cameraPathFile;
+                        runRender(config, path, fps, warmup, frames, result);
+                    } else if (mode == "physics") {
+                        runPhysics(config, warmup, frames, result);
+                    } else {
+                        throw std::runtime_error("unknown mode " + mode);
+                    }
+                } catch (const std::exception& e) {
+                    Metrics::getInstance().stop();
+                    Logger::getInstance().log(Logger::Level::ERROR, "Benchmark " + id + " failed: " + e.what());
+                    result["error"] = e.what();
+                    success = false;
+                }
+
+                result["id"] = id;
+                results.push_back(result);
+                std::cerr << "bench: " << id << (result.contains("error") ? " failed" : " done") << "\n";
+            }
+        }
+    }
+
+    if (options.outputFile.empty()) {
+        std::cout << report.dump(2) << std::endl;
+    } else {
+        std::ofstream output(options.outputFile, std::ios::out | std::ios::trunc);
+        output << report.dump(2) << '\n';
+        if (!output) {
+            std::cerr << "Failed to write " << options.outputFile << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    Logger::getInstance().flush();
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
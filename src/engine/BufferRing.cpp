@@ -0,0 +1,126 @@
+/**
+ * @file BufferRing.cpp
+ * @brief Implementation of the fence-guarded buffer ring
+ */
+
+#include "BufferRing.h"
+#include <algorithm>
+#include <cstring>
+
+BufferRing::BufferRing(GLenum target, GLuint binding)
+    : m_target(target)
+    , m_binding(binding)
+    , m_buffer(0)
+    , m_mapped(nullptr)
+    , m_blockSize(0)
+    , m_regionStride(0)
+    , m_current(0)
+    , m_writing(0)
+    , m_fences{}
+    , m_shadowValid(false) {
+}
+
+BufferRing::~BufferRing() {
+    release();
+}
+
+void BufferRing::allocate(size_t blockSize) {
+    release();
+
+    // Bound ranges must start on the implementation's offset alignment
+    GLint alignment = 256;
+    glGetIntegerv(m_target == GL_UNIFORM_BUFFER ? GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+                                                : GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    const size_t align = static_cast<size_t>(std::max(1, alignment));
+
+    m_blockSize = blockSize;
+    m_regionStride = (blockSize + align - 1) / align * align;
+    const GLsizeiptr size = static_cast<GLsizeiptr>(m_regionStride * FRAMES);
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(m_target, m_buffer);
+    if (GLEW_ARB_buffer_storage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(m_target, size, nullptr, flags);
+        m_mapped = static_cast<char*>(glMapBufferRange(m_target, 0, size, flags));
+    } else {
+        glBufferData(m_target, size, nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    m_current = 0;
+    m_writing = 0;
+    m_shadow.assign(blockSize, 0);
+    m_shadowValid = false;
+    m_staging.clear();
+    bind();
+}
+
+bool BufferRing::update(const void* data, size_t size) {
+    size = std::min(size, m_blockSize);
+    if (m_shadowValid && std::memcmp(m_shadow.data(), data, size) == 0) {
+        return false;
+    }
+
+    std::memcpy(begin(), data, size);
+    commit(size);
+
+    std::memcpy(m_shadow.data(), data, size);
+    m_shadowValid = true;
+    return true;
+}
+
+void* BufferRing::begin() {
+    m_writing = (m_current + 1) % FRAMES;
+    waitForRegion(m_writing);
+    m_shadowValid = false;
+
+    if (m_mapped) {
+        return m_mapped + m_writing * m_regionStride;
+    }
+    m_staging.resize(m_blockSize);
+    return m_staging.data();
+}
+
+void BufferRing::commit(size_t size) {
+    if (!m_mapped && size > 0) {
+        glBindBuffer(m_target, m_buffer);
+        glBufferSubData(m_target, static_cast<GLintptr>(m_writing * m_regionStride),
+                        static_cast<GLsizeiptr>(std::min(size, m_blockSize)), m_staging.data());
+    }
+    m_current = m_writing;
+    bind();
+}
+
+void BufferRing::bind() const {
+    if (!m_buffer) return;
+    glBindBufferRange(m_target, m_binding, m_buffer, static_cast<GLintptr>(m_current * m_regionStride),
+                      static_cast<GLsizeiptr>(m_blockSize));
+}
+
+void BufferRing::fence() {
+    if (!m_buffer) return;
+    if (m_fences[m_current]) glDeleteSync(m_fences[m_current]);
+    m_fences[m_current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void BufferRing::waitForRegion(size_t region) {
+    if (!m_fences[region]) return;
+    glClientWaitSync(m_fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(m_fences[region]);
+    m_fences[region] = nullptr;
+}
+
+void BufferRing::release() {
+    for (size_t region = 0; region < FRAMES; ++region) {
+        waitForRegion(region);
+    }
+    if (m_buffer) {
+        if (m_mapped) {
+            glBindBuffer(m_target, m_buffer);
+            glUnmapBuffer(m_target);
+            m_mapped = nullptr;
+        }
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+}
@@ -0,0 +1,126 @@
+/**
+ * @file BufferRing.h
+ * @brief Persistently mapped, fence-guarded ring of buffer regions
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Streams one shader block through FRAMES regions of a single buffer
+ *
+ * Every write goes to the region after the one last bound, so the CPU never
+ * touches memory an in-flight frame may still read, and the GPU never waits
+ * for an upload. Each region carries the fence inserted after the last frame
+ * that read it (fence()); writing a region waits on that fence, which with
+ * three regions is normally long signalled. With ARB_buffer_storage the
+ * buffer is persistently and coherently mapped and written in place;
+ * otherwise regions are filled with glBufferSubData.
+ *
+ * update() keeps a copy of the last block and skips the write entirely when
+ * the bytes have not changed, so constant blocks are uploaded once and keep
+ * their binding. A block is written at most once per frame.
+ */
+class BufferRing {
+public:
+    static constexpr size_t FRAMES = 3;     ///< Regions in the ring (frames in flight + 1)
+
+    /**
+     * @brief Create an empty ring; allocate() creates the buffer
+     * @param target GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER
+     * @param binding Indexed binding point the current region is bound to
+     */
+    BufferRing(GLenum target, GLuint binding);
+
+    /**
+     * @brief Unmap and delete the buffer (requires the GL context)
+     */
+    ~BufferRing();
+
+    BufferRing(const BufferRing&) = delete;
+    BufferRing& operator=(const BufferRing&) = delete;
+
+    /**
+     * @brief (Re)create the buffer with room for a block of the given size in every region
+     *
+     * Waits for the GPU to release the old buffer first. The contents are lost.
+     * @param blockSize Bytes per region before alignment
+     */
+    void allocate(size_t blockSize);
+
+    /**
+     * @brief Write a whole block if it differs from the last one written, then bind it
+     * @param data Block contents
+     * @param size Bytes (at most the allocated block size)
+     * @return True if the block changed and was written
+     */
+    bool update(const void* data, size_t size);
+
+    /**
+     * @brief Get the next region for writing in place
+     *
+     * Waits until the GPU has released the region. With a persistent mapping
+     * the caller writes into the returned pointer; otherwise it gets a staging
+     * block that commit() uploads. Either way commit() must follow.
+     * @return Writable block of allocated size bytes
+     */
+    void* begin();
+
+    /**
+     * @brief Publish the region filled after begin() and bind it
+     * @param size Bytes written from the start of the block
+     */
+    void commit(size_t size);
+
+    /**
+     * @brief Bind the current region to the ring's binding point again
+     */
+    void bind() const;
+
+    /**
+     * @brief Mark the current region as read by the commands submitted so far
+     *
+     * Call once per frame after the last command that reads the block.
+     */
+    void fence();
+
+    /**
+     * @brief Get the allocated block size
+     * @return Bytes per region before alignment
+     */
+    size_t getBlockSize() const { return m_blockSize; }
+
+    /**
+     * @brief Check whether the buffer is persistently mapped
+     * @return True with ARB_buffer_storage
+     */
+    bool isPersistent() const { return m_mapped != nullptr; }
+
+private:
+    GLenum m_target;                        ///< Buffer target
+    GLuint m_binding;                       ///< Indexed binding point
+    GLuint m_buffer;                        ///< Buffer holding every region
+    char* m_mapped;                         ///< Persistent mapping (null without buffer storage)
+    size_t m_blockSize;                     ///< Bytes per block
+    size_t m_regionStride;                  ///< Bytes between regions (block rounded up to the offset alignment)
+    size_t m_current;                       ///< Region last written and bound
+    size_t m_writing;                       ///< Region handed out by begin()
+    GLsync m_fences[FRAMES];                ///< Last frame to read each region
+    std::vector<char> m_shadow;             ///< Last block passed to update()
+    bool m_shadowValid;                     ///< m_shadow holds the current region's contents
+    std::vector<char> m_staging;            ///< begin() block without a persistent mapping
+
+    /**
+     * @brief Wait for the GPU to finish reading a region and drop its fence
+     * @param region Region index
+     */
+    void waitForRegion(size_t region);
+
+    /**
+     * @brief Unmap and delete the buffer after the GPU is done with it
+     */
+    void release();
+};
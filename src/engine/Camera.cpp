@@ -18,7 +18,7 @@
 #endif
 
 Camera::Camera(const Config& config)
-    : m_target(0.0f, 0.0f, 0.0f)  // Always look at black hole center
+    : m_target(0.0f, 0.0f, 0.0f)  // Look at black hole center until a body is followed
     , m_radius(config.getFloat("camera.initialRadius", 6.34194e10f))
     , m_azimuth(0.0f)
     , m_elevation(M_PI / 2.0f)  // Start at equatorial plane
@@ -103,6 +103,19 @@ void Camera::setAspectRatio(float aspectRatio) {
         "Camera aspect ratio updated: " + std::to_string(aspectRatio));
 }
 
+void Camera::setOrbit(float radius, float azimuth, float elevation) {
+    m_targetRadius = radius;
+    m_targetAzimuth = azimuth;
+    m_targetElevation = elevation;
+    clampValues();
+    
+    // Snap to the target so scripted paths are reproduced exactly
+    m_radius = m_targetRadius;
+    m_azimuth = m_targetAzimuth;
+    m_elevation = m_targetElevation;
+    m_isMoving = false;
+}
+
 void Camera::processKeyboard(int key, int action, int mods) {
     if (action == GLFW_PRESS || action == GLFW_REPEAT) {
         const float moveSpeed = m_orbitSpeed * 2.0f;  // Faster for keyboard
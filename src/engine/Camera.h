@@ -69,12 +69,38 @@ public:
      */
     void setAspectRatio(float aspectRatio);
     
+    /**
+     * @brief Get vertical field of view
+     * @return Field of view in degrees
+     */
+    float getFov() const { return m_fov; }
+    
     /**
      * @brief Check if camera is currently moving (for optimization)
      * @return true if camera is moving
      */
     bool isMoving() const { return m_isMoving; }
     
+    /**
+     * @brief Place the camera on its orbit immediately, bypassing smoothing
+     * @param radius Distance from target
+     * @param azimuth Horizontal angle in radians
+     * @param elevation Vertical angle in radians (π/2 = equatorial plane)
+     */
+    void setOrbit(float radius, float azimuth, float elevation);
+    
+    /**
+     * @brief Move the point the camera orbits and looks at
+     * @param target Orbit center in world space (the black hole is at the origin)
+     */
+    void setTarget(const glm::vec3& target) { m_target = target; }
+    
+    /**
+     * @brief Get the point the camera orbits and looks at
+     * @return Orbit center in world space
+     */
+    const glm::vec3& getTarget() const { return m_target; }
+    
     // Input processing methods
     void processKeyboard(int key, int action, int mods);
     void processMouseButton(int button, int action, int mods);
@@ -83,7 +109,7 @@ public:
 
 private:
     // Camera parameters
-    glm::vec3 m_target;          ///< Point the camera looks at (black hole center)
+    glm::vec3 m_target;          ///< Point the camera looks at (black hole center or a followed body)
     float m_radius;              ///< Distance from target
     float m_azimuth;             ///< Horizontal rotation angle
     float m_elevation;           ///< Vertical rotation angle
@@ -0,0 +1,113 @@
+/**
+ * @file CameraPath.cpp
+ * @brief Implementation of scripted camera keyframes
+ */
+
+#include "CameraPath.h"
+#include "../utils/Logger.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr float DEGREES_TO_RADIANS = 3.14159265358979323846f / 180.0f;
+
+/**
+ * @brief Catmull-Rom tangent at a keyframe for non-uniform spacing
+ */
+template <typename Getter>
+float tangentAt(const std::vector<CameraPath::Keyframe>& keys, size_t k, Getter get) {
+    size_t prev = (k > 0) ? k - 1 : k;
+    size_t next = (k + 1 < keys.size()) ? k + 1 : k;
+    double span = keys[next].time - keys[prev].time;
+    if (span <= 0.0) return 0.0f;
+    return static_cast<float>((get(keys[next]) - get(keys[prev])) / span);
+}
+
+/**
+ * @brief Cubic Hermite interpolation of one channel between keyframes k and k + 1
+ */
+template <typename Getter>
+float hermite(const std::vector<CameraPath::Keyframe>& keys, size_t k, double u, double span, Getter get) {
+    double u2 = u * u;
+    double u3 = u2 * u;
+    double h00 = 2.0 * u3 - 3.0 * u2 + 1.0;
+    double h10 = u3 - 2.0 * u2 + u;
+    double h01 = -2.0 * u3 + 3.0 * u2;
+    double h11 = u3 - u2;
+
+    return static_cast<float>(h00 * get(keys[k]) + h10 * span * tangentAt(keys, k, get) +
+                              h01 * get(keys[k + 1]) + h11 * span * tangentAt(keys, k + 1, get));
+}
+
+}
+
+bool CameraPath::loadFromFile(const std::string& filename) {
+    try {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            Logger::getInstance().log(Logger::Level::ERROR,
+                "Could not open camera path: " + filename);
+            return false;
+        }
+
+        nlohmann::json json;
+        file >> json;
+
+        m_keyframes.clear();
+        for (const auto& item : json.value("keyframes", nlohmann::json::array())) {
+            Keyframe keyframe;
+            keyframe.time = item.value("time", 0.0);
+            keyframe.radius = item.value("radius", 6.34194e10f);
+            keyframe.azimuth = item.value("azimuth", 0.0f) * DEGREES_TO_RADIANS;
+            keyframe.elevation = item.value("elevation", 90.0f) * DEGREES_TO_RADIANS;
+            addKeyframe(keyframe);
+        }
+
+        Logger::getInstance().log(Logger::Level::INFO,
+            "Camera path loaded from " + filename + ": " + std::to_string(m_keyframes.size()) +
+            " keyframes, " + std::to_string(getDuration()) + "s");
+        return !m_keyframes.empty();
+
+    } catch (const std::exception& e) {
+        Logger::getInstance().log(Logger::Level::ERROR,
+            "Failed to parse camera path " + filename + ": " + std::string(e.what()));
+        return false;
+    }
+}
+
+void CameraPath::addKeyframe(const Keyframe& keyframe) {
+    auto position = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), keyframe.time,
+        [](double time, const Keyframe& other) { return time < other.time; });
+    m_keyframes.insert(position, keyframe);
+}
+
+CameraPath::Keyframe CameraPath::sample(double time) const {
+    if (m_keyframes.empty()) {
+        return Keyframe{time, 6.34194e10f, 0.0f, 1.5707963f};
+    }
+    if (time <= m_keyframes.front().time) return m_keyframes.front();
+    if (time >= m_keyframes.back().time) return m_keyframes.back();
+
+    // Segment containing time
+    size_t k = 0;
+    while (k + 2 < m_keyframes.size() && m_keyframes[k + 1].time <= time) ++k;
+
+    double span = m_keyframes[k + 1].time - m_keyframes[k].time;
+    double u = (span > 0.0) ? (time - m_keyframes[k].time) / span : 0.0;
+
+    Keyframe result;
+    result.time = time;
+    result.radius = hermite(m_keyframes, k, u, span, [](const Keyframe& key) { return key.radius; });
+    result.azimuth = hermite(m_keyframes, k, u, span, [](const Keyframe& key) { return key.azimuth; });
+    result.elevation = hermite(m_keyframes, k, u, span, [](const Keyframe& key) { return key.elevation; });
+    return result;
+}
+
+double CameraPath::getDuration() const {
+    return m_keyframes.empty() ? 0.0 : m_keyframes.back().time;
+}
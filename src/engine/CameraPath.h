@@ -0,0 +1,66 @@
+/**
+ * @file CameraPath.h
+ * @brief Scripted camera keyframes for offline rendering
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Time-parameterized orbit path for the camera
+ *
+ * Keyframes are loaded from a JSON file of the form
+ * { "keyframes": [ { "time": 0.0, "radius": 6.3e10, "azimuth": 0.0, "elevation": 90.0 }, ... ] }
+ * with angles in degrees. Azimuth is not wrapped, so 0 → 720 makes two full
+ * turns. Between keyframes each channel follows a Catmull-Rom (cubic Hermite)
+ * curve; outside the keyed range the end keyframes are held.
+ */
+class CameraPath {
+public:
+    /**
+     * @brief Camera orbit state at a point in time
+     */
+    struct Keyframe {
+        double time;        ///< Time in seconds
+        float radius;       ///< Distance from the black hole
+        float azimuth;      ///< Horizontal angle in radians
+        float elevation;    ///< Vertical angle in radians
+    };
+
+    /**
+     * @brief Load keyframes from a JSON file
+     * @param filename Path to the camera path file
+     * @return True if at least one keyframe was loaded
+     */
+    bool loadFromFile(const std::string& filename);
+
+    /**
+     * @brief Append a keyframe (kept sorted by time)
+     * @param keyframe Keyframe with angles in radians
+     */
+    void addKeyframe(const Keyframe& keyframe);
+
+    /**
+     * @brief Evaluate the path
+     * @param time Time in seconds
+     * @return Interpolated orbit state
+     */
+    Keyframe sample(double time) const;
+
+    /**
+     * @brief Get time of the last keyframe
+     * @return Duration in seconds (0 if empty)
+     */
+    double getDuration() const;
+
+    /**
+     * @brief Check whether any keyframes are loaded
+     * @return True if the path has no keyframes
+     */
+    bool empty() const { return m_keyframes.empty(); }
+
+private:
+    std::vector<Keyframe> m_keyframes;  ///< Keyframes sorted by time
+};
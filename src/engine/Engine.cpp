@@ -4,16 +4,31 @@
  */
 
 #include "Engine.h"
+#include "FrameCapture.h"
+#include "FrameEncoder.h"
 #include "../utils/Logger.h"
+#include "../utils/Metrics.h"
 #include <stdexcept>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <map>
+#include <algorithm>
+#include <cmath>
 #include <GLFW/glfw3.h>
 
+#ifdef BLACKHOLE_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
 Engine::Engine(const Config& config) 
     : m_window(nullptr)
+    , m_headless(config.getBool("headless.enabled", false))
+    , m_eglDisplay(nullptr)
+    , m_eglContext(nullptr)
+    , m_frameAlpha(-1.0f)
+    , m_followIndex(0)
     , m_config(config)
     , m_windowWidth(config.getInt("window.width", 1200))
     , m_windowHeight(config.getInt("window.height", 800))
@@ -21,7 +36,19 @@ Engine::Engine(const Config& config)
     , m_lastFrameTime(0.0)
     , m_frameCount(0) {
     
-    if (!initializeGLFW()) {
+    if (m_headless) {
+        // Ray trace directly at the output resolution; there is no interaction to adapt to
+        m_windowWidth = config.getInt("headless.width", 1920);
+        m_windowHeight = config.getInt("headless.height", 1080);
+        m_config.setIntArray("rendering.staticResolution", {m_windowWidth, m_windowHeight});
+        m_config.setBool("rendering.adaptiveQuality", false);
+        m_config.setBool("rendering.temporalAccumulation", false);
+        m_config.setBool("rendering.variableRate", false);
+        
+        if (!initializeEGL()) {
+            throw std::runtime_error("Failed to initialize EGL");
+        }
+    } else if (!initializeGLFW()) {
         throw std::runtime_error("Failed to initialize GLFW");
     }
     
@@ -30,21 +57,81 @@ Engine::Engine(const Config& config)
     }
     
     // Initialize subsystems
+    m_settings = Settings::fromConfig(m_config);
     m_camera = std::make_unique<Camera>(m_config);
     m_renderer = std::make_unique<Renderer>(m_config, m_windowWidth, m_windowHeight);
     m_physics = std::make_unique<Physics>(m_config);
+    m_simulation = std::make_unique<SimulationThread>(*m_physics);
+    m_profiler = std::make_unique<Profiler>(m_config);
+    m_renderer->setProfiler(m_profiler.get());
+    m_simulation->setProfiler(m_profiler.get());
+    
+    if (m_config.getString("physics.backend", "cpu") == "gpu") {
+        // Bodies move to the GPU once; the CPU physics only supplied the initial conditions
+        m_gpuPhysics = std::make_unique<GpuNBody>(m_config);
+        if (m_gpuPhysics->initialize(*m_physics, *m_renderer)) {
+            m_gpuPhysics->setProfiler(m_profiler.get());
+            m_renderer->setObjectsBuffer(m_gpuPhysics->getObjectsBuffer());
+        } else {
+            Logger::getInstance().log(Logger::Level::WARNING, "Falling back to the CPU physics backend");
+            m_gpuPhysics.reset();
+        }
+    }
     
-    setupCallbacks();
+    if (m_config.getInt("snapshot.interval", 0) > 0) {
+        if (m_gpuPhysics) {
+            // Bodies live in GPU buffers on that backend; Physics only holds the initial state
+            Logger::getInstance().log(Logger::Level::WARNING, 
+                "Snapshots are not supported with the GPU physics backend");
+        } else {
+            m_snapshotWriter = std::make_unique<SnapshotWriter>(m_config);
+            m_simulation->setSnapshotWriter(m_snapshotWriter.get());
+        }
+    }
+    
+    if (m_headless) {
+        if (!m_renderer->createOffscreenTarget()) {
+            throw std::runtime_error("Failed to create offscreen render target");
+        }
+        m_camera->setAspectRatio(static_cast<float>(m_windowWidth) / static_cast<float>(m_windowHeight));
+    } else {
+        setupCallbacks();
+        
+        // From here on only the simulation thread touches m_physics
+        if (!m_gpuPhysics) m_simulation->start();
+    }
     
     Logger::getInstance().log(Logger::Level::INFO, 
-        "Engine initialized: " + std::to_string(m_windowWidth) + "x" + std::to_string(m_windowHeight));
+        std::string(m_headless ? "Headless engine" : "Engine") + " initialized: " + 
+        std::to_string(m_windowWidth) + "x" + std::to_string(m_windowHeight));
 }
 
 Engine::~Engine() {
+    // Stop stepping before Physics goes away, and free GL objects while the context exists
+    m_simulation.reset();
+    m_snapshotWriter.reset();
+    m_gpuPhysics.reset();
+    m_renderer.reset();
+    m_profiler.reset();
+    
     if (m_window) {
         glfwDestroyWindow(m_window);
     }
-    glfwTerminate();
+    
+#ifdef BLACKHOLE_HAS_EGL
+    if (m_eglDisplay) {
+        EGLDisplay display = static_cast<EGLDisplay>(m_eglDisplay);
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (m_eglContext) {
+            eglDestroyContext(display, static_cast<EGLContext>(m_eglContext));
+        }
+        eglTerminate(display);
+    }
+#endif
+    
+    if (!m_headless) {
+        glfwTerminate();
+    }
     Logger::getInstance().log(Logger::Level::INFO, "Engine destroyed");
 }
 
@@ -53,10 +140,19 @@ bool Engine::isRunning() const {
 }
 
 void Engine::update(float deltaTime) {
-    glfwPollEvents();
+    m_frameStart = std::chrono::steady_clock::now();
+    {
+        Profiler::CpuScope timer(m_profiler.get(), Profiler::Stage::Events);
+        glfwPollEvents();
+    }
     
+    if (m_configWatcher && m_configWatcher->poll(m_config)) {
+        applyReloadedConfig();
+    }
+    
+    // Physics advances on its own thread at physics.timeStep (or in compute dispatches on the GPU backend)
+    if (m_gpuPhysics) m_gpuPhysics->advance(deltaTime);
     m_camera->update(deltaTime);
-    m_physics->update(deltaTime);
     
     // Update window title with performance info occasionally
     m_frameCount++;
@@ -68,9 +164,244 @@ void Engine::update(float deltaTime) {
     }
 }
 
+void Engine::watchConfig(const std::string& filename, const Config& overrides) {
+    m_configWatcher = std::make_unique<ConfigWatcher>(
+        filename, overrides, m_config.getDouble("debug.hotReloadInterval", 1.0));
+}
+
+void Engine::applyReloadedConfig() {
+    Settings settings = Settings::fromConfig(m_config);
+    uint32_t changes = settings.compare(m_settings);
+    if (changes == Settings::NONE) {
+        Logger::getInstance().log(Logger::Level::INFO, "Configuration reloaded, no hot-reloadable values changed");
+        return;
+    }
+    
+    Logger::getInstance().log(Logger::Level::INFO, 
+        "Configuration reloaded, changed: " + Settings::describe(changes));
+    if (changes & Settings::BLACK_HOLE) {
+        // The simulation owns the black hole; swapping it mid-run would invalidate the orbits
+        Logger::getInstance().log(Logger::Level::WARNING, 
+            "blackHole changes take effect on the next start");
+    }
+    
+    m_renderer->applySettings(settings, changes);
+    m_settings = settings;
+}
+
 void Engine::render() {
-    m_renderer->render(*m_camera, m_physics->getObjects());
+    if (m_gpuPhysics) {
+        m_renderer->render(*m_camera, m_gpuPhysics->getSnapshot());
+    } else {
+        interpolateFrameState(m_simulation->acquireSnapshot());
+        updateFollowTarget();
+        m_renderer->render(*m_camera, m_frameState);
+    }
+    if (m_profiler->isOverlayVisible()) {
+        m_renderer->renderOverlay(m_profiler->getOverlayLines());
+    }
     glfwSwapBuffers(m_window);
+    
+    auto frameEnd = std::chrono::steady_clock::now();
+    if (Metrics::isEnabled()) {
+        Metrics::getInstance().record(Metrics::Id::Frame, m_frameStart, frameEnd);
+    }
+    std::chrono::duration<double, std::milli> frameTime = frameEnd - m_frameStart;
+    m_profiler->recordCpu(Profiler::Stage::Frame, frameTime.count());
+    m_profiler->endFrame();
+}
+
+bool Engine::runHeadless() {
+    if (!m_headless) return false;
+    
+    const std::string cameraPathFile = m_config.getString("headless.cameraPath", "");
+    const double fps = std::max(1.0, m_config.getDouble("headless.fps", 30.0));
+    
+    CameraPath path;
+    if (!cameraPathFile.empty() && !path.loadFromFile(cameraPathFile)) {
+        return false;
+    }
+    
+    // Default to covering the whole path, or a single frame without one
+    int frames = m_config.getInt("headless.frames", 0);
+    if (frames <= 0) {
+        frames = path.empty() ? 1 : static_cast<int>(std::floor(path.getDuration() * fps)) + 1;
+    }
+    
+    // Whole physics steps per frame keep the output independent of render speed
+    const float timeStep = m_physics->getTimeStep();
+    const int stepsPerFrame = std::max(1, static_cast<int>(std::lround((1.0 / fps) / timeStep)));
+    
+    const int width = m_renderer->getWidth();
+    const int height = m_renderer->getHeight();
+    FrameCapture capture(width, height, 
+        static_cast<size_t>(std::max(1, m_config.getInt("headless.readbackBuffers", 3))));
+    FrameEncoder encoder(m_config);
+    if (!encoder.start(width, height)) {
+        return false;
+    }
+    
+    Logger::getInstance().log(Logger::Level::INFO, 
+        "Rendering " + std::to_string(frames) + " frames at " + std::to_string(fps) + " fps, " + 
+        std::to_string(stepsPerFrame) + " physics steps per frame");
+    
+    // Readback of frame N lands while the CPU steps physics and the GPU traces
+    // frame N + 1; the render thread only waits when every buffer is in flight
+    CapturedFrame ready;
+    bool ok = true;
+    for (int frame = 0; frame < frames && ok; ++frame) {
+        auto frameStart = std::chrono::steady_clock::now();
+        if (!path.empty()) {
+            CameraPath::Keyframe orbit = path.sample(frame / fps);
+            m_camera->setOrbit(orbit.radius, orbit.azimuth, orbit.elevation);
+        }
+        
+        // Frame 0 shows the initial conditions
+        if (m_gpuPhysics) {
+            m_gpuPhysics->step(frame > 0 ? stepsPerFrame : 0);
+            m_renderer->render(*m_camera, m_gpuPhysics->getSnapshot());
+        } else {
+            m_simulation->advance(frame > 0 ? stepsPerFrame : 0);
+            m_renderer->render(*m_camera, m_simulation->acquireSnapshot());
+        }
+        if (m_profiler->isOverlayVisible()) {
+            m_renderer->renderOverlay(m_profiler->getOverlayLines());
+        }
+        
+        if (capture.isFull() && capture.collect(ready, true)) {
+            ok = encoder.submit(ready);
+        }
+        capture.capture(m_renderer->getOutputFramebuffer(), frame);
+        while (ok && capture.collect(ready, false)) {
+            ok = encoder.submit(ready);
+        }
+        
+        if ((frame + 1) % 10 == 0 || frame + 1 == frames) {
+            Logger::getInstance().log(Logger::Level::INFO, 
+                "Rendered frame " + std::to_string(frame + 1) + "/" + std::to_string(frames));
+        }
+        
+        auto frameEnd = std::chrono::steady_clock::now();
+        if (Metrics::isEnabled()) {
+            Metrics::getInstance().record(Metrics::Id::Frame, frameStart, frameEnd);
+        }
+        std::chrono::duration<double, std::milli> frameTime = frameEnd - frameStart;
+        m_profiler->recordCpu(Profiler::Stage::Frame, frameTime.count());
+        m_profiler->endFrame();
+    }
+    
+    while (ok && capture.collect(ready, true)) {
+        ok = encoder.submit(ready);
+    }
+    
+    return encoder.finish() && ok;
+}
+
+bool Engine::runBenchmark(const CameraPath& path, double fps, int frames) {
+    if (!m_headless) return false;
+    
+    // Publish the initial conditions once; the scene stays frozen so only rendering is measured
+    if (!m_gpuPhysics) m_simulation->advance(0);
+    
+    for (int frame = 0; frame < frames; ++frame) {
+        auto frameStart = std::chrono::steady_clock::now();
+        if (!path.empty()) {
+            CameraPath::Keyframe orbit = path.sample(frame / fps);
+            m_camera->setOrbit(orbit.radius, orbit.azimuth, orbit.elevation);
+        }
+        
+        if (m_gpuPhysics) {
+            m_renderer->render(*m_camera, m_gpuPhysics->getSnapshot());
+        } else {
+            m_renderer->render(*m_camera, m_simulation->acquireSnapshot());
+        }
+        glFinish();
+        
+        auto frameEnd = std::chrono::steady_clock::now();
+        if (Metrics::isEnabled()) {
+            Metrics::getInstance().record(Metrics::Id::Frame, frameStart, frameEnd);
+        }
+        std::chrono::duration<double, std::milli> frameTime = frameEnd - frameStart;
+        m_profiler->recordCpu(Profiler::Stage::Frame, frameTime.count());
+        m_profiler->endFrame();
+    }
+    return true;
+}
+
+void Engine::interpolateFrameState(const SimulationSnapshot& snapshot) {
+    // The newest state is shown one step late, so alpha runs 0 → 1 until the next arrives
+    float alpha = 1.0f;
+    if (snapshot.timeStep > 0.0f) {
+        double elapsed = SimulationThread::now() - snapshot.wallTime;
+        alpha = static_cast<float>(std::clamp(elapsed / snapshot.timeStep, 0.0, 1.0));
+    }
+    
+    const size_t count = snapshot.size();
+    m_frameState.positions.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        m_frameState.positions[i] = glm::mix(snapshot.previousPositions[i], snapshot.positions[i], alpha);
+    }
+    
+    // Body attributes only change when a new step is published; the size check covers the first frame
+    if (m_frameState.step != snapshot.step || m_frameState.handles.size() != count) {
+        m_frameState.radii = snapshot.radii;
+        m_frameState.masses = snapshot.masses;
+        m_frameState.colors = snapshot.colors;
+        m_frameState.handles = snapshot.handles;
+        m_frameState.denseIndices = snapshot.denseIndices;
+        m_frameState.trails = snapshot.trails;
+    }
+    if (m_frameState.trailVersion != snapshot.trailVersion) {
+        m_frameState.trailSamples = snapshot.trailSamples;
+        m_frameState.trailVersion = snapshot.trailVersion;
+    }
+    m_frameState.trailLength = snapshot.trailLength;
+    m_frameState.blackHoleMass = snapshot.blackHoleMass;
+    m_frameState.simulationTime = snapshot.simulationTime - (1.0 - alpha) * snapshot.timeStep;
+    m_frameState.wallTime = snapshot.wallTime;
+    m_frameState.timeStep = snapshot.timeStep;
+    m_frameState.step = snapshot.step;
+    m_frameState.stateVersion = snapshot.stateVersion;
+    // Once alpha settles at 1 (a paused simulation) the interpolated positions stop changing
+    m_frameState.moving = snapshot.moving && alpha != m_frameAlpha;
+    m_frameAlpha = alpha;
+}
+
+void Engine::updateFollowTarget() {
+    if (!m_followTarget.isSet()) return;
+    
+    // Removals swap the last body into the freed index, so resolve the handle through its slot
+    const auto& handles = m_frameState.handles;
+    const auto& denseIndices = m_frameState.denseIndices;
+    const size_t index = m_followTarget.index < denseIndices.size()
+        ? denseIndices[m_followTarget.index] : BodyHandle::INVALID_INDEX;
+    if (index >= handles.size() || handles[index] != m_followTarget) {
+        Logger::getInstance().log(Logger::Level::INFO, 
+            "Followed body was removed, camera returns to the black hole");
+        m_followTarget = BodyHandle();
+        m_camera->setTarget(glm::vec3(0.0f));
+        return;
+    }
+    m_followIndex = index;
+    
+    m_camera->setTarget(m_frameState.positions[m_followIndex]);
+}
+
+void Engine::cycleFollowTarget() {
+    if (!m_camera) return;
+    
+    size_t next = m_followTarget.isSet() ? m_followIndex + 1 : 0;
+    if (next >= m_frameState.handles.size()) {
+        m_followTarget = BodyHandle();
+        m_camera->setTarget(glm::vec3(0.0f));
+        Logger::getInstance().log(Logger::Level::INFO, "Camera following the black hole");
+        return;
+    }
+    
+    m_followTarget = m_frameState.handles[next];
+    m_followIndex = next;
+    Logger::getInstance().log(Logger::Level::INFO, 
+        "Camera following body " + std::to_string(next + 1) + " of " + std::to_string(m_frameState.handles.size()));
 }
 
 bool Engine::initializeGLFW() {
@@ -107,9 +438,76 @@ bool Engine::initializeGLFW() {
     return true;
 }
 
+bool Engine::initializeEGL() {
+#ifdef BLACKHOLE_HAS_EGL
+    // A surfaceless display needs neither an X server nor a window system
+    EGLDisplay display = EGL_NO_DISPLAY;
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay) {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        Logger::getInstance().log(Logger::Level::ERROR, "Failed to initialize EGL display");
+        return false;
+    }
+    m_eglDisplay = display;
+    
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        Logger::getInstance().log(Logger::Level::ERROR, "EGL does not support desktop OpenGL");
+        return false;
+    }
+    
+    const EGLint configAttributes[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig eglConfig = nullptr;
+    EGLint configCount = 0;
+    eglChooseConfig(display, configAttributes, &eglConfig, 1, &configCount);
+    
+    // Same 4.3 core profile the windowed path requests
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, configCount > 0 ? eglConfig : EGL_NO_CONFIG_KHR,
+                                          EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT) {
+        Logger::getInstance().log(Logger::Level::ERROR, "Failed to create EGL OpenGL 4.3 context");
+        return false;
+    }
+    m_eglContext = context;
+    
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        Logger::getInstance().log(Logger::Level::ERROR, "Failed to make surfaceless EGL context current");
+        return false;
+    }
+    
+    Logger::getInstance().log(Logger::Level::INFO, 
+        "EGL " + std::to_string(major) + "." + std::to_string(minor) + " surfaceless context created");
+    return true;
+#else
+    Logger::getInstance().log(Logger::Level::ERROR, "Headless mode requires a build with EGL");
+    return false;
+#endif
+}
+
 bool Engine::initializeOpenGL() {
     glewExperimental = GL_TRUE;
     GLenum glewError = glewInit();
+    
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLX-built GLEW still loads the core entry points when there is no X display
+    if (m_headless && glewError == GLEW_ERROR_NO_GLX_DISPLAY) {
+        glewError = GLEW_OK;
+    }
+#endif
+    
     if (glewError != GLEW_OK) {
         Logger::getInstance().log(Logger::Level::ERROR, 
             "Failed to initialize GLEW: " + std::string((const char*)glewGetErrorString(glewError)));
@@ -155,12 +553,24 @@ void Engine::keyCallback(GLFWwindow* window, int key, int scancode, int action,
         glfwSetWindowShouldClose(window, GLFW_TRUE);
     }
     
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS && engine->m_profiler) {
+        engine->m_profiler->toggleOverlay();
+    }
+    
+    if (key == GLFW_KEY_T && action == GLFW_PRESS && engine->m_renderer) {
+        engine->m_renderer->toggleTrails();
+    }
+    
+    if (key == GLFW_KEY_F && action == GLFW_PRESS) {
+        engine->cycleFollowTarget();
+    }
+    
     if (engine->m_camera) {
         engine->m_camera->processKeyboard(key, action, mods);
     }
     
-    if (engine->m_physics) {
-        engine->m_physics->processKeyboard(key, action, mods);
+    if (engine->m_simulation) {
+        engine->m_simulation->postKeyEvent(key, action, mods);
     }
 }
 
@@ -10,6 +10,7 @@
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <string>
@@ -17,9 +18,16 @@
 #include <GLFW/glfw3.h>
 
 #include "Camera.h"
+#include "CameraPath.h"
+#include "GpuNBody.h"
+#include "Profiler.h"
 #include "Renderer.h"
+#include "SimulationThread.h"
+#include "SnapshotWriter.h"
 #include "../physics/Physics.h"
 #include "../utils/Config.h"
+#include "../utils/ConfigWatcher.h"
+#include "../utils/Settings.h"
 
 class Engine {
 public:
@@ -47,17 +55,77 @@ public:
     void update(float deltaTime);
     
     /**
-     * @brief Render the current frame
+     * @brief Check if the engine was created for offline rendering
+     * @return True in headless mode (no window, no event loop)
+     */
+    bool isHeadless() const { return m_headless; }
+    
+    /**
+     * @brief Produce the headless frame sequence and write it to disk
+     *
+     * Steps the simulation a whole number of fixed steps per frame, moves the
+     * camera along the scripted path and renders offscreen. Frames are read
+     * back asynchronously and written by a FrameEncoder thread. Never swaps
+     * buffers, so it is not throttled by vsync.
+     *
+     * @return True if every frame was written
+     */
+    bool runHeadless();
+    
+    /**
+     * @brief Render headless frames for the benchmark without stepping physics or reading them back
+     *
+     * Every frame ends with glFinish, so the profiler's frame stage is the
+     * full CPU and GPU cost of the frame rather than its submission time.
+     *
+     * @param path Camera keyframes (empty keeps the configured camera still)
+     * @param fps Frame rate the path is sampled at
+     * @param frames Number of frames to render
+     * @return False if the engine is not headless
+     */
+    bool runBenchmark(const CameraPath& path, double fps, int frames);
+    
+    /**
+     * @brief Get the per-stage frame timings
+     * @return Profiler fed by the renderer and the simulation
+     */
+    const Profiler& getProfiler() const { return *m_profiler; }
+    
+    /**
+     * @brief Render the current frame, interpolating between the last two physics steps
      */
     void render();
     
+    /**
+     * @brief Reload the configuration file whenever it is saved
+     *
+     * update() checks the file every debug.hotReloadInterval seconds and
+     * hands the renderer only the settings groups whose values changed.
+     * @param filename Configuration file the engine was created from
+     * @param overrides Command line values to keep on top of the file
+     */
+    void watchConfig(const std::string& filename, const Config& overrides);
+    
 private:
-    GLFWwindow* m_window;                               ///< GLFW window handle
+    GLFWwindow* m_window;                               ///< GLFW window handle (null in headless mode)
+    bool m_headless;                                    ///< Offscreen EGL rendering without a window
+    void* m_eglDisplay;                                 ///< EGLDisplay in headless mode
+    void* m_eglContext;                                 ///< EGLContext in headless mode
     std::unique_ptr<Camera> m_camera;                   ///< Camera system
     std::unique_ptr<Renderer> m_renderer;               ///< Rendering system
     std::unique_ptr<Physics> m_physics;                 ///< Physics simulation
+    std::unique_ptr<SimulationThread> m_simulation;     ///< Fixed-step thread that owns m_physics
+    std::unique_ptr<GpuNBody> m_gpuPhysics;             ///< GPU backend replacing m_simulation (null on CPU)
+    std::unique_ptr<Profiler> m_profiler;               ///< Per-stage frame timings
+    std::unique_ptr<SnapshotWriter> m_snapshotWriter;   ///< Periodic checkpoints (null when disabled)
+    SimulationSnapshot m_frameState;                    ///< Interpolated state being rendered
+    float m_frameAlpha;                                 ///< Interpolation factor of m_frameState
+    BodyHandle m_followTarget;                          ///< Body the camera follows (unset: black hole)
+    size_t m_followIndex;                               ///< Index the followed body was last found at
     
     Config m_config;                                    ///< Configuration settings
+    Settings m_settings;                                ///< Resolved from m_config at startup or last reload
+    std::unique_ptr<ConfigWatcher> m_configWatcher;     ///< Hot reload (null unless watchConfig() was called)
     
     // Window properties
     int m_windowWidth;
@@ -67,6 +135,7 @@ private:
     // Performance tracking
     double m_lastFrameTime;
     int m_frameCount;
+    std::chrono::steady_clock::time_point m_frameStart; ///< Start of the frame being profiled
     
     /**
      * @brief Initialize GLFW and create window
@@ -74,12 +143,39 @@ private:
      */
     bool initializeGLFW();
     
+    /**
+     * @brief Create a surfaceless EGL context for headless rendering
+     * @return true on success, false on failure
+     */
+    bool initializeEGL();
+    
     /**
      * @brief Initialize OpenGL context and GLEW
      * @return true on success, false on failure
      */
     bool initializeOpenGL();
     
+    /**
+     * @brief Pass the settings that changed in a reloaded configuration to the subsystems
+     */
+    void applyReloadedConfig();
+    
+    /**
+     * @brief Blend the latest snapshot with its predecessor for the current time
+     * @param snapshot Latest published simulation state
+     */
+    void interpolateFrameState(const SimulationSnapshot& snapshot);
+    
+    /**
+     * @brief Center the camera on the followed body, or on the black hole once it is gone
+     */
+    void updateFollowTarget();
+    
+    /**
+     * @brief Follow the next body in the frame state, wrapping back to the black hole
+     */
+    void cycleFollowTarget();
+    
     /**
      * @brief Set up input callbacks
      */
@@ -0,0 +1,96 @@
+/**
+ * @file FrameCapture.cpp
+ * @brief Implementation of asynchronous PBO readback
+ */
+
+#include "FrameCapture.h"
+#include "../utils/Logger.h"
+#include "../utils/Metrics.h"
+#include <cstring>
+#include <string>
+
+FrameCapture::FrameCapture(int width, int height, size_t ringSize)
+    : m_slots(ringSize > 0 ? ringSize : 1)
+    , m_oldest(0)
+    , m_pendingCount(0)
+    , m_width(width)
+    , m_height(height)
+    , m_frameSize(static_cast<size_t>(width) * height * 3) {
+
+    for (Slot& slot : m_slots) {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, m_frameSize, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    Logger::getInstance().log(Logger::Level::INFO,
+        "Frame capture ring: " + std::to_string(m_slots.size()) + " x " +
+        std::to_string(width) + "x" + std::to_string(height));
+}
+
+FrameCapture::~FrameCapture() {
+    for (Slot& slot : m_slots) {
+        if (slot.fence) glDeleteSync(slot.fence);
+        if (slot.buffer) glDeleteBuffers(1, &slot.buffer);
+    }
+}
+
+bool FrameCapture::capture(GLuint framebuffer, int64_t index) {
+    if (isFull()) return false;
+
+    Slot& slot = m_slots[(m_oldest + m_pendingCount) % m_slots.size()];
+    slot.index = index;
+
+    // With a pack buffer bound the read is queued on the GPU and returns at once
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ++m_pendingCount;
+
+    // Make sure the fence reaches the GPU so later polls can see it signal
+    glFlush();
+    return true;
+}
+
+bool FrameCapture::collect(CapturedFrame& frame, bool wait) {
+    if (m_pendingCount == 0) return false;
+
+    Slot& slot = m_slots[m_oldest];
+    GLuint64 timeout = wait ? GL_TIMEOUT_IGNORED : 0;
+    GLenum status = glClientWaitSync(slot.fence, 0, timeout);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        if (status == GL_WAIT_FAILED) {
+            Logger::getInstance().log(Logger::Level::ERROR, "Frame capture fence wait failed");
+        }
+        return false;
+    }
+
+    ScopedTimer timer(Metrics::Id::Readback);
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    frame.width = m_width;
+    frame.height = m_height;
+    frame.index = slot.index;
+    frame.pixels.resize(m_frameSize);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, m_frameSize, GL_MAP_READ_BIT);
+    if (mapped) {
+        std::memcpy(frame.pixels.data(), mapped, m_frameSize);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        Logger::getInstance().log(Logger::Level::ERROR,
+            "Failed to map frame capture buffer for frame " + std::to_string(slot.index));
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_oldest = (m_oldest + 1) % m_slots.size();
+    --m_pendingCount;
+    return mapped != nullptr;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file FrameCapture.h
+ * @brief Asynchronous framebuffer readback through a ring of pixel buffer objects
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A frame read back from the GPU
+ *
+ * Rows are stored bottom row first, exactly as OpenGL returns them; the
+ * encoder flips them while writing so the render thread never has to.
+ */
+struct CapturedFrame {
+    std::vector<unsigned char> pixels;  ///< Tightly packed RGB8 rows, bottom row first
+    int width = 0;                      ///< Width in pixels
+    int height = 0;                     ///< Height in pixels
+    int64_t index = 0;                  ///< Frame number in the sequence
+};
+
+/**
+ * @brief Overlaps framebuffer readback with rendering of the following frames
+ *
+ * capture() issues glReadPixels into the next pixel buffer object of the ring
+ * and fences it, which returns immediately because the copy is queued on the
+ * GPU behind the frame's work. collect() hands out frames whose fence has
+ * signaled, so the CPU maps a finished buffer instead of stalling the
+ * pipeline. Only when every buffer is in flight does the caller have to wait
+ * for the oldest one.
+ */
+class FrameCapture {
+public:
+    /**
+     * @brief Create the buffer ring
+     * @param width Frame width
+     * @param height Frame height
+     * @param ringSize Number of frames that may be in flight
+     */
+    FrameCapture(int width, int height, size_t ringSize = 3);
+
+    /**
+     * @brief Delete all buffers and fences (uncollected frames are dropped)
+     */
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /**
+     * @brief Queue readback of a framebuffer
+     * @param framebuffer Framebuffer to read (color attachment 0)
+     * @param index Frame number recorded with the pixels
+     * @return False if the ring is full; collect a frame first
+     */
+    bool capture(GLuint framebuffer, int64_t index);
+
+    /**
+     * @brief Take the oldest finished frame
+     * @param frame Output frame (its pixel storage is reused)
+     * @param wait Block until the oldest frame is ready instead of polling
+     * @return True if a frame was written to frame
+     */
+    bool collect(CapturedFrame& frame, bool wait);
+
+    /**
+     * @brief Check whether every buffer holds an uncollected frame
+     * @return True if capture() would fail
+     */
+    bool isFull() const { return m_pendingCount == m_slots.size(); }
+
+    /**
+     * @brief Get number of frames captured but not collected
+     * @return Pending frame count
+     */
+    size_t getPendingCount() const { return m_pendingCount; }
+
+private:
+    /**
+     * @brief One buffer of the ring
+     */
+    struct Slot {
+        GLuint buffer = 0;          ///< Pixel pack buffer
+        GLsync fence = nullptr;     ///< Signals when the readback has landed
+        int64_t index = 0;          ///< Frame number being read back
+    };
+
+    std::vector<Slot> m_slots;      ///< Buffer ring
+    size_t m_oldest;                ///< Slot holding the oldest pending frame
+    size_t m_pendingCount;          ///< Frames in flight
+    int m_width;                    ///< Frame width
+    int m_height;                   ///< Frame height
+    size_t m_frameSize;             ///< Bytes per frame
+};
@@ -0,0 +1,345 @@
+/**
+ * @file FrameEncoder.cpp
+ * @brief Implementation of the background frame encoder
+ */
+
+#include "FrameEncoder.h"
+#include "../utils/Logger.h"
+#include "../utils/Metrics.h"
+#include <algorithm>
+#include <array>
+#include <csignal>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+#ifdef BLACKHOLE_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+/**
+ * @brief CRC-32 (IEEE) as used by PNG chunks
+ */
+uint32_t crc32Update(uint32_t crc, const unsigned char* data, size_t length) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> result{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            result[n] = c;
+        }
+        return result;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void appendBigEndian(std::vector<unsigned char>& out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value >> 24));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+/**
+ * @brief Append a PNG chunk (length, type, data, CRC)
+ */
+void appendChunk(std::vector<unsigned char>& out, const char* type, const unsigned char* data, size_t length) {
+    appendBigEndian(out, static_cast<uint32_t>(length));
+    size_t typeOffset = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + length);
+    appendBigEndian(out, crc32Update(0, out.data() + typeOffset, length + 4));
+}
+
+#ifndef BLACKHOLE_HAS_ZLIB
+/**
+ * @brief Wrap data in a zlib stream of uncompressed deflate blocks
+ */
+void storeDeflate(const std::vector<unsigned char>& data, std::vector<unsigned char>& out) {
+    constexpr size_t MAX_BLOCK = 65535;
+
+    out.clear();
+    out.reserve(data.size() + data.size() / MAX_BLOCK * 5 + 11);
+    out.push_back(0x78);
+    out.push_back(0x01);
+
+    size_t offset = 0;
+    do {
+        size_t length = std::min(MAX_BLOCK, data.size() - offset);
+        bool last = offset + length == data.size();
+        out.push_back(last ? 1 : 0);
+        out.push_back(static_cast<unsigned char>(length));
+        out.push_back(static_cast<unsigned char>(length >> 8));
+        out.push_back(static_cast<unsigned char>(~length));
+        out.push_back(static_cast<unsigned char>(~length >> 8));
+        out.insert(out.end(), data.begin() + offset, data.begin() + offset + length);
+        offset += length;
+    } while (offset < data.size());
+
+    uint32_t a = 1, b = 0;
+    for (unsigned char byte : data) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(out, (b << 16) | a);
+}
+#endif
+
+}
+
+FrameEncoder::FrameEncoder(const Config& config)
+    : m_format(parseFormat(config.getString("headless.format", "png")))
+    , m_outputDirectory(config.getString("headless.outputDirectory", "frames"))
+    , m_videoFile(config.getString("headless.videoFile", ""))
+    , m_ffmpegArgs(config.getString("headless.ffmpegArgs", "-c:v libx264 -pix_fmt yuv420p -crf 18"))
+    , m_fps(std::max(1.0, config.getDouble("headless.fps", 30.0)))
+    , m_compressionLevel(std::clamp(config.getInt("headless.pngCompression", 1), 0, 9))
+    , m_queueCapacity(static_cast<size_t>(std::max(1, config.getInt("headless.encoderQueue", 4))))
+    , m_width(0)
+    , m_height(0)
+    , m_stopping(false)
+    , m_failed(false)
+    , m_pipe(nullptr) {
+
+    if (m_videoFile.empty()) {
+        m_videoFile = (std::filesystem::path(m_outputDirectory) / "render.mp4").string();
+    }
+}
+
+FrameEncoder::~FrameEncoder() {
+    finish();
+}
+
+FrameEncoder::Format FrameEncoder::parseFormat(const std::string& name) {
+    if (name == "ppm") return Format::PPM;
+    if (name == "ffmpeg") return Format::FFMPEG;
+    if (name != "png") {
+        Logger::getInstance().log(Logger::Level::WARNING,
+            "Unknown headless.format '" + name + "', writing PNG");
+    }
+    return Format::PNG;
+}
+
+bool FrameEncoder::start(int width, int height) {
+    m_width = width;
+    m_height = height;
+
+    std::error_code error;
+    std::filesystem::path directory = m_format == Format::FFMPEG
+        ? std::filesystem::path(m_videoFile).parent_path()
+        : std::filesystem::path(m_outputDirectory);
+    if (!directory.empty()) {
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            Logger::getInstance().log(Logger::Level::ERROR,
+                "Could not create output directory " + directory.string() + ": " + error.message());
+            return false;
+        }
+    }
+
+    if (m_format == Format::FFMPEG) {
+        // A dying ffmpeg must surface as a write error, not kill the renderer
+        std::signal(SIGPIPE, SIG_IGN);
+
+        std::string command = "ffmpeg -loglevel error -y -f rawvideo -pix_fmt rgb24 -s " +
+            std::to_string(width) + "x" + std::to_string(height) +
+            " -r " + std::to_string(m_fps) + " -i - " + m_ffmpegArgs + " \"" + m_videoFile + "\"";
+        m_pipe = popen(command.c_str(), "w");
+        if (!m_pipe) {
+            Logger::getInstance().log(Logger::Level::ERROR, "Could not start ffmpeg: " + command);
+            return false;
+        }
+        Logger::getInstance().log(Logger::Level::INFO, "Encoding video: " + command);
+    }
+
+    m_stopping = false;
+    m_failed = false;
+    m_thread = std::thread(&FrameEncoder::run, this);
+    return true;
+}
+
+bool FrameEncoder::submit(CapturedFrame& frame) {
+    if (m_failed) return false;
+
+    std::vector<unsigned char> recycled;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_slotFree.wait(lock, [this] { return m_queue.size() < m_queueCapacity || m_failed; });
+        if (m_failed) return false;
+
+        m_queue.push_back(std::move(frame));
+        if (!m_freeBuffers.empty()) {
+            recycled = std::move(m_freeBuffers.back());
+            m_freeBuffers.pop_back();
+        }
+    }
+    m_frameReady.notify_one();
+
+    frame.pixels = std::move(recycled);
+    return true;
+}
+
+bool FrameEncoder::finish() {
+    if (m_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_frameReady.notify_one();
+        m_thread.join();
+    }
+
+    if (m_pipe) {
+        int status = pclose(m_pipe);
+        m_pipe = nullptr;
+        if (status != 0) {
+            Logger::getInstance().log(Logger::Level::ERROR,
+                "ffmpeg exited with status " + std::to_string(status));
+            m_failed = true;
+        }
+    }
+
+    return !m_failed;
+}
+
+void FrameEncoder::run() {
+    Metrics::getInstance().setThreadName("encoder");
+    CapturedFrame frame;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!frame.pixels.empty()) {
+                m_freeBuffers.push_back(std::move(frame.pixels));
+            }
+            m_frameReady.wait(lock, [this] { return !m_queue.empty() || m_stopping; });
+            if (m_queue.empty()) return;
+
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        m_slotFree.notify_one();
+
+        if (!encode(frame)) {
+            m_failed = true;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.clear();
+            m_slotFree.notify_all();
+            return;
+        }
+    }
+}
+
+bool FrameEncoder::encode(const CapturedFrame& frame) {
+    if (frame.width != m_width || frame.height != m_height) {
+        Logger::getInstance().log(Logger::Level::ERROR,
+            "Frame " + std::to_string(frame.index) + " does not match the encoder size");
+        return false;
+    }
+
+    ScopedTimer timer(Metrics::Id::Encode);
+    switch (m_format) {
+        case Format::PNG:
+            return writePng(frame, framePath(frame.index, "png"));
+        case Format::PPM:
+            return writePpm(frame, framePath(frame.index, "ppm"));
+        case Format::FFMPEG:
+            return writeToPipe(frame);
+    }
+    return false;
+}
+
+bool FrameEncoder::writePng(const CapturedFrame& frame, const std::string& filename) {
+    const size_t rowSize = static_cast<size_t>(frame.width) * 3;
+
+    // Sub-filter each row (top row first) so the gradients of the disk deflate well
+    m_scratch.resize((rowSize + 1) * frame.height);
+    unsigned char* out = m_scratch.data();
+    for (int y = frame.height - 1; y >= 0; --y) {
+        const unsigned char* row = frame.pixels.data() + y * rowSize;
+        *out++ = 1;
+        for (size_t i = 0; i < 3 && i < rowSize; ++i) *out++ = row[i];
+        for (size_t i = 3; i < rowSize; ++i) *out++ = static_cast<unsigned char>(row[i] - row[i - 3]);
+    }
+
+#ifdef BLACKHOLE_HAS_ZLIB
+    uLongf compressedSize = compressBound(static_cast<uLong>(m_scratch.size()));
+    m_compressed.resize(compressedSize);
+    if (compress2(m_compressed.data(), &compressedSize, m_scratch.data(),
+                  static_cast<uLong>(m_scratch.size()), m_compressionLevel) != Z_OK) {
+        Logger::getInstance().log(Logger::Level::ERROR, "zlib compression failed for " + filename);
+        return false;
+    }
+    m_compressed.resize(compressedSize);
+#else
+    storeDeflate(m_scratch, m_compressed);
+#endif
+
+    unsigned char header[13];
+    for (int i = 0; i < 4; ++i) {
+        header[i] = static_cast<unsigned char>(static_cast<uint32_t>(frame.width) >> (24 - 8 * i));
+        header[4 + i] = static_cast<unsigned char>(static_cast<uint32_t>(frame.height) >> (24 - 8 * i));
+    }
+    header[8] = 8;      // Bit depth
+    header[9] = 2;      // Truecolor RGB
+    header[10] = 0;     // Deflate
+    header[11] = 0;     // Adaptive filtering
+    header[12] = 0;     // No interlace
+
+    static const unsigned char SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    m_scratch.assign(SIGNATURE, SIGNATURE + 8);
+    appendChunk(m_scratch, "IHDR", header, sizeof(header));
+    appendChunk(m_scratch, "IDAT", m_compressed.data(), m_compressed.size());
+    appendChunk(m_scratch, "IEND", nullptr, 0);
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        Logger::getInstance().log(Logger::Level::ERROR, "Could not write frame: " + filename);
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(m_scratch.data()), static_cast<std::streamsize>(m_scratch.size()));
+    return file.good();
+}
+
+bool FrameEncoder::writePpm(const CapturedFrame& frame, const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        Logger::getInstance().log(Logger::Level::ERROR, "Could not write frame: " + filename);
+        return false;
+    }
+
+    const size_t rowSize = static_cast<size_t>(frame.width) * 3;
+    file << "P6\n" << frame.width << " " << frame.height << "\n255\n";
+    for (int y = frame.height - 1; y >= 0; --y) {
+        file.write(reinterpret_cast<const char*>(frame.pixels.data() + y * rowSize),
+                   static_cast<std::streamsize>(rowSize));
+    }
+    return file.good();
+}
+
+bool FrameEncoder::writeToPipe(const CapturedFrame& frame) {
+    const size_t rowSize = static_cast<size_t>(frame.width) * 3;
+    for (int y = frame.height - 1; y >= 0; --y) {
+        if (std::fwrite(frame.pixels.data() + y * rowSize, 1, rowSize, m_pipe) != rowSize) {
+            Logger::getInstance().log(Logger::Level::ERROR,
+                "Failed to pipe frame " + std::to_string(frame.index) + " to ffmpeg");
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string FrameEncoder::framePath(int64_t index, const char* extension) const {
+    char filename[64];
+    std::snprintf(filename, sizeof(filename), "frame_%05lld.%s", static_cast<long long>(index), extension);
+    return (std::filesystem::path(m_outputDirectory) / filename).string();
+}
@@ -0,0 +1,159 @@
+/**
+ * @file FrameEncoder.h
+ * @brief Background thread that writes captured frames as images or video
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameCapture.h"
+#include "../utils/Config.h"
+
+/**
+ * @brief Encodes headless output off the render thread
+ *
+ * Frames are handed over with submit() and written in order by a dedicated
+ * thread, either as a numbered PNG or PPM sequence in headless.outputDirectory
+ * or as raw RGB piped into ffmpeg. The queue is bounded by
+ * headless.encoderQueue; when the encoder falls behind, submit() blocks rather
+ * than letting memory grow. Pixel buffers are recycled between the render and
+ * encoder threads, so steady-state encoding does not allocate.
+ */
+class FrameEncoder {
+public:
+    /**
+     * @brief Output container
+     */
+    enum class Format {
+        PNG,        ///< One PNG per frame
+        PPM,        ///< One binary PPM per frame (no compression)
+        FFMPEG      ///< Raw frames piped to an ffmpeg process
+    };
+
+    /**
+     * @brief Read encoder settings from the headless section
+     * @param config Configuration object
+     */
+    explicit FrameEncoder(const Config& config);
+
+    /**
+     * @brief Finish encoding if it is still running
+     */
+    ~FrameEncoder();
+
+    FrameEncoder(const FrameEncoder&) = delete;
+    FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+    /**
+     * @brief Prepare the output and start the encoder thread
+     * @param width Frame width
+     * @param height Frame height
+     * @return True if the output could be opened
+     */
+    bool start(int width, int height);
+
+    /**
+     * @brief Queue a frame for encoding, blocking while the queue is full
+     *
+     * The frame's pixels are moved into the queue and replaced with a
+     * recycled buffer, so the caller can keep reusing the same object.
+     *
+     * @param frame Frame to encode
+     * @return False if the encoder has failed and frames are being dropped
+     */
+    bool submit(CapturedFrame& frame);
+
+    /**
+     * @brief Encode all queued frames, stop the thread and close the output
+     * @return True if every submitted frame was written
+     */
+    bool finish();
+
+    /**
+     * @brief Get the configured output format
+     * @return Output format
+     */
+    Format getFormat() const { return m_format; }
+
+    /**
+     * @brief Parse a format name
+     * @param name "png", "ppm" or "ffmpeg"
+     * @return Matching format (PNG for unknown names)
+     */
+    static Format parseFormat(const std::string& name);
+
+private:
+    Format m_format;                                    ///< Output container
+    std::string m_outputDirectory;                      ///< Directory for image sequences
+    std::string m_videoFile;                            ///< ffmpeg output file
+    std::string m_ffmpegArgs;                           ///< ffmpeg encoder arguments
+    double m_fps;                                       ///< Frame rate passed to ffmpeg
+    int m_compressionLevel;                             ///< zlib level for PNG output
+    size_t m_queueCapacity;                             ///< Frames that may wait for encoding
+    int m_width;                                        ///< Frame width
+    int m_height;                                       ///< Frame height
+
+    std::thread m_thread;                               ///< Encoder thread
+    std::mutex m_mutex;                                 ///< Guards the queue and free list
+    std::condition_variable m_frameReady;               ///< Signals the encoder thread
+    std::condition_variable m_slotFree;                 ///< Signals a blocked submit()
+    std::deque<CapturedFrame> m_queue;                  ///< Frames waiting to be encoded
+    std::vector<std::vector<unsigned char>> m_freeBuffers; ///< Recycled pixel storage
+    bool m_stopping;                                    ///< No more frames will be submitted
+    std::atomic<bool> m_failed;                         ///< A write failed; later frames are dropped
+
+    FILE* m_pipe;                                       ///< ffmpeg stdin
+    std::vector<unsigned char> m_scratch;               ///< Filtered rows / encoded file bytes
+    std::vector<unsigned char> m_compressed;            ///< zlib stream for PNG output
+
+    /**
+     * @brief Encoder thread main loop
+     */
+    void run();
+
+    /**
+     * @brief Write one frame in the configured format
+     * @param frame Frame to write
+     * @return True on success
+     */
+    bool encode(const CapturedFrame& frame);
+
+    /**
+     * @brief Write a frame as a PNG image
+     * @param frame Frame to write
+     * @param filename Output path
+     * @return True on success
+     */
+    bool writePng(const CapturedFrame& frame, const std::string& filename);
+
+    /**
+     * @brief Write a frame as a binary PPM image
+     * @param frame Frame to write
+     * @param filename Output path
+     * @return True on success
+     */
+    bool writePpm(const CapturedFrame& frame, const std::string& filename);
+
+    /**
+     * @brief Write a frame's rows top row first to the ffmpeg pipe
+     * @param frame Frame to write
+     * @return True on success
+     */
+    bool writeToPipe(const CapturedFrame& frame);
+
+    /**
+     * @brief Build the output path of an image in the sequence
+     * @param index Frame number
+     * @param extension File extension without the dot
+     * @return Output path
+     */
+    std::string framePath(int64_t index, const char* extension) const;
+};
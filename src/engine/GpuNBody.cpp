@@ -0,0 +1,276 @@
+/**
+ * @file GpuNBody.cpp
+ * @brief Implementation of the GPU N-body backend
+ */
+
+#include "GpuNBody.h"
+#include "Renderer.h"
+#include "../utils/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+/// Bodies per work group; must match the tile size nbody.comp is built with
+constexpr GLuint TILE_SIZE = 256;
+
+/// Steps allowed per frame before the backlog is dropped (as on the simulation thread)
+constexpr int MAX_CATCH_UP_STEPS = 8;
+
+/// Storage buffer binding of the motion buffer (3 is the shared objects buffer)
+constexpr GLuint MOTION_BINDING = 8;
+
+/**
+ * @brief Object record shared with geodesic.comp (std430)
+ */
+struct GPUObject {
+    glm::vec4 posRadius;
+    glm::vec4 color;
+    float mass;
+    float _pad0, _pad1, _pad2;
+};
+static_assert(sizeof(GPUObject) == 48, "GPUObject must match the std430 layout in nbody.comp");
+
+/**
+ * @brief Velocity and acceleration record read only by nbody.comp (std430)
+ */
+struct GPUMotion {
+    glm::vec4 velocity;         ///< w = 1 while active
+    glm::vec4 acceleration;     ///< w = potential from the other bodies
+};
+static_assert(sizeof(GPUMotion) == 32, "GPUMotion must match the std430 layout in nbody.comp");
+
+/// Header (numObjects + padding) preceding the object array
+constexpr size_t OBJECTS_HEADER_SIZE = 16;
+
+}
+
+GpuNBody::GpuNBody(const Config& config)
+    : m_program(0)
+    , m_objectsBuffer(0)
+    , m_motionBuffer(0)
+    , m_readbackBuffer(0)
+    , m_readbackFence(nullptr)
+    , m_readbackStep(0)
+    , m_count(0)
+    , m_timeStep(0.016666f)
+    , m_accumulator(0.0)
+    , m_diagnosticsInterval(std::max(0, config.getInt("physics.gpuDiagnosticsInterval", 600)))
+    , m_initialEnergy(0.0)
+    , m_haveInitialEnergy(false)
+    , m_gravityConstant(static_cast<float>(config.getDouble("physics.gravityConstant", 6.67430e-11)))
+    , m_softeningSquared(config.getFloat("physics.softening", 0.0f) * config.getFloat("physics.softening", 0.0f))
+    , m_blackHole(0.0f)
+    , m_eventHorizon(0.0f)
+    , m_minDistance(0.0f)
+    , m_blackHoleMass(0.0)
+    , m_profiler(nullptr) {
+}
+
+GpuNBody::~GpuNBody() {
+    if (m_readbackFence) glDeleteSync(m_readbackFence);
+    if (m_readbackBuffer) glDeleteBuffers(1, &m_readbackBuffer);
+    if (m_motionBuffer) glDeleteBuffers(1, &m_motionBuffer);
+    if (m_objectsBuffer) glDeleteBuffers(1, &m_objectsBuffer);
+    if (m_program) glDeleteProgram(m_program);
+}
+
+bool GpuNBody::initialize(const Physics& physics, Renderer& renderer) {
+    try {
+        m_program = renderer.createComputeProgram("shaders/nbody.comp",
+                                                  "#define TILE_SIZE " + std::to_string(TILE_SIZE) + "\n");
+    } catch (const std::exception& e) {
+        Logger::getInstance().log(Logger::Level::WARNING, std::string("GPU n-body backend unavailable: ") + e.what());
+        return false;
+    }
+
+    const ParticleStore& particles = physics.getParticles();
+    const BlackHole& blackHole = physics.getBlackHole();
+    m_count = particles.size();
+    m_timeStep = physics.getTimeStep() > 0.0f ? physics.getTimeStep() : 0.016666f;
+    m_masses = particles.getMasses();
+    m_blackHoleMass = blackHole.getMass();
+
+    // Runtime gravity toggles stay on the CPU backend; the GPU one follows the config
+    if (!physics.isGravityEnabled()) m_gravityConstant = 0.0f;
+    m_blackHole = glm::vec4(blackHole.getPosition(),
+                            static_cast<float>(static_cast<double>(m_gravityConstant) * m_blackHoleMass));
+    m_eventHorizon = static_cast<float>(blackHole.getSchwarzschildRadius());
+    m_minDistance = 0.1f * m_eventHorizon;
+
+    // Objects in the geodesic.comp layout; velocities and accelerations beside them
+    std::vector<char> objects(OBJECTS_HEADER_SIZE + m_count * sizeof(GPUObject), 0);
+    int header[4] = { static_cast<int>(m_count), 0, 0, 0 };
+    std::memcpy(objects.data(), header, sizeof(header));
+    GPUObject* records = reinterpret_cast<GPUObject*>(objects.data() + OBJECTS_HEADER_SIZE);
+    std::vector<GPUMotion> motion(m_count);
+    for (size_t i = 0; i < m_count; ++i) {
+        const ParticleStore::ParticleInfo& info = particles.getInfo(i);
+        bool active = particles.getActiveFlags()[i] != 0;
+        records[i].posRadius = glm::vec4(particles.getPositions()[i], active ? particles.getRadii()[i] : 0.0f);
+        records[i].color = info.color;
+        records[i].mass = static_cast<float>(particles.getMasses()[i]);
+        motion[i].velocity = glm::vec4(particles.getVelocities()[i], active ? 1.0f : 0.0f);
+        motion[i].acceleration = glm::vec4(0.0f);
+    }
+
+    glGenBuffers(1, &m_objectsBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_objectsBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, objects.size(), objects.data(), GL_DYNAMIC_COPY);
+
+    // Never zero-sized, so the binding is valid with no bodies
+    glGenBuffers(1, &m_motionBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_motionBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(1, m_count) * sizeof(GPUMotion),
+                 motion.data(), GL_DYNAMIC_COPY);
+
+    glGenBuffers(1, &m_readbackBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_readbackBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, objects.size() + std::max<size_t>(1, m_count) * sizeof(GPUMotion),
+                 nullptr, GL_STREAM_READ);
+
+    // Leapfrog's first half kick needs a(x₀)
+    dispatch(1, 0.0f);
+    requestDiagnostics();
+
+    m_snapshot.blackHoleMass = m_blackHoleMass;
+    m_snapshot.timeStep = m_timeStep;
+
+    Logger::getInstance().log(Logger::Level::INFO,
+        "GPU n-body backend: " + std::to_string(m_count) + " bodies, leapfrog at " +
+        std::to_string(1.0f / m_timeStep) + " Hz, tile size " + std::to_string(TILE_SIZE));
+    return true;
+}
+
+void GpuNBody::advance(double deltaTime) {
+    m_accumulator += deltaTime;
+    int steps = static_cast<int>(m_accumulator / m_timeStep);
+    if (steps > MAX_CATCH_UP_STEPS) {
+        // Fell too far behind: drop the backlog rather than run ever more steps
+        steps = MAX_CATCH_UP_STEPS;
+        m_accumulator = 0.0;
+    } else {
+        m_accumulator -= steps * static_cast<double>(m_timeStep);
+    }
+    step(steps);
+}
+
+void GpuNBody::step(int steps) {
+    if (steps > 0 && m_count > 0) {
+        Profiler::GpuScope timer(m_profiler, Profiler::Stage::NBody);
+        const float halfStep = 0.5f * m_timeStep;
+        for (int s = 0; s < steps; ++s) {
+            dispatch(0, halfStep);
+            dispatch(1, halfStep);
+
+            ++m_snapshot.step;
+            ++m_snapshot.stateVersion;
+            if (m_diagnosticsInterval > 0 && m_snapshot.step % static_cast<uint64_t>(m_diagnosticsInterval) == 0) {
+                requestDiagnostics();
+            }
+        }
+    }
+    if (steps > 0) {
+        m_snapshot.simulationTime += steps * static_cast<double>(m_timeStep);
+    }
+
+    // The ray tracer reads the positions these dispatches wrote
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    pollDiagnostics();
+}
+
+void GpuNBody::dispatch(int stage, float kickStep) {
+    glUseProgram(m_program);
+    glUniform1i(glGetUniformLocation(m_program, "stage"), stage);
+    glUniform1f(glGetUniformLocation(m_program, "timeStep"), m_timeStep);
+    glUniform1f(glGetUniformLocation(m_program, "kickStep"), kickStep);
+    glUniform1f(glGetUniformLocation(m_program, "gravityConstant"), m_gravityConstant);
+    glUniform1f(glGetUniformLocation(m_program, "softeningSquared"), m_softeningSquared);
+    glUniform4fv(glGetUniformLocation(m_program, "blackHole"), 1, &m_blackHole[0]);
+    glUniform1f(glGetUniformLocation(m_program, "eventHorizon"), m_eventHorizon);
+    glUniform1f(glGetUniformLocation(m_program, "minDistance"), m_minDistance);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_objectsBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MOTION_BINDING, m_motionBuffer);
+
+    GLuint groups = static_cast<GLuint>((m_count + TILE_SIZE - 1) / TILE_SIZE);
+    if (groups > 0) glDispatchCompute(groups, 1, 1);
+
+    // The next stage reads what this one wrote
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void GpuNBody::requestDiagnostics() {
+    // One readback in flight at a time; skip this one if the last hasn't landed
+    if (m_readbackFence || m_count == 0) return;
+
+    const GLsizeiptr objectsSize = OBJECTS_HEADER_SIZE + m_count * sizeof(GPUObject);
+    const GLsizeiptr motionSize = m_count * sizeof(GPUMotion);
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_readbackBuffer);
+    glBindBuffer(GL_COPY_READ_BUFFER, m_objectsBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, objectsSize);
+    glBindBuffer(GL_COPY_READ_BUFFER, m_motionBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, objectsSize, motionSize);
+
+    m_readbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_readbackStep = m_snapshot.step;
+}
+
+void GpuNBody::pollDiagnostics() {
+    if (!m_readbackFence) return;
+
+    GLenum status = glClientWaitSync(m_readbackFence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return;
+    glDeleteSync(m_readbackFence);
+    m_readbackFence = nullptr;
+
+    const GLsizeiptr objectsSize = OBJECTS_HEADER_SIZE + m_count * sizeof(GPUObject);
+    const GLsizeiptr motionSize = m_count * sizeof(GPUMotion);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_readbackBuffer);
+    const char* base = static_cast<const char*>(
+        glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, objectsSize + motionSize, GL_MAP_READ_BIT));
+    if (!base) return;
+
+    const GPUObject* objects = reinterpret_cast<const GPUObject*>(base + OBJECTS_HEADER_SIZE);
+    const GPUMotion* motion = reinterpret_cast<const GPUMotion*>(base + objectsSize);
+
+    // Same terms as Physics::getTotalEnergy; the pair sum counts every pair twice
+    const double blackHoleGM = static_cast<double>(m_gravityConstant) * m_blackHoleMass;
+    double kinetic = 0.0;
+    double potential = 0.0;
+    size_t active = 0;
+    for (size_t i = 0; i < m_count; ++i) {
+        if (motion[i].velocity.w == 0.0f) continue;
+        ++active;
+
+        glm::dvec3 velocity(motion[i].velocity.x, motion[i].velocity.y, motion[i].velocity.z);
+        kinetic += 0.5 * m_masses[i] * glm::dot(velocity, velocity);
+        potential += 0.5 * m_masses[i] * static_cast<double>(motion[i].acceleration.w);
+
+        glm::dvec3 toHole(objects[i].posRadius.x - m_blackHole.x,
+                          objects[i].posRadius.y - m_blackHole.y,
+                          objects[i].posRadius.z - m_blackHole.z);
+        double distance = glm::length(toHole);
+        if (distance > 0.0) potential -= blackHoleGM * m_masses[i] / distance;
+    }
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+
+    double total = kinetic + potential;
+    if (!m_haveInitialEnergy) {
+        m_initialEnergy = total;
+        m_haveInitialEnergy = true;
+    }
+    double drift = m_initialEnergy != 0.0 ? (total - m_initialEnergy) / std::abs(m_initialEnergy) : 0.0;
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "GPU n-body step %llu: %zu active, energy %.6e J (drift %+.3e)",
+                  static_cast<unsigned long long>(m_readbackStep), active, total, drift);
+    Logger::getInstance().log(Logger::Level::INFO, line);
+}
@@ -0,0 +1,134 @@
+/**
+ * @file GpuNBody.h
+ * @brief GPU physics backend integrating bodies in the ray tracer's objects buffer
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Profiler.h"
+#include "SimulationSnapshot.h"
+#include "../physics/Physics.h"
+#include "../utils/Config.h"
+
+class Renderer;
+
+/**
+ * @brief Leapfrog N-body integration in compute shaders (physics.backend = "gpu")
+ *
+ * Takes the initial bodies from Physics and then owns them: positions, radii,
+ * colors and masses sit in a storage buffer with the exact layout of the
+ * Objects block in geodesic.comp, which the renderer binds instead of
+ * uploading snapshots, so a step never round-trips through the CPU. Velocities
+ * and accelerations live in a second buffer only nbody.comp reads.
+ *
+ * Mutual gravity is summed directly with shared-memory tiles (O(N²) on the
+ * GPU), plus the central black hole; bodies crossing the event horizon are
+ * deactivated in place. Collisions are not resolved on this backend.
+ *
+ * Every physics.gpuDiagnosticsInterval steps both buffers are copied into a
+ * readback buffer behind a fence; the copy is mapped only once the fence has
+ * signalled, so logging the total energy never stalls the pipeline.
+ */
+class GpuNBody {
+public:
+    /**
+     * @brief Read the backend settings
+     * @param config Configuration object (physics section)
+     */
+    explicit GpuNBody(const Config& config);
+
+    /**
+     * @brief Release GL objects (needs the context that created them)
+     */
+    ~GpuNBody();
+
+    /**
+     * @brief Compile nbody.comp and upload the bodies currently in Physics
+     * @param physics Source of the initial bodies, black hole and time step
+     * @param renderer Renderer used to build the compute program
+     * @return False if the program could not be built (use the CPU backend)
+     */
+    bool initialize(const Physics& physics, Renderer& renderer);
+
+    /**
+     * @brief Run whole steps for the wall time elapsed, like the simulation thread does
+     * @param deltaTime Seconds since the last call
+     */
+    void advance(double deltaTime);
+
+    /**
+     * @brief Run a fixed number of steps
+     * @param steps Steps of getTimeStep() seconds
+     */
+    void step(int steps);
+
+    /**
+     * @brief Get the buffer to bind at the objects binding instead of uploading snapshots
+     * @return Storage buffer in the geodesic.comp Objects layout
+     */
+    GLuint getObjectsBuffer() const { return m_objectsBuffer; }
+
+    /**
+     * @brief Get the scene state the renderer needs besides the bodies
+     * @return Snapshot with timing and black hole mass but no per-body arrays
+     */
+    const SimulationSnapshot& getSnapshot() const { return m_snapshot; }
+
+    /**
+     * @brief Attach a profiler to time the integration dispatches
+     * @param profiler Profiler to record into (null disables timing)
+     */
+    void setProfiler(Profiler* profiler) { m_profiler = profiler; }
+
+    GpuNBody(const GpuNBody&) = delete;
+    GpuNBody& operator=(const GpuNBody&) = delete;
+
+private:
+    GLuint m_program;               ///< nbody.comp
+    GLuint m_objectsBuffer;         ///< Shared with the ray tracer (binding 3)
+    GLuint m_motionBuffer;          ///< Velocities and accelerations (binding 8)
+    GLuint m_readbackBuffer;        ///< Copy of both buffers for the energy diagnostics
+    GLsync m_readbackFence;         ///< Signals when the copy has landed
+    uint64_t m_readbackStep;        ///< Step the pending copy was taken at
+
+    size_t m_count;                 ///< Bodies in the buffers
+    float m_timeStep;               ///< Fixed step length (s)
+    double m_accumulator;           ///< Wall time not yet stepped (s)
+    int m_diagnosticsInterval;      ///< Steps between energy readbacks (0 disables them)
+    double m_initialEnergy;         ///< First energy read back, for the drift figure
+    bool m_haveInitialEnergy;       ///< m_initialEnergy is set
+
+    // Values for the shader uniforms
+    float m_gravityConstant;        ///< G, or 0 with gravity disabled
+    float m_softeningSquared;       ///< Softening length squared (m²)
+    glm::vec4 m_blackHole;          ///< Position and G·M
+    float m_eventHorizon;           ///< Schwarzschild radius (m)
+    float m_minDistance;            ///< Black hole force cutoff (m)
+    double m_blackHoleMass;         ///< Black hole mass (kg), for the diagnostics
+    std::vector<double> m_masses;   ///< Body masses (kg), constant on this backend
+
+    SimulationSnapshot m_snapshot;  ///< Scene state for the renderer
+    Profiler* m_profiler;           ///< Optional stage timing
+
+    /**
+     * @brief Dispatch one pass of nbody.comp over every body
+     * @param stage 0 = kick and drift, 1 = forces and kick
+     * @param kickStep Kick length (s)
+     */
+    void dispatch(int stage, float kickStep);
+
+    /**
+     * @brief Copy the body buffers for a later energy readback
+     */
+    void requestDiagnostics();
+
+    /**
+     * @brief Log the energy of a finished readback without waiting for it
+     */
+    void pollDiagnostics();
+};
@@ -0,0 +1,112 @@
+/**
+ * @file OverlayFont.cpp
+ * @brief Glyph table and rasterizer of the overlay font
+ */
+
+#include "OverlayFont.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+
+namespace {
+
+/// Rows of each glyph from the top, bit 4 = leftmost column, for ASCII 32..95
+const uint8_t GLYPHS[64][OverlayFont::GLYPH_HEIGHT] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // ' '
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // !
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // "
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // #
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // $
+    {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03},  // %
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // &
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // '
+    {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02},  // (
+    {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08},  // )
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // *
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // +
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // ,
+    {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00},  // -
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C},  // .
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00},  // /
+    {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E},  // 0
+    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},  // 1
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F},  // 2
+    {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},  // 3
+    {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02},  // 4
+    {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},  // 5
+    {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E},  // 6
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},  // 7
+    {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E},  // 8
+    {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},  // 9
+    {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00},  // :
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // ;
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // <
+    {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00},  // =
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // >
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // ?
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // @
+    {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11},  // A
+    {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E},  // B
+    {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E},  // C
+    {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C},  // D
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F},  // E
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10},  // F
+    {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F},  // G
+    {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11},  // H
+    {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E},  // I
+    {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C},  // J
+    {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11},  // K
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F},  // L
+    {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11},  // M
+    {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11},  // N
+    {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},  // O
+    {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10},  // P
+    {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D},  // Q
+    {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11},  // R
+    {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E},  // S
+    {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04},  // T
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},  // U
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04},  // V
+    {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A},  // W
+    {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11},  // X
+    {0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04},  // Y
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F},  // Z
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // [
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // backslash
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // ]
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // ^
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F},  // _
+};
+
+}
+
+void OverlayFont::rasterize(const std::vector<std::string>& lines, std::vector<unsigned char>& pixels,
+                            int& width, int& height) {
+    size_t columns = 0;
+    for (const std::string& line : lines) {
+        columns = std::max(columns, line.size());
+    }
+
+    // One pixel of margin on every side
+    width = static_cast<int>(columns) * CELL_WIDTH + 1;
+    height = static_cast<int>(lines.size()) * CELL_HEIGHT + 1;
+    pixels.assign(static_cast<size_t>(width) * height, 0);
+
+    for (size_t row = 0; row < lines.size(); ++row) {
+        for (size_t column = 0; column < lines[row].size(); ++column) {
+            int code = std::toupper(static_cast<unsigned char>(lines[row][column]));
+            if (code < 32 || code > 95) continue;
+
+            const uint8_t* glyph = GLYPHS[code - 32];
+            int left = 1 + static_cast<int>(column) * CELL_WIDTH;
+            int top = 1 + static_cast<int>(row) * CELL_HEIGHT;
+            for (int y = 0; y < GLYPH_HEIGHT; ++y) {
+                unsigned char* out = &pixels[static_cast<size_t>(height - 1 - (top + y)) * width + left];
+                for (int x = 0; x < GLYPH_WIDTH; ++x) {
+                    if (glyph[y] & (0x10 >> x)) out[x] = 255;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * @file OverlayFont.h
+ * @brief Built-in bitmap font for the on-screen debug overlay
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Rasterizes text with a fixed 5x7 font, so the overlay needs no font files
+ *
+ * Covers ASCII space through underscore; lowercase letters are drawn as
+ * uppercase and anything else as a blank cell.
+ */
+class OverlayFont {
+public:
+    static constexpr int GLYPH_WIDTH = 5;   ///< Glyph width in pixels
+    static constexpr int GLYPH_HEIGHT = 7;  ///< Glyph height in pixels
+    static constexpr int CELL_WIDTH = 6;    ///< Horizontal advance in pixels
+    static constexpr int CELL_HEIGHT = 9;   ///< Line height in pixels
+
+    /**
+     * @brief Rasterize lines of text into an 8-bit coverage image
+     *
+     * Row 0 of the image is the bottom row, matching OpenGL texture layout.
+     *
+     * @param lines Text, one entry per line
+     * @param pixels Output coverage (0 or 255), width * height bytes
+     * @param width Output image width
+     * @param height Output image height
+     */
+    static void rasterize(const std::vector<std::string>& lines, std::vector<unsigned char>& pixels,
+                          int& width, int& height);
+};
@@ -0,0 +1,246 @@
+/**
+ * @file Profiler.cpp
+ * @brief Implementation of the frame profiler
+ */
+
+#include "Profiler.h"
+#include "../utils/Logger.h"
+#include "../utils/Metrics.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+/**
+ * @brief Nearest-rank percentile of sorted samples
+ */
+double percentile(const std::vector<float>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+}
+
+Profiler::CpuScope::CpuScope(Profiler* profiler, Stage stage)
+    : m_profiler(profiler && profiler->isEnabled() ? profiler : nullptr)
+    , m_stage(stage)
+    , m_traced(Metrics::isEnabled())
+    , m_start(m_profiler || m_traced ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point()) {
+}
+
+Profiler::CpuScope::~CpuScope() {
+    if (!m_profiler && !m_traced) return;
+    auto end = std::chrono::steady_clock::now();
+    if (m_traced) {
+        Metrics::getInstance().record(getMetricId(m_stage), m_start, end);
+    }
+    if (m_profiler) {
+        std::chrono::duration<double, std::milli> elapsed = end - m_start;
+        m_profiler->recordCpu(m_stage, elapsed.count());
+    }
+}
+
+Profiler::GpuScope::GpuScope(Profiler* profiler, Stage stage)
+    : m_profiler(profiler && profiler->isEnabled() ? profiler : nullptr)
+    , m_stage(stage) {
+    if (m_profiler) m_profiler->beginGpu(m_stage);
+}
+
+Profiler::GpuScope::~GpuScope() {
+    if (m_profiler) m_profiler->endGpu(m_stage);
+}
+
+Profiler::Profiler(const Config& config)
+    : m_enabled(config.getBool("profiler.enabled", true))
+    , m_overlayVisible(config.getBool("profiler.overlay", false))
+    , m_reportInterval(std::max(1, config.getInt("profiler.reportInterval", 60)))
+    , m_frame(0) {
+
+    if (!m_enabled) return;
+
+    size_t window = static_cast<size_t>(std::max(1, config.getInt("profiler.window", 240)));
+    for (SampleWindow& samples : m_windows) {
+        samples.samples.resize(window);
+    }
+    m_scratch.reserve(window);
+
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        if (isGpuStage(static_cast<Stage>(i))) {
+            glGenQueries(static_cast<GLsizei>(QUERY_RING_SIZE), m_queries[i].queries.data());
+        }
+    }
+
+    std::string output = config.getString("profiler.output", "");
+    if (!output.empty()) {
+        m_output.open(output, std::ios::out | std::ios::trunc);
+        if (!m_output) {
+            Logger::getInstance().log(Logger::Level::WARNING, "Could not open profiler output: " + output);
+        }
+    }
+}
+
+Profiler::~Profiler() {
+    for (QueryRing& ring : m_queries) {
+        if (ring.queries[0]) glDeleteQueries(static_cast<GLsizei>(QUERY_RING_SIZE), ring.queries.data());
+    }
+}
+
+void Profiler::beginGpu(Stage stage) {
+    if (!m_enabled) return;
+
+    // Every query still in flight: skip this sample rather than wait
+    QueryRing& ring = m_queries[static_cast<size_t>(stage)];
+    if (ring.pending == QUERY_RING_SIZE) return;
+
+    size_t slot = (ring.oldest + ring.pending) % QUERY_RING_SIZE;
+    glBeginQuery(GL_TIME_ELAPSED, ring.queries[slot]);
+    ring.active = true;
+}
+
+void Profiler::endGpu(Stage stage) {
+    QueryRing& ring = m_queries[static_cast<size_t>(stage)];
+    if (!ring.active) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    ring.active = false;
+    ++ring.pending;
+}
+
+void Profiler::recordCpu(Stage stage, double milliseconds) {
+    if (!m_enabled) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    addSample(stage, milliseconds);
+}
+
+void Profiler::endFrame() {
+    if (!m_enabled) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < STAGE_COUNT; ++i) {
+            // Results arrive in issue order; stop at the first one not ready yet
+            QueryRing& ring = m_queries[i];
+            while (ring.pending > 0) {
+                GLuint query = ring.queries[ring.oldest];
+                GLint available = 0;
+                glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (!available) break;
+
+                GLuint64 nanoseconds = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+                addSample(static_cast<Stage>(i), nanoseconds * 1e-6);
+
+                ring.oldest = (ring.oldest + 1) % QUERY_RING_SIZE;
+                --ring.pending;
+            }
+        }
+    }
+
+    ++m_frame;
+    if (m_output.is_open() && m_frame % static_cast<uint64_t>(m_reportInterval) == 0) {
+        writeReport();
+    }
+}
+
+Profiler::Percentiles Profiler::getPercentiles(Stage stage) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const SampleWindow& window = m_windows[static_cast<size_t>(stage)];
+    m_scratch.assign(window.samples.begin(), window.samples.begin() + window.count);
+    std::sort(m_scratch.begin(), m_scratch.end());
+
+    Percentiles result;
+    result.p50 = percentile(m_scratch, 0.50);
+    result.p95 = percentile(m_scratch, 0.95);
+    result.p99 = percentile(m_scratch, 0.99);
+    result.samples = window.count;
+    return result;
+}
+
+std::vector<std::string> Profiler::getOverlayLines() const {
+    std::vector<std::string> lines;
+    lines.reserve(STAGE_COUNT + 1);
+    lines.push_back("STAGE        P50    P95    P99 MS");
+
+    char line[64];
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        Stage stage = static_cast<Stage>(i);
+        Percentiles stats = getPercentiles(stage);
+
+        std::string name = getStageName(stage);
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) {
+            return static_cast<char>(std::toupper(c));
+        });
+        std::snprintf(line, sizeof(line), "%-3s %-7s %6.2f %6.2f %6.2f",
+                      isGpuStage(stage) ? "GPU" : "CPU", name.c_str(), stats.p50, stats.p95, stats.p99);
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+const char* Profiler::getStageName(Stage stage) {
+    switch (stage) {
+        case Stage::Events:  return "events";
+        case Stage::Physics: return "physics";
+        case Stage::Upload:  return "upload";
+        case Stage::Compute: return "compute";
+        case Stage::Quad:    return "quad";
+        case Stage::Grid:    return "grid";
+        case Stage::Trails:  return "trails";
+        case Stage::NBody:   return "nbody";
+        case Stage::Frame:   return "frame";
+        default:             return "unknown";
+    }
+}
+
+Metrics::Id Profiler::getMetricId(Stage stage) {
+    switch (stage) {
+        case Stage::Events:  return Metrics::Id::Events;
+        case Stage::Physics: return Metrics::Id::PhysicsStep;
+        case Stage::Upload:  return Metrics::Id::Upload;
+        case Stage::Compute: return Metrics::Id::Render;
+        case Stage::Quad:    return Metrics::Id::Render;
+        case Stage::Grid:    return Metrics::Id::Render;
+        case Stage::Trails:  return Metrics::Id::Render;
+        case Stage::NBody:   return Metrics::Id::PhysicsStep;
+        default:             return Metrics::Id::Frame;
+    }
+}
+
+bool Profiler::isGpuStage(Stage stage) {
+    return stage == Stage::Compute || stage == Stage::Quad || stage == Stage::Grid || stage == Stage::Trails ||
+           stage == Stage::NBody;
+}
+
+void Profiler::addSample(Stage stage, double milliseconds) {
+    SampleWindow& window = m_windows[static_cast<size_t>(stage)];
+    window.samples[window.next] = static_cast<float>(milliseconds);
+    window.next = (window.next + 1) % window.samples.size();
+    window.count = std::min(window.count + 1, window.samples.size());
+}
+
+void Profiler::writeReport() {
+    nlohmann::json report;
+    report["frame"] = m_frame;
+
+    nlohmann::json& stages = report["stages"];
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        Stage stage = static_cast<Stage>(i);
+        Percentiles stats = getPercentiles(stage);
+        stages[getStageName(stage)] = {
+            {"gpu", isGpuStage(stage)},
+            {"samples", stats.samples},
+            {"p50", stats.p50},
+            {"p95", stats.p95},
+            {"p99", stats.p99}
+        };
+    }
+
+    m_output << report.dump() << '\n';
+    m_output.flush();
+}
@@ -0,0 +1,251 @@
+/**
+ * @file Profiler.h
+ * @brief Per-stage GPU and CPU frame timings with rolling percentiles
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../utils/Config.h"
+#include "../utils/Metrics.h"
+
+/**
+ * @brief Attributes frame time to the stages that spend it
+ *
+ * GPU stages are measured with GL_TIME_ELAPSED queries. Each stage owns a
+ * small ring of query objects, and results are collected in endFrame() only
+ * once the GPU reports them available, so measuring never stalls the
+ * pipeline; a stage whose ring is full simply skips a sample. CPU stages are
+ * timed with steady_clock scopes and may be recorded from any thread (the
+ * physics stage runs on the simulation thread); CPU scopes also feed the
+ * Metrics trace when it is enabled.
+ *
+ * The last profiler.window samples of every stage are kept, and their
+ * p50/p95/p99 are available for the F3 overlay and, every
+ * profiler.reportInterval frames, appended as one JSON line to
+ * profiler.output.
+ */
+class Profiler {
+public:
+    /**
+     * @brief Measured stages
+     */
+    enum class Stage {
+        Events,     ///< CPU: window event polling
+        Physics,    ///< CPU: one physics step (simulation thread)
+        Upload,     ///< CPU: uniform and storage buffer uploads
+        Compute,    ///< GPU: ray tracing dispatches
+        Quad,       ///< GPU: fullscreen quad
+        Grid,       ///< GPU: spacetime grid
+        Trails,     ///< GPU: body trails
+        NBody,      ///< GPU: n-body integration (physics.backend = "gpu")
+        Frame,      ///< CPU: whole frame, update to swap
+        Count
+    };
+
+    /**
+     * @brief Rolling percentiles of one stage
+     */
+    struct Percentiles {
+        double p50 = 0.0;       ///< Median (ms)
+        double p95 = 0.0;       ///< 95th percentile (ms)
+        double p99 = 0.0;       ///< 99th percentile (ms)
+        size_t samples = 0;     ///< Samples in the window
+    };
+
+    /**
+     * @brief Times a CPU stage for the lifetime of the object
+     */
+    class CpuScope {
+    public:
+        /**
+         * @brief Start timing
+         * @param profiler Profiler to record into (null records nothing)
+         * @param stage Stage being timed
+         */
+        CpuScope(Profiler* profiler, Stage stage);
+
+        /**
+         * @brief Stop timing and record the sample
+         */
+        ~CpuScope();
+
+        CpuScope(const CpuScope&) = delete;
+        CpuScope& operator=(const CpuScope&) = delete;
+
+    private:
+        Profiler* m_profiler;                               ///< Target profiler
+        Stage m_stage;                                      ///< Stage being timed
+        bool m_traced;                                      ///< Also record a Metrics event
+        std::chrono::steady_clock::time_point m_start;      ///< Start of the scope
+    };
+
+    /**
+     * @brief Times a GPU stage for the lifetime of the object
+     */
+    class GpuScope {
+    public:
+        /**
+         * @brief Begin the stage's timer query
+         * @param profiler Profiler to record into (null records nothing)
+         * @param stage Stage being timed
+         */
+        GpuScope(Profiler* profiler, Stage stage);
+
+        /**
+         * @brief End the timer query
+         */
+        ~GpuScope();
+
+        GpuScope(const GpuScope&) = delete;
+        GpuScope& operator=(const GpuScope&) = delete;
+
+    private:
+        Profiler* m_profiler;                               ///< Target profiler
+        Stage m_stage;                                      ///< Stage being timed
+    };
+
+    /**
+     * @brief Create the query rings (requires a current OpenGL context)
+     * @param config Configuration object (profiler section)
+     */
+    explicit Profiler(const Config& config);
+
+    /**
+     * @brief Delete the query objects and close the output stream
+     */
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /**
+     * @brief Start a GPU stage (stages must not overlap)
+     * @param stage Stage to measure
+     */
+    void beginGpu(Stage stage);
+
+    /**
+     * @brief End the GPU stage started last
+     * @param stage Stage to measure
+     */
+    void endGpu(Stage stage);
+
+    /**
+     * @brief Record a CPU stage sample (thread-safe)
+     * @param stage Stage measured
+     * @param milliseconds Duration in milliseconds
+     */
+    void recordCpu(Stage stage, double milliseconds);
+
+    /**
+     * @brief Collect finished GPU queries and write the periodic report
+     */
+    void endFrame();
+
+    /**
+     * @brief Get the rolling percentiles of a stage
+     * @param stage Stage to query
+     * @return Percentiles over the sample window
+     */
+    Percentiles getPercentiles(Stage stage) const;
+
+    /**
+     * @brief Format the per-stage table shown by the overlay
+     * @return One line per stage plus a header
+     */
+    std::vector<std::string> getOverlayLines() const;
+
+    /**
+     * @brief Check whether profiling is enabled
+     * @return True if samples are being recorded
+     */
+    bool isEnabled() const { return m_enabled; }
+
+    /**
+     * @brief Check whether the overlay should be drawn
+     * @return True if the overlay is visible
+     */
+    bool isOverlayVisible() const { return m_enabled && m_overlayVisible; }
+
+    /**
+     * @brief Show or hide the overlay
+     */
+    void toggleOverlay() { m_overlayVisible = !m_overlayVisible; }
+
+    /**
+     * @brief Get the display name of a stage
+     * @param stage Stage
+     * @return Lowercase stage name
+     */
+    static const char* getStageName(Stage stage);
+
+    /**
+     * @brief Check whether a stage is measured on the GPU
+     * @param stage Stage
+     * @return True for GPU stages
+     */
+    static bool isGpuStage(Stage stage);
+
+    /**
+     * @brief Get the Metrics id a CPU stage is traced under
+     * @param stage Stage
+     * @return Matching Metrics id
+     */
+    static Metrics::Id getMetricId(Stage stage);
+
+private:
+    static constexpr size_t STAGE_COUNT = static_cast<size_t>(Stage::Count);
+    static constexpr size_t QUERY_RING_SIZE = 4;
+
+    /**
+     * @brief Timer queries of one GPU stage
+     */
+    struct QueryRing {
+        std::array<GLuint, QUERY_RING_SIZE> queries{};  ///< Query objects
+        size_t oldest = 0;                              ///< Oldest query awaiting its result
+        size_t pending = 0;                             ///< Queries issued but not collected
+        bool active = false;                            ///< A query of this ring is running
+    };
+
+    /**
+     * @brief Fixed-size window of recent samples
+     */
+    struct SampleWindow {
+        std::vector<float> samples;                     ///< Ring storage (ms)
+        size_t next = 0;                                ///< Slot written next
+        size_t count = 0;                               ///< Valid samples
+    };
+
+    bool m_enabled;                                     ///< Record samples
+    bool m_overlayVisible;                              ///< Overlay toggled on
+    int m_reportInterval;                               ///< Frames between JSON lines
+    uint64_t m_frame;                                   ///< Frames ended so far
+    std::ofstream m_output;                             ///< JSON lines stream (closed if unused)
+
+    std::array<QueryRing, STAGE_COUNT> m_queries;       ///< GPU stage queries
+    std::array<SampleWindow, STAGE_COUNT> m_windows;    ///< Per-stage samples
+    mutable std::mutex m_mutex;                         ///< Guards m_windows
+    mutable std::vector<float> m_scratch;               ///< Sorting buffer for percentiles
+
+    /**
+     * @brief Append a sample to a stage's window (caller holds m_mutex)
+     * @param stage Stage measured
+     * @param milliseconds Duration in milliseconds
+     */
+    void addSample(Stage stage, double milliseconds);
+
+    /**
+     * @brief Append the current percentiles as one JSON line
+     */
+    void writeReport();
+};
@@ -4,7 +4,9 @@
  */
 
 #include "Renderer.h"
+#include "OverlayFont.h"
 #include "../utils/Logger.h"
+#include "../utils/Metrics.h"
 #include "../physics/BlackHole.h"
 #include <fstream>
 #include <sstream>
@@ -12,31 +14,179 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
 #include <GLFW/glfw3.h>
 
+namespace {
+
+/**
+ * @brief Per-object record in the objects storage buffer (std430 layout)
+ */
+struct GPUObject {
+    glm::vec4 posRadius;    ///< xyz = position, w = radius
+    glm::vec4 color;        ///< RGBA color
+    float mass;             ///< Mass in kilograms
+    float _pad0, _pad1, _pad2;
+};
+static_assert(sizeof(GPUObject) == 48, "GPUObject must match the std430 layout in geodesic.comp");
+
+/// Size of the buffer header (numObjects + padding) preceding the object array
+constexpr size_t OBJECTS_HEADER_SIZE = 16;
+
+/// Initial object capacity of the storage buffer
+constexpr size_t INITIAL_OBJECT_CAPACITY = 64;
+
+/// std140 sizes of the Camera, AccretionDisk and Scene blocks in geodesic.comp
+constexpr size_t CAMERA_BLOCK_SIZE = 80;
+constexpr size_t DISK_BLOCK_SIZE = 16;
+constexpr size_t SCENE_BLOCK_SIZE = 64;
+
+/// Deflection table resolution: swept-angle samples, launch angles, observer radii
+constexpr int DEFLECTION_SWEEP_SAMPLES = 64;
+constexpr int DEFLECTION_ANGLE_SAMPLES = 256;
+constexpr int DEFLECTION_RADIUS_SAMPLES = 64;
+
+/// Observer radii covered by the deflection table, in Schwarzschild radii
+constexpr float DEFLECTION_MIN_RADIUS = 1.05f;
+constexpr float DEFLECTION_MAX_RADIUS = 1000.0f;
+
+/// Header of the ray queue buffer (count, next, indirect dispatch size, padding)
+constexpr size_t RAY_QUEUE_HEADER_SIZE = 8 * sizeof(GLuint);
+
+/// Byte offset of the indirect dispatch size in the ray queue buffer
+constexpr GLintptr RAY_QUEUE_DISPATCH_OFFSET = 2 * sizeof(GLuint);
+
+/// Jitter sequence length for progressive accumulation
+constexpr int JITTER_SEQUENCE_LENGTH = 64;
+
+/**
+ * @brief Radical inverse of index in the given base (Halton sequence)
+ */
+float halton(int index, int base) {
+    float result = 0.0f;
+    float fraction = 1.0f / base;
+    for (; index > 0; index /= base, fraction /= base) {
+        result += fraction * (index % base);
+    }
+    return result;
+}
+
+/**
+ * @brief Estimate the rays a variable-rate layout traces (mirrors pixelRate() in geodesic.comp)
+ * @param width Dispatch width
+ * @param height Dispatch height
+ * @param center Black hole position in pixels
+ * @param radius Full-rate radius in pixels
+ * @return Approximate traced pixel count
+ */
+double estimateTracedRays(int width, int height, const glm::vec2& center, float radius) {
+    double rays = 0.0;
+    for (int y = 0; y < height; y += 4) {
+        for (int x = 0; x < width; x += 4) {
+            float distance = glm::length(glm::vec2(x + 2.0f, y + 2.0f) - center);
+            rays += (distance < radius) ? 16.0 : (distance < 2.0f * radius ? 4.0 : 1.0);
+        }
+    }
+    return rays;
+}
+
+/// Schwarzschild radius per kilogram, 2G / c^2 (same constant as grid.vert)
+constexpr double SCHWARZSCHILD_PER_KG = 1.48523e-27;
+
+}
+
 Renderer::Renderer(const Config& config, int width, int height)
-    : m_config(config)
+    : m_settings(Settings::fromConfig(config))
+    , m_shaderCache(config)
     , m_width(width)
     , m_height(height)
     , m_quadShaderProgram(0)
     , m_gridShaderProgram(0)
-    , m_computeShaderProgram(0)
+    , m_trailShaderProgram(0)
+    , m_deflectionShaderProgram(0)
+    , m_accumulateShaderProgram(0)
+    , m_overlayShaderProgram(0)
     , m_quadVAO(0)
     , m_quadVBO(0)
     , m_gridVAO(0)
-    , m_gridVBO(0)
     , m_gridEBO(0)
+    , m_trailVAO(0)
+    , m_trailSampleSSBO(0)
+    , m_trailSSBO(0)
+    , m_trailSampleCapacity(0)
+    , m_trailCapacity(0)
+    , m_trailVersion(~uint64_t(0))
+    , m_overlayVAO(0)
+    , m_overlayTexture(0)
     , m_rayTracingTexture(0)
-    , m_cameraUBO(0)
-    , m_diskUBO(0)
-    , m_objectsUBO(0)
+    , m_deflectionTrajectory(0)
+    , m_deflectionOutcome(0)
+    , m_historyTextures{0, 0}
+    , m_historyIndex(0)
+    , m_cameraUBO(GL_UNIFORM_BUFFER, 1)
+    , m_sceneUBO(GL_UNIFORM_BUFFER, 4)
+    , m_diskUBO(GL_UNIFORM_BUFFER, 2)
+    , m_objectsSSBO(GL_SHADER_STORAGE_BUFFER, 3)
+    , m_objectsCapacity(0)
+    , m_objectsUploaded(false)
+    , m_objectsVersion(0)
+    , m_objectsCount(0)
+    , m_externalObjects(0)
+    , m_rayQueueSSBO(0)
+    , m_offscreenFBO(0)
+    , m_offscreenColor(0)
+    , m_offscreenDepth(0)
+    , m_profiler(nullptr)
     , m_showGrid(config.getBool("rendering.enableGrid", true))
+    , m_showTrails(config.getBool("trails.enabled", true))
     , m_adaptiveQuality(config.getBool("rendering.adaptiveQuality", true))
+    , m_useDeflectionTable(config.getBool("rendering.deflectionTable", true))
+    , m_tileScheduling(config.getBool("rendering.tileScheduling", true))
+    , m_variableRate(config.getBool("rendering.variableRate", true))
+    , m_rayBudget(std::max(1, config.getInt("rendering.rayBudget", 200000)))
+    , m_reconstructFBO(0)
+    , m_reconstructTexture(0)
+    , m_reconstructWidth(0)
+    , m_reconstructHeight(0)
+    , m_temporalAccumulation(config.getBool("rendering.temporalAccumulation", true))
+    , m_maxAccumulatedSamples(std::max(1, config.getInt("rendering.accumulationSamples", 64)))
+    , m_temporalBlend(std::clamp(config.getFloat("rendering.temporalBlend", 0.2f), 0.01f, 1.0f))
+    , m_accumulatedSamples(0)
+    , m_jitterIndex(0)
+    , m_historyValid(false)
+    , m_previousStateVersion(0)
+    , m_previousBlackHoleMass(0.0)
+    , m_previousObjectCount(0)
     , m_gridIndexCount(0)
-    , m_staticWidth(config.getInt("rendering.staticResolution[0]", 800))
-    , m_staticHeight(config.getInt("rendering.staticResolution[1]", 600))
-    , m_movingWidth(config.getInt("rendering.movingResolution[0]", 400))
-    , m_movingHeight(config.getInt("rendering.movingResolution[1]", 300)) {
+    , m_gridBuiltSize(0)
+    , m_computeWidth(0)
+    , m_computeHeight(0)
+    , m_blackHoleWell(0.0f)
+    , m_staticWidth(800)
+    , m_staticHeight(600)
+    , m_movingWidth(400)
+    , m_movingHeight(300) {
+    
+    // Resolutions are [width, height] arrays
+    std::vector<int> staticResolution = config.getIntArray("rendering.staticResolution", {800, 600});
+    if (staticResolution.size() >= 2) {
+        m_staticWidth = staticResolution[0];
+        m_staticHeight = staticResolution[1];
+    }
+    
+    std::vector<int> movingResolution = config.getIntArray("rendering.movingResolution", {400, 300});
+    if (movingResolution.size() >= 2) {
+        m_movingWidth = movingResolution[0];
+        m_movingHeight = movingResolution[1];
+    }
+    
+    // The central black hole is not in the objects buffer, so grid.vert gets its well separately
+    m_blackHoleWell = glm::vec4(m_settings.blackHole.position, 
+                                static_cast<float>(m_settings.blackHole.mass * SCHWARZSCHILD_PER_KG));
     
     initializeGL();
     Logger::getInstance().log(Logger::Level::INFO, "Renderer initialized");
@@ -46,35 +196,70 @@ Renderer::~Renderer() {
     // Clean up OpenGL resources
     if (m_quadShaderProgram) glDeleteProgram(m_quadShaderProgram);
     if (m_gridShaderProgram) glDeleteProgram(m_gridShaderProgram);
-    if (m_computeShaderProgram) glDeleteProgram(m_computeShaderProgram);
+    if (m_trailShaderProgram) glDeleteProgram(m_trailShaderProgram);
+    for (const auto& variant : m_geodesicVariants) {
+        for (GLuint program : {variant.second.direct, variant.second.classify, variant.second.persistent}) {
+            if (program) glDeleteProgram(program);
+        }
+    }
+    if (m_deflectionShaderProgram) glDeleteProgram(m_deflectionShaderProgram);
+    if (m_accumulateShaderProgram) glDeleteProgram(m_accumulateShaderProgram);
+    if (m_overlayShaderProgram) glDeleteProgram(m_overlayShaderProgram);
     
     if (m_quadVAO) glDeleteVertexArrays(1, &m_quadVAO);
     if (m_quadVBO) glDeleteBuffers(1, &m_quadVBO);
     if (m_gridVAO) glDeleteVertexArrays(1, &m_gridVAO);
-    if (m_gridVBO) glDeleteBuffers(1, &m_gridVBO);
+    if (m_trailVAO) glDeleteVertexArrays(1, &m_trailVAO);
+    if (m_trailSampleSSBO) glDeleteBuffers(1, &m_trailSampleSSBO);
+    if (m_trailSSBO) glDeleteBuffers(1, &m_trailSSBO);
     if (m_gridEBO) glDeleteBuffers(1, &m_gridEBO);
+    if (m_overlayVAO) glDeleteVertexArrays(1, &m_overlayVAO);
+    if (m_overlayTexture) glDeleteTextures(1, &m_overlayTexture);
     
     if (m_rayTracingTexture) glDeleteTextures(1, &m_rayTracingTexture);
+    if (m_deflectionTrajectory) glDeleteTextures(1, &m_deflectionTrajectory);
+    if (m_deflectionOutcome) glDeleteTextures(1, &m_deflectionOutcome);
+    if (m_historyTextures[0]) glDeleteTextures(2, m_historyTextures);
+    if (m_reconstructTexture) glDeleteTextures(1, &m_reconstructTexture);
+    if (m_reconstructFBO) glDeleteFramebuffers(1, &m_reconstructFBO);
     
-    if (m_cameraUBO) glDeleteBuffers(1, &m_cameraUBO);
-    if (m_diskUBO) glDeleteBuffers(1, &m_diskUBO);
-    if (m_objectsUBO) glDeleteBuffers(1, &m_objectsUBO);
+    if (m_offscreenFBO) glDeleteFramebuffers(1, &m_offscreenFBO);
+    if (m_offscreenColor) glDeleteTextures(1, &m_offscreenColor);
+    if (m_offscreenDepth) glDeleteRenderbuffers(1, &m_offscreenDepth);
+    
+    if (m_rayQueueSSBO) glDeleteBuffers(1, &m_rayQueueSSBO);
     
     Logger::getInstance().log(Logger::Level::INFO, "Renderer destroyed");
 }
 
-void Renderer::render(const Camera& camera, const std::vector<Object>& objects) {
-    // Clear the screen
+void Renderer::render(const Camera& camera, const SimulationSnapshot& objects) {
+    ScopedTimer timer(Metrics::Id::Render);
+    
+    // Clear the screen (or the offscreen target in headless mode)
+    glBindFramebuffer(GL_FRAMEBUFFER, m_offscreenFBO);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
     // Dispatch compute shader for ray tracing
-    dispatchCompute(camera, objects);
+    selectGeodesicProgram(objects.blackHoleMass);
+    GLuint image = m_rayTracingTexture;
+    {
+        Profiler::GpuScope timer(m_profiler, Profiler::Stage::Compute);
+        if (m_temporalAccumulation) {
+            image = traceAccumulated(camera, objects);
+        } else {
+            image = dispatchCompute(camera, objects, glm::vec2(0.0f), m_variableRate);
+        }
+    }
     
     // Render fullscreen quad with ray tracing result
-    renderFullscreenQuad();
+    {
+        Profiler::GpuScope timer(m_profiler, Profiler::Stage::Quad);
+        renderFullscreenQuad(image);
+    }
     
     // Render spacetime grid if enabled
     if (m_showGrid) {
+        Profiler::GpuScope timer(m_profiler, Profiler::Stage::Grid);
         glm::mat4 viewMatrix = camera.getViewMatrix();
         glm::mat4 projMatrix = camera.getProjectionMatrix();
         glm::mat4 viewProjMatrix = projMatrix * viewMatrix;
@@ -82,9 +267,64 @@ void Renderer::render(const Camera& camera, const std::vector<Object>& objects)
         renderGrid(viewProjMatrix);
     }
     
+    if (m_showTrails && !objects.trails.empty()) {
+        Profiler::GpuScope timer(m_profiler, Profiler::Stage::Trails);
+        renderTrails(camera.getProjectionMatrix() * camera.getViewMatrix(), objects);
+    }
+    
+    // Guard this frame's buffer regions until the compute pass, grid and trails have consumed them
+    m_cameraUBO.fence();
+    m_sceneUBO.fence();
+    m_diskUBO.fence();
+    if (!m_externalObjects) m_objectsSSBO.fence();
+    
     checkGLError("render frame");
 }
 
+void Renderer::renderOverlay(const std::vector<std::string>& lines) {
+    if (lines.empty()) return;
+    
+    int textWidth = 0, textHeight = 0;
+    OverlayFont::rasterize(lines, m_overlayPixels, textWidth, textHeight);
+    
+    if (!m_overlayTexture) {
+        glGenVertexArrays(1, &m_overlayVAO);
+        glGenTextures(1, &m_overlayTexture);
+        glBindTexture(GL_TEXTURE_2D, m_overlayTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_overlayTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, textWidth, textHeight, 0, GL_RED, GL_UNSIGNED_BYTE, 
+                 m_overlayPixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    
+    // Two screen pixels per font pixel, 8 pixels from the top-left corner
+    const float scale = 2.0f;
+    const float margin = 8.0f;
+    float left = -1.0f + 2.0f * margin / m_width;
+    float top = 1.0f - 2.0f * margin / m_height;
+    float right = left + 2.0f * scale * textWidth / m_width;
+    float bottom = top - 2.0f * scale * textHeight / m_height;
+    
+    glUseProgram(m_overlayShaderProgram);
+    glUniform4f(glGetUniformLocation(m_overlayShaderProgram, "rect"), left, bottom, right, top);
+    glUniform1i(glGetUniformLocation(m_overlayShaderProgram, "glyphs"), 0);
+    
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(m_overlayVAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glEnable(GL_DEPTH_TEST);
+    
+    checkGLError("render overlay");
+}
+
 void Renderer::resize(int width, int height) {
     m_width = width;
     m_height = height;
@@ -94,6 +334,38 @@ void Renderer::resize(int width, int height) {
         "Renderer resized: " + std::to_string(width) + "x" + std::to_string(height));
 }
 
+bool Renderer::createOffscreenTarget() {
+    if (m_offscreenFBO) glDeleteFramebuffers(1, &m_offscreenFBO);
+    if (m_offscreenColor) glDeleteTextures(1, &m_offscreenColor);
+    if (m_offscreenDepth) glDeleteRenderbuffers(1, &m_offscreenDepth);
+    
+    glGenTextures(1, &m_offscreenColor);
+    glBindTexture(GL_TEXTURE_2D, m_offscreenColor);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, m_width, m_height);
+    
+    glGenRenderbuffers(1, &m_offscreenDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_offscreenDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_width, m_height);
+    
+    glGenFramebuffers(1, &m_offscreenFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_offscreenFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_offscreenColor, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_offscreenDepth);
+    
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        Logger::getInstance().log(Logger::Level::ERROR, 
+            "Offscreen framebuffer incomplete: " + std::to_string(status));
+        return false;
+    }
+    
+    glViewport(0, 0, m_width, m_height);
+    
+    Logger::getInstance().log(Logger::Level::INFO, 
+        "Offscreen target created: " + std::to_string(m_width) + "x" + std::to_string(m_height));
+    return true;
+}
+
 void Renderer::initializeGL() {
     createShaders();
     initializeQuad();
@@ -111,17 +383,154 @@ void Renderer::initializeGL() {
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_staticWidth, m_staticHeight, 
                  0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     
+    if (m_useDeflectionTable) {
+        generateDeflectionTable();
+    }
+    
+    if (m_temporalAccumulation) {
+        // Accumulated history is kept at full quality resolution
+        glGenTextures(2, m_historyTextures);
+        for (GLuint texture : m_historyTextures) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA16F, m_staticWidth, m_staticHeight);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+    }
+    
     checkGLError("initialize GL");
 }
 
+GLuint Renderer::traceAccumulated(const Camera& camera, const SimulationSnapshot& objects) {
+    CameraBasis basis{camera.getPosition(), camera.getRight(), camera.getUp(), camera.getForward()};
+    
+    bool cameraChanged = !m_historyValid || camera.isMoving() ||
+                         basis.position != m_previousCamera.position ||
+                         basis.forward != m_previousCamera.forward ||
+                         basis.up != m_previousCamera.up;
+    bool sceneChanged = objects.moving || objects.stateVersion != m_previousStateVersion ||
+                        objects.blackHoleMass != m_previousBlackHoleMass ||
+                        objects.size() != m_previousObjectCount;
+    bool reproject = cameraChanged || sceneChanged;
+    
+    // A converged still image needs no GPU work at all
+    if (!reproject && m_accumulatedSamples >= m_maxAccumulatedSamples) {
+        return m_historyTextures[m_historyIndex];
+    }
+    
+    // Halton (2, 3) subpixel offsets antialias the accumulated image
+    int jitterSample = 1 + (m_jitterIndex++ % JITTER_SEQUENCE_LENGTH);
+    glm::vec2 jitter(halton(jitterSample, 2) - 0.5f, halton(jitterSample, 3) - 0.5f);
+    
+    // A still view converges at full rate; only changing views are traced sparsely
+    GLuint sample = dispatchCompute(camera, objects, jitter, m_variableRate && reproject);
+    
+    float blend;
+    if (reproject) {
+        // Changing views keep a short exponential history; a still view restarts averaging
+        blend = m_historyValid ? m_temporalBlend : 1.0f;
+        m_accumulatedSamples = 1;
+    } else {
+        ++m_accumulatedSamples;
+        blend = 1.0f / static_cast<float>(m_accumulatedSamples);
+    }
+    
+    resolveAccumulation(camera, basis, sample, reproject, blend);
+    
+    m_previousCamera = basis;
+    m_previousStateVersion = objects.stateVersion;
+    m_previousBlackHoleMass = objects.blackHoleMass;
+    m_previousObjectCount = objects.size();
+    m_historyValid = true;
+    return m_historyTextures[m_historyIndex];
+}
+
+void Renderer::resolveAccumulation(const Camera& camera, const CameraBasis& basis, GLuint sample, 
+                                   bool reproject, float blend) {
+    int target = 1 - m_historyIndex;
+    
+    glUseProgram(m_accumulateShaderProgram);
+    glUniform1i(glGetUniformLocation(m_accumulateShaderProgram, "reproject"), reproject ? 1 : 0);
+    glUniform1f(glGetUniformLocation(m_accumulateShaderProgram, "blend"), blend);
+    glUniform1f(glGetUniformLocation(m_accumulateShaderProgram, "tanHalfFov"), 
+                std::tan(glm::radians(camera.getFov() * 0.5f)));
+    glUniform1f(glGetUniformLocation(m_accumulateShaderProgram, "aspect"), 
+                static_cast<float>(m_width) / static_cast<float>(m_height));
+    glUniform3fv(glGetUniformLocation(m_accumulateShaderProgram, "camRight"), 1, &basis.right[0]);
+    glUniform3fv(glGetUniformLocation(m_accumulateShaderProgram, "camUp"), 1, &basis.up[0]);
+    glUniform3fv(glGetUniformLocation(m_accumulateShaderProgram, "camForward"), 1, &basis.forward[0]);
+    glUniform3fv(glGetUniformLocation(m_accumulateShaderProgram, "prevRight"), 1, &m_previousCamera.right[0]);
+    glUniform3fv(glGetUniformLocation(m_accumulateShaderProgram, "prevUp"), 1, &m_previousCamera.up[0]);
+    glUniform3fv(glGetUniformLocation(m_accumulateShaderProgram, "prevForward"), 1, &m_previousCamera.forward[0]);
+    
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, sample);
+    glActiveTexture(GL_TEXTURE5);
+    glBindTexture(GL_TEXTURE_2D, m_historyTextures[m_historyIndex]);
+    glActiveTexture(GL_TEXTURE0);
+    glBindImageTexture(1, m_historyTextures[target], 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    
+    glDispatchCompute((m_staticWidth + 15) / 16, (m_staticHeight + 15) / 16, 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    
+    m_historyIndex = target;
+    checkGLError("resolve accumulation");
+}
+
+void Renderer::generateDeflectionTable() {
+    // Trajectory samples u = rs / r, indexed by (swept angle, launch angle, observer radius)
+    glGenTextures(1, &m_deflectionTrajectory);
+    glBindTexture(GL_TEXTURE_3D, m_deflectionTrajectory);
+    glTexStorage3D(GL_TEXTURE_3D, 1, GL_R32F, 
+                   DEFLECTION_SWEEP_SAMPLES, DEFLECTION_ANGLE_SAMPLES, DEFLECTION_RADIUS_SAMPLES);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    
+    // Total sweep and escape/capture outcome per (launch angle, observer radius)
+    glGenTextures(1, &m_deflectionOutcome);
+    glBindTexture(GL_TEXTURE_2D, m_deflectionOutcome);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RG32F, DEFLECTION_ANGLE_SAMPLES, DEFLECTION_RADIUS_SAMPLES);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    
+    // Radii are in units of rs, so the table holds for any black hole mass
+    glUseProgram(m_deflectionShaderProgram);
+    glUniform2f(glGetUniformLocation(m_deflectionShaderProgram, "logRadiusRange"), 
+                std::log(DEFLECTION_MIN_RADIUS), std::log(DEFLECTION_MAX_RADIUS));
+    glBindImageTexture(0, m_deflectionTrajectory, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_R32F);
+    glBindImageTexture(1, m_deflectionOutcome, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG32F);
+    glDispatchCompute((DEFLECTION_ANGLE_SAMPLES + 63) / 64, DEFLECTION_RADIUS_SAMPLES, 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    
+    checkGLError("generate deflection table");
+    
+    Logger::getInstance().log(Logger::Level::INFO, 
+        "Deflection table generated: " + std::to_string(DEFLECTION_ANGLE_SAMPLES) + " angles x " + 
+        std::to_string(DEFLECTION_RADIUS_SAMPLES) + " radii x " + 
+        std::to_string(DEFLECTION_SWEEP_SAMPLES) + " samples");
+}
+
 void Renderer::createShaders() {
     try {
         // Create shader programs
         m_quadShaderProgram = createShaderProgram("shaders/vertex.vert", "shaders/fragment.frag");
         m_gridShaderProgram = createShaderProgram("shaders/grid.vert", "shaders/grid.frag");
-        m_computeShaderProgram = createComputeProgram("shaders/geodesic.comp");
+        m_trailShaderProgram = createShaderProgram("shaders/trail.vert", "shaders/trail.frag");
+        m_overlayShaderProgram = createShaderProgram("shaders/overlay.vert", "shaders/overlay.frag");
+        selectGeodesicProgram(m_settings.blackHole.mass);
+        m_deflectionShaderProgram = createComputeProgram("shaders/deflection.comp");
+        m_accumulateShaderProgram = createComputeProgram("shaders/accumulate.comp");
         
-        Logger::getInstance().log(Logger::Level::INFO, "All shaders compiled successfully");
+        Logger::getInstance().log(Logger::Level::INFO, "All shaders compiled successfully" + 
+            (m_shaderCache.isEnabled() ? " (" + std::to_string(m_shaderCache.getHits()) + " from the cache, " + 
+                                         std::to_string(m_shaderCache.getMisses()) + " compiled)" : std::string()));
         
     } catch (const std::exception& e) {
         Logger::getInstance().log(Logger::Level::ERROR, 
@@ -130,6 +539,49 @@ void Renderer::createShaders() {
     }
 }
 
+std::string Renderer::injectDefines(const std::string& source, const std::string& defines) {
+    if (defines.empty()) return source;
+    
+    // Defines must follow the #version line
+    size_t version = source.find("#version");
+    size_t lineEnd = (version == std::string::npos) ? std::string::npos : source.find('\n', version);
+    if (lineEnd == std::string::npos) return defines + source;
+    return source.substr(0, lineEnd + 1) + defines + source.substr(lineEnd + 1);
+}
+
+void Renderer::selectGeodesicProgram(double blackHoleMass) {
+    // Snapshots taken before the simulation publishes carry no mass; keep the current variant
+    if (blackHoleMass <= 0.0 && !m_geodesicVariants.empty()) return;
+    if (blackHoleMass <= 0.0) blackHoleMass = m_settings.blackHole.mass;
+    
+    char defines[96];
+    std::snprintf(defines, sizeof(defines), "#define SCHWARZSCHILD_RADIUS %.8e\n", 
+                  blackHoleMass * SCHWARZSCHILD_PER_KG);
+    
+    auto variant = m_geodesicVariants.find(defines);
+    if (variant == m_geodesicVariants.end()) {
+        GeodesicVariant programs;
+        if (m_tileScheduling) {
+            programs.classify = createComputeProgram("shaders/geodesic.comp", 
+                                                     std::string(defines) + "#define GEODESIC_CLASSIFY\n");
+            programs.persistent = createComputeProgram("shaders/geodesic.comp", 
+                                                       std::string(defines) + "#define GEODESIC_PERSISTENT\n");
+        } else {
+            programs.direct = createComputeProgram("shaders/geodesic.comp", defines);
+        }
+        variant = m_geodesicVariants.emplace(defines, programs).first;
+        
+        char radius[32];
+        std::snprintf(radius, sizeof(radius), "%.4e", blackHoleMass * SCHWARZSCHILD_PER_KG);
+        Logger::getInstance().log(Logger::Level::INFO, 
+            "Compiled geodesic variant " + std::to_string(m_geodesicVariants.size()) + 
+            " for Rs = " + radius + " m");
+    }
+    
+    m_geodesic = variant->second;
+    m_blackHoleWell.w = static_cast<float>(blackHoleMass * SCHWARZSCHILD_PER_KG);
+}
+
 std::string Renderer::loadShaderSource(const std::string& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
@@ -166,10 +618,16 @@ GLuint Renderer::createShaderProgram(const std::string& vertexPath, const std::s
     std::string vertexSource = loadShaderSource(vertexPath);
     std::string fragmentSource = loadShaderSource(fragmentPath);
     
+    uint64_t key = m_shaderCache.makeKey({vertexSource, fragmentSource});
+    if (GLuint cached = m_shaderCache.load(key)) {
+        return cached;
+    }
+    
     GLuint vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
     GLuint fragmentShader = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
     
     GLuint program = glCreateProgram();
+    m_shaderCache.prepare(program);
     glAttachShader(program, vertexShader);
     glAttachShader(program, fragmentShader);
     glLinkProgram(program);
@@ -191,14 +649,23 @@ GLuint Renderer::createShaderProgram(const std::string& vertexPath, const std::s
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
     
+    m_shaderCache.store(key, program);
     return program;
 }
 
-GLuint Renderer::createComputeProgram(const std::string& computePath) {
-    std::string computeSource = loadShaderSource(computePath);
+GLuint Renderer::createComputeProgram(const std::string& computePath, const std::string& defines) {
+    // Defines are part of the source, so every variant gets its own cache entry
+    std::string computeSource = injectDefines(loadShaderSource(computePath), defines);
+    
+    uint64_t key = m_shaderCache.makeKey({computeSource});
+    if (GLuint cached = m_shaderCache.load(key)) {
+        return cached;
+    }
+    
     GLuint computeShader = compileShader(computeSource, GL_COMPUTE_SHADER);
     
     GLuint program = glCreateProgram();
+    m_shaderCache.prepare(program);
     glAttachShader(program, computeShader);
     glLinkProgram(program);
     
@@ -216,6 +683,8 @@ GLuint Renderer::createComputeProgram(const std::string& computePath) {
     }
     
     glDeleteShader(computeShader);
+    
+    m_shaderCache.store(key, program);
     return program;
 }
 
@@ -259,54 +728,14 @@ void Renderer::initializeQuad() {
     glBindVertexArray(0);
 }
 
-void Renderer::generateGrid(const std::vector<Object>& objects) {
-    const int gridSize = m_config.getInt("rendering.gridSize", 25);
-    const float spacing = m_config.getFloat("rendering.gridSpacing", 1e10f);
-    
-    std::vector<glm::vec3> vertices;
+void Renderer::generateGrid(int gridSize) {
     std::vector<unsigned int> indices;
+    indices.reserve(static_cast<size_t>(gridSize) * (gridSize + 1) * 4);
     
-    // Generate grid vertices with spacetime curvature
+    // Generate grid line indices; vertex positions come from gl_VertexID in grid.vert
     for (int z = 0; z <= gridSize; ++z) {
         for (int x = 0; x <= gridSize; ++x) {
-            float worldX = (x - gridSize / 2) * spacing;
-            float worldZ = (z - gridSize / 2) * spacing;
-            float worldY = 0.0f;
-            
-            // Apply spacetime curvature from all massive objects
-            for (const auto& obj : objects) {
-                glm::vec3 objPos = obj.getPosition();
-                double mass = obj.getMass();
-                
-                if (mass > 0) {
-                    // Calculate Schwarzschild radius
-                    const double G = 6.67430e-11;
-                    const double c = 299792458.0;
-                    double rs = 2.0 * G * mass / (c * c);
-                    
-                    double dx = worldX - objPos.x;
-                    double dz = worldZ - objPos.z;
-                    double dist = std::sqrt(dx * dx + dz * dz);
-                    
-                    if (dist > rs) {
-                        // Gravitational potential creates spacetime curvature
-                        double curvature = 2.0 * std::sqrt(rs * (dist - rs));
-                        worldY += static_cast<float>(curvature) - 3e10f;
-                    } else {
-                        // Inside event horizon - extreme curvature
-                        worldY += 2.0f * static_cast<float>(std::sqrt(rs * rs)) - 3e10f;
-                    }
-                }
-            }
-            
-            vertices.emplace_back(worldX, worldY, worldZ);
-        }
-    }
-    
-    // Generate grid line indices
-    for (int z = 0; z < gridSize; ++z) {
-        for (int x = 0; x < gridSize; ++x) {
-            int i = z * (gridSize + 1) + x;
+            unsigned int i = z * (gridSize + 1) + x;
             
             // Horizontal lines
             if (x < gridSize) {
@@ -324,50 +753,59 @@ void Renderer::generateGrid(const std::vector<Object>& objects) {
     
     // Upload to GPU
     if (m_gridVAO == 0) glGenVertexArrays(1, &m_gridVAO);
-    if (m_gridVBO == 0) glGenBuffers(1, &m_gridVBO);
     if (m_gridEBO == 0) glGenBuffers(1, &m_gridEBO);
     
     glBindVertexArray(m_gridVAO);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, m_gridVBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_DYNAMIC_DRAW);
-    
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_gridEBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
     
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    m_gridIndexCount = indices.size();
+    m_gridIndexCount = static_cast<int>(indices.size());
+    m_gridBuiltSize = gridSize;
     
-    glBindVertexArray(0);
+    Logger::getInstance().log(Logger::Level::INFO, 
+        "Spacetime grid built: " + std::to_string(gridSize) + "x" + std::to_string(gridSize) + 
+        " cells, " + std::to_string(m_gridIndexCount) + " indices");
 }
 
 void Renderer::initializeUBOs() {
-    // Camera UBO
-    glGenBuffers(1, &m_cameraUBO);
-    glBindBuffer(GL_UNIFORM_BUFFER, m_cameraUBO);
-    glBufferData(GL_UNIFORM_BUFFER, 128, nullptr, GL_DYNAMIC_DRAW);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 1, m_cameraUBO);
-    
-    // Disk UBO
-    glGenBuffers(1, &m_diskUBO);
-    glBindBuffer(GL_UNIFORM_BUFFER, m_diskUBO);
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(float) * 4, nullptr, GL_DYNAMIC_DRAW);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 2, m_diskUBO);
-    
-    // Objects UBO
-    glGenBuffers(1, &m_objectsUBO);
-    glBindBuffer(GL_UNIFORM_BUFFER, m_objectsUBO);
-    GLsizeiptr objUBOSize = sizeof(int) + 3 * sizeof(float) +  // numObjects + padding
-                           16 * (sizeof(glm::vec4) + sizeof(glm::vec4) + sizeof(float));
-    glBufferData(GL_UNIFORM_BUFFER, objUBOSize, nullptr, GL_DYNAMIC_DRAW);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 3, m_objectsUBO);
+    // Camera, disk and scene (per-dispatch quality settings) blocks
+    m_cameraUBO.allocate(CAMERA_BLOCK_SIZE);
+    m_diskUBO.allocate(DISK_BLOCK_SIZE);
+    m_sceneUBO.allocate(SCENE_BLOCK_SIZE);
+    
+    // Objects SSBO
+    createObjectsBuffer(INITIAL_OBJECT_CAPACITY);
+    
+    // Ray queue SSBO, sized for every pixel of the larger resolution tier
+    if (m_tileScheduling) {
+        size_t maxPixels = static_cast<size_t>(std::max(m_staticWidth * m_staticHeight, 
+                                                        m_movingWidth * m_movingHeight));
+        glGenBuffers(1, &m_rayQueueSSBO);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_rayQueueSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, RAY_QUEUE_HEADER_SIZE + maxPixels * sizeof(GLuint), 
+                     nullptr, GL_DYNAMIC_COPY);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, m_rayQueueSSBO);
+    }
     
     checkGLError("initialize UBOs");
 }
 
-void Renderer::dispatchCompute(const Camera& camera, const std::vector<Object>& objects) {
+void Renderer::createObjectsBuffer(size_t capacity) {
+    // Waits for the GPU to release the old regions
+    m_objectsSSBO.allocate(OBJECTS_HEADER_SIZE + capacity * sizeof(GPUObject));
+    m_objectsCapacity = capacity;
+    m_objectsUploaded = false;
+    
+    Logger::getInstance().log(Logger::Level::DEBUG, 
+        "Objects buffer allocated for " + std::to_string(capacity) + " objects" + 
+        (m_objectsSSBO.isPersistent() ? " (persistently mapped)" : ""));
+    
+    checkGLError("create objects buffer");
+}
+
+GLuint Renderer::dispatchCompute(const Camera& camera, const SimulationSnapshot& objects, const glm::vec2& jitter, 
+                                 bool variableRate) {
     // Determine resolution based on camera movement
     int width, height;
     if (m_adaptiveQuality && camera.isMoving()) {
@@ -378,17 +816,37 @@ void Renderer::dispatchCompute(const Camera& camera, const std::vector<Object>&
         height = m_staticHeight;
     }
     
-    // Resize texture if needed
+    // Resize texture only when the resolution changes
     glBindTexture(GL_TEXTURE_2D, m_rayTracingTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    
-    // Use compute shader
-    glUseProgram(m_computeShaderProgram);
+    if (width != m_computeWidth || height != m_computeHeight) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        m_computeWidth = width;
+        m_computeHeight = height;
+    }
     
     // Upload uniform data
-    uploadCameraUBO(camera);
-    uploadDiskUBO();
-    uploadObjectsUBO(objects);
+    VariableRateLayout rate = variableRate ? planVariableRate(camera, width, height) : VariableRateLayout();
+    {
+        Profiler::CpuScope timer(m_profiler, Profiler::Stage::Upload);
+        uploadCameraUBO(camera);
+        uploadSceneUBO(width, height, m_adaptiveQuality && camera.isMoving(), jitter, rate);
+        uploadDiskUBO();
+        if (m_externalObjects) {
+            // Bodies are already on the GPU; the backend issued the storage barrier
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_externalObjects);
+        } else {
+            uploadObjectsSSBO(objects);
+        }
+    }
+    
+    // Far-field rays are shaded from the deflection table
+    if (m_useDeflectionTable) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_3D, m_deflectionTrajectory);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, m_deflectionOutcome);
+        glActiveTexture(GL_TEXTURE0);
+    }
     
     // Bind texture as image
     glBindImageTexture(0, m_rayTracingTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
@@ -396,12 +854,115 @@ void Renderer::dispatchCompute(const Camera& camera, const std::vector<Object>&
     // Dispatch compute shader
     GLuint groupsX = (width + 15) / 16;   // 16x16 work group size
     GLuint groupsY = (height + 15) / 16;
-    glDispatchCompute(groupsX, groupsY, 1);
+    if (m_tileScheduling) {
+        // Tiles resolve what the table can and queue the rest
+        const GLuint emptyQueue[RAY_QUEUE_HEADER_SIZE / sizeof(GLuint)] = {0, 0, 0, 1, 1, 0, 0, 0};
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_rayQueueSSBO);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(emptyQueue), emptyQueue);
+        
+        glUseProgram(m_geodesic.classify);
+        glDispatchCompute(groupsX, groupsY, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+        
+        // Persistent threads drain the queue, refilling as their rays finish;
+        // the classification pass sized this dispatch
+        glUseProgram(m_geodesic.persistent);
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, m_rayQueueSSBO);
+        glDispatchComputeIndirect(RAY_QUEUE_DISPATCH_OFFSET);
+    } else {
+        glUseProgram(m_geodesic.direct);
+        glDispatchCompute(groupsX, groupsY, 1);
+    }
     
-    // Memory barrier
-    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    // Memory barrier (the image is sampled next, by accumulation or the quad)
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
     
     checkGLError("dispatch compute");
+    return rate.enabled ? reconstructVariableRate(width, height) : m_rayTracingTexture;
+}
+
+Renderer::VariableRateLayout Renderer::planVariableRate(const Camera& camera, int width, int height) const {
+    VariableRateLayout layout;
+    
+    // geodesic.comp places the black hole at the origin
+    glm::vec3 position = camera.getPosition();
+    glm::vec3 toHole = -position;
+    float depth = glm::dot(toHole, camera.getForward());
+    float distance = glm::length(position);
+    float rs = m_blackHoleWell.w;
+    if (depth <= 0.0f || distance <= rs) return layout;
+    
+    // Angular size of the shadow (critical impact parameter 3√3/2 rs) and of the disk
+    float ratio = rs / distance;
+    float shadowAngle = std::asin(std::min(1.0f, 2.598076f * ratio * std::sqrt(1.0f - ratio)));
+    float diskRatio = m_settings.disk.outerRadius / distance;
+    if (diskRatio >= 1.0f) return layout;
+    float interestAngle = 1.1f * std::max(2.0f * shadowAngle, std::asin(diskRatio));
+    if (interestAngle >= glm::radians(80.0f)) return layout;
+    
+    // Project the black hole into dispatch pixels (same mapping as pixelRayDirection())
+    float tanHalfFov = std::tan(glm::radians(camera.getFov() * 0.5f));
+    float aspect = static_cast<float>(m_width) / static_cast<float>(m_height);
+    float u = glm::dot(toHole, camera.getRight()) / depth / (aspect * tanHalfFov);
+    float v = glm::dot(toHole, camera.getUp()) / depth / tanHalfFov;
+    layout.center = glm::vec2(0.5f * (u + 1.0f) * width, 0.5f * (1.0f + v) * height);
+    
+    // Shrink the full-rate region until the estimate fits the budget
+    float radius = std::tan(interestAngle) / tanHalfFov * 0.5f * height;
+    if (estimateTracedRays(width, height, layout.center, radius) > m_rayBudget) {
+        float low = 0.0f;
+        float high = radius;
+        for (int i = 0; i < 12; ++i) {
+            float mid = 0.5f * (low + high);
+            if (estimateTracedRays(width, height, layout.center, mid) > m_rayBudget) {
+                high = mid;
+            } else {
+                low = mid;
+            }
+        }
+        radius = low;
+    }
+    
+    // Nothing to gain when the full-rate region covers every pixel
+    if (estimateTracedRays(width, height, layout.center, radius) >= 0.95 * width * height) return layout;
+    
+    layout.enabled = true;
+    layout.fullRateRadius = radius;
+    return layout;
+}
+
+GLuint Renderer::reconstructVariableRate(int width, int height) {
+    if (width != m_reconstructWidth || height != m_reconstructHeight) {
+        if (m_reconstructTexture) glDeleteTextures(1, &m_reconstructTexture);
+        if (!m_reconstructFBO) glGenFramebuffers(1, &m_reconstructFBO);
+        
+        glGenTextures(1, &m_reconstructTexture);
+        glBindTexture(GL_TEXTURE_2D, m_reconstructTexture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        
+        glBindFramebuffer(GL_FRAMEBUFFER, m_reconstructFBO);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_reconstructTexture, 0);
+        m_reconstructWidth = width;
+        m_reconstructHeight = height;
+    }
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, m_reconstructFBO);
+    glViewport(0, 0, width, height);
+    
+    glUseProgram(m_quadShaderProgram);
+    glUniform1i(glGetUniformLocation(m_quadShaderProgram, "reconstructSparse"), 1);
+    renderFullscreenQuad(m_rayTracingTexture);
+    glUniform1i(glGetUniformLocation(m_quadShaderProgram, "reconstructSparse"), 0);
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, m_offscreenFBO);
+    glViewport(0, 0, m_width, m_height);
+    
+    checkGLError("reconstruct variable rate");
+    return m_reconstructTexture;
 }
 
 void Renderer::uploadCameraUBO(const Camera& camera) {
@@ -412,64 +973,126 @@ void Renderer::uploadCameraUBO(const Camera& camera) {
         glm::vec3 forward; float _pad3;
         float tanHalfFov;
         float aspect;
-        bool moving;
-        int _pad4;
-    } data;
+        int32_t moving;     // std140 bool is 4 bytes
+        int32_t _pad4;
+    } data{};           // Padding included: the ring compares whole blocks
     
     data.pos = camera.getPosition();
     data.right = camera.getRight();
     data.up = camera.getUp();
     data.forward = camera.getForward();
-    data.tanHalfFov = std::tan(glm::radians(60.0f * 0.5f));  // Half FOV in radians
+    data.tanHalfFov = std::tan(glm::radians(camera.getFov() * 0.5f));  // Half FOV in radians
     data.aspect = static_cast<float>(m_width) / static_cast<float>(m_height);
-    data.moving = camera.isMoving();
+    data.moving = camera.isMoving() ? 1 : 0;
+    data._pad4 = 0;
     
-    glBindBuffer(GL_UNIFORM_BUFFER, m_cameraUBO);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(data), &data);
+    static_assert(sizeof(data) == CAMERA_BLOCK_SIZE, "Camera block layout changed");
+    m_cameraUBO.update(&data, sizeof(data));
 }
 
-void Renderer::uploadDiskUBO() {
-    // Accretion disk parameters
-    float diskData[4] = {
-        m_config.getFloat("accretionDisk.innerRadius", 2.785e10f),
-        m_config.getFloat("accretionDisk.outerRadius", 6.595e10f),
-        m_config.getFloat("accretionDisk.temperature", 10000.0f),
-        m_config.getFloat("accretionDisk.thickness", 1e9f)
-    };
+void Renderer::uploadSceneUBO(int width, int height, bool moving, const glm::vec2& jitter, 
+                              const VariableRateLayout& rate) {
+    // Matches the std140 Scene block in geodesic.comp
+    struct SceneUBOData {
+        int32_t renderSize[2];
+        int32_t maxSteps;
+        float geodesicTolerance;
+        float deflectionLogRadiusRange[2];
+        int32_t useDeflectionTable;
+        int32_t _pad0;
+        float jitter[2];
+        float rateCenter[2];
+        float fullRateRadius;
+        int32_t variableRate;
+        float _pad1[2];
+    } data;
     
-    glBindBuffer(GL_UNIFORM_BUFFER, m_diskUBO);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(diskData), diskData);
+    // Moving cameras trade accuracy for speed: fewer steps and a 10x looser tolerance
+    float tolerance = m_settings.geodesic.tolerance;
+    data.renderSize[0] = width;
+    data.renderSize[1] = height;
+    data.maxSteps = moving ? m_settings.geodesic.movingSteps : m_settings.geodesic.maxSteps;
+    data.geodesicTolerance = moving ? tolerance * 10.0f : tolerance;
+    data.deflectionLogRadiusRange[0] = std::log(DEFLECTION_MIN_RADIUS);
+    data.deflectionLogRadiusRange[1] = std::log(DEFLECTION_MAX_RADIUS);
+    data.useDeflectionTable = m_useDeflectionTable ? 1 : 0;
+    data._pad0 = 0;
+    data.jitter[0] = jitter.x;
+    data.jitter[1] = jitter.y;
+    data.rateCenter[0] = rate.center.x;
+    data.rateCenter[1] = rate.center.y;
+    data.fullRateRadius = rate.fullRateRadius;
+    data.variableRate = rate.enabled ? 1 : 0;
+    data._pad1[0] = data._pad1[1] = 0.0f;
+    
+    static_assert(sizeof(data) == SCENE_BLOCK_SIZE, "Scene block layout changed");
+    m_sceneUBO.update(&data, sizeof(data));
 }
 
-void Renderer::uploadObjectsUBO(const std::vector<Object>& objects) {
-    struct ObjectsUBOData {
-        int numObjects;
-        float _pad0, _pad1, _pad2;
-        glm::vec4 posRadius[16];
-        glm::vec4 color[16];
-        float mass[16];
-    } data;
+void Renderer::uploadDiskUBO() {
+    // Written once; after that only a hot reload that changes the disk makes this differ
+    const Settings::DiskSettings& disk = m_settings.disk;
+    float diskData[4] = { disk.innerRadius, disk.outerRadius, disk.temperature, disk.thickness };
+    static_assert(sizeof(diskData) == DISK_BLOCK_SIZE, "Disk block layout changed");
+    m_diskUBO.update(diskData, sizeof(diskData));
+}
+
+void Renderer::applySettings(const Settings& settings, uint32_t changes) {
+    // The black hole's mass and position keep following the simulation snapshots
+    // The disk block is rewritten on the next dispatch because its contents differ
+    m_settings = settings;
+    if (changes & (Settings::DISK | Settings::GEODESIC)) {
+        // Accumulated samples were traced with the old parameters
+        m_historyValid = false;
+    }
+}
+
+void Renderer::uploadObjectsSSBO(const SimulationSnapshot& objects) {
+    const size_t count = objects.size();
+    
+    // Grow geometrically so large clusters don't reallocate every frame
+    if (count > m_objectsCapacity) {
+        size_t capacity = m_objectsCapacity;
+        while (capacity < count) capacity *= 2;
+        createObjectsBuffer(capacity);
+    }
+    
+    // A paused simulation or a repeated headless frame republishes the same state
+    if (m_objectsUploaded && !objects.moving && objects.stateVersion == m_objectsVersion &&
+        count == m_objectsCount) {
+        m_objectsSSBO.bind();
+        return;
+    }
     
-    size_t count = std::min(objects.size(), size_t(16));
-    data.numObjects = static_cast<int>(count);
+    const auto& positions = objects.positions;
+    const auto& radii = objects.radii;
+    const auto& masses = objects.masses;
+    const auto& colors = objects.colors;
     
+    int header[4] = { static_cast<int>(count), 0, 0, 0 };
+    
+    // Written in place when the ring is persistently mapped, otherwise staged and uploaded by commit()
+    char* base = static_cast<char*>(m_objectsSSBO.begin());
+    std::memcpy(base, header, sizeof(header));
+    
+    GPUObject* data = reinterpret_cast<GPUObject*>(base + OBJECTS_HEADER_SIZE);
     for (size_t i = 0; i < count; ++i) {
-        const auto& obj = objects[i];
-        data.posRadius[i] = glm::vec4(obj.getPosition(), obj.getRadius());
-        data.color[i] = obj.getColor();
-        data.mass[i] = obj.getMass();
+        data[i].posRadius = glm::vec4(positions[i], radii[i]);
+        data[i].color = colors[i];
+        data[i].mass = static_cast<float>(masses[i]);
     }
+    m_objectsSSBO.commit(OBJECTS_HEADER_SIZE + count * sizeof(GPUObject));
     
-    glBindBuffer(GL_UNIFORM_BUFFER, m_objectsUBO);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(data), &data);
+    m_objectsUploaded = true;
+    m_objectsVersion = objects.stateVersion;
+    m_objectsCount = count;
 }
 
 void Renderer::renderGrid(const glm::mat4& viewProjMatrix) {
-    // Regenerate grid with current objects (could be optimized)
-    // For now, we'll use a simple static grid
-    if (m_gridIndexCount == 0) {
-        std::vector<Object> emptyObjects;  // Simplified for now
-        generateGrid(emptyObjects);
+    // Only the line topology lives on the CPU; rebuild it when the size changes
+    const int gridSize = m_settings.grid.size;
+    if (gridSize != m_gridBuiltSize) {
+        generateGrid(gridSize);
     }
     
     glUseProgram(m_gridShaderProgram);
@@ -483,6 +1106,10 @@ void Renderer::renderGrid(const glm::mat4& viewProjMatrix) {
         glUniform1f(timeLoc, glfwGetTime());
     }
     
+    glUniform1i(glGetUniformLocation(m_gridShaderProgram, "gridSize"), gridSize);
+    glUniform1f(glGetUniformLocation(m_gridShaderProgram, "gridSpacing"), m_settings.grid.spacing);
+    glUniform4fv(glGetUniformLocation(m_gridShaderProgram, "blackHole"), 1, &m_blackHoleWell[0]);
+    
     // Render grid
     glBindVertexArray(m_gridVAO);
     glEnable(GL_BLEND);
@@ -492,11 +1119,59 @@ void Renderer::renderGrid(const glm::mat4& viewProjMatrix) {
     glBindVertexArray(0);
 }
 
-void Renderer::renderFullscreenQuad() {
+void Renderer::renderTrails(const glm::mat4& viewProjMatrix, const SimulationSnapshot& objects) {
+    if (m_trailVAO == 0) {
+        glGenVertexArrays(1, &m_trailVAO);
+        glGenBuffers(1, &m_trailSampleSSBO);
+        glGenBuffers(1, &m_trailSSBO);
+    }
+    
+    // The sample rings only change when the simulation records a sample
+    const size_t sampleCount = objects.trailSamples.size();
+    if (objects.trailVersion != m_trailVersion && sampleCount > 0) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_trailSampleSSBO);
+        if (sampleCount > m_trailSampleCapacity) {
+            m_trailSampleCapacity = std::max(sampleCount, m_trailSampleCapacity * 2);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, m_trailSampleCapacity * sizeof(glm::vec3), nullptr, GL_DYNAMIC_DRAW);
+        }
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sampleCount * sizeof(glm::vec3), objects.trailSamples.data());
+        m_trailVersion = objects.trailVersion;
+    }
+    
+    const size_t count = objects.trails.size();
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_trailSSBO);
+    if (count > m_trailCapacity) {
+        m_trailCapacity = std::max(count, m_trailCapacity * 2);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, m_trailCapacity * sizeof(glm::uvec4), nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(glm::uvec4), objects.trails.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, m_trailSampleSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, m_trailSSBO);
+    
+    glUseProgram(m_trailShaderProgram);
+    glUniformMatrix4fv(glGetUniformLocation(m_trailShaderProgram, "viewProj"), 1, GL_FALSE, &viewProjMatrix[0][0]);
+    glUniform1ui(glGetUniformLocation(m_trailShaderProgram, "trailLength"), objects.trailLength);
+    
+    // One strip per body: every ring sample plus the body's current position. The
+    // ray traced image carries no depth, so trails are drawn over it
+    glBindVertexArray(m_trailVAO);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArraysInstanced(GL_LINE_STRIP, 0, static_cast<GLsizei>(objects.trailLength + 1), 
+                          static_cast<GLsizei>(count));
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+    glBindVertexArray(0);
+}
+
+void Renderer::renderFullscreenQuad(GLuint texture) {
     glUseProgram(m_quadShaderProgram);
     
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_rayTracingTexture);
+    glBindTexture(GL_TEXTURE_2D, texture);
     glUniform1i(glGetUniformLocation(m_quadShaderProgram, "screenTexture"), 0);
     
     glBindVertexArray(m_quadVAO);
@@ -13,10 +13,14 @@
 #include <map>
 #include <GLFW/glfw3.h>
 
+#include "BufferRing.h"
 #include "Camera.h"
+#include "Profiler.h"
+#include "ShaderCache.h"
 #include "../physics/Physics.h"
-#include "../objects/Object.h"
+#include "SimulationSnapshot.h"
 #include "../utils/Config.h"
+#include "../utils/Settings.h"
 
 class Renderer {
 public:
@@ -36,9 +40,43 @@ public:
     /**
      * @brief Render the current frame
      * @param camera Camera system for view/projection matrices
-     * @param objects List of objects to render
+     * @param objects Bodies to render
      */
-    void render(const Camera& camera, const std::vector<Object>& objects);
+    void render(const Camera& camera, const SimulationSnapshot& objects);
+    
+    /**
+     * @brief Draw lines of text in the top-left corner (profiler overlay)
+     * @param lines Text to draw, one entry per line
+     */
+    void renderOverlay(const std::vector<std::string>& lines);
+    
+    /**
+     * @brief Attach a profiler to time the GPU stages and buffer uploads
+     * @param profiler Profiler to record into (null disables timing)
+     */
+    void setProfiler(Profiler* profiler) { m_profiler = profiler; }
+    
+    /**
+     * @brief Trace bodies from a buffer written on the GPU instead of uploading snapshots
+     * @param buffer Storage buffer in the geodesic.comp Objects layout (0 uploads snapshots again)
+     */
+    void setObjectsBuffer(GLuint buffer) { m_externalObjects = buffer; }
+    
+    /**
+     * @brief Adopt reloaded settings, re-uploading only what changed
+     * @param settings New settings
+     * @param changes Groups that differ from the current settings (Settings::compare)
+     */
+    void applySettings(const Settings& settings, uint32_t changes);
+    
+    /**
+     * @brief Create compute shader program
+     * @param computePath Path to compute shader
+     * @param defines #define lines inserted after the #version directive
+     * @return Linked compute program ID
+     * @throws std::runtime_error if compilation or linking fails
+     */
+    GLuint createComputeProgram(const std::string& computePath, const std::string& defines = "");
     
     /**
      * @brief Handle window resize
@@ -52,41 +90,145 @@ public:
      */
     void toggleGrid() { m_showGrid = !m_showGrid; }
     
+    /**
+     * @brief Toggle body trail rendering
+     */
+    void toggleTrails() { m_showTrails = !m_showTrails; }
+    
     /**
      * @brief Set adaptive quality mode
      * @param enabled Enable/disable adaptive quality
      */
     void setAdaptiveQuality(bool enabled) { m_adaptiveQuality = enabled; }
+    
+    /**
+     * @brief Render into an offscreen framebuffer instead of the window (headless mode)
+     * @return True if the framebuffer is complete
+     */
+    bool createOffscreenTarget();
+    
+    /**
+     * @brief Get the framebuffer holding the final image
+     * @return Offscreen framebuffer in headless mode, otherwise 0 (the window)
+     */
+    GLuint getOutputFramebuffer() const { return m_offscreenFBO; }
+    
+    /**
+     * @brief Get output width
+     * @return Width in pixels
+     */
+    int getWidth() const { return m_width; }
+    
+    /**
+     * @brief Get output height
+     * @return Height in pixels
+     */
+    int getHeight() const { return m_height; }
 
 private:
     // Configuration
-    Config m_config;
+    Settings m_settings;            ///< Values read on the frame path, resolved from the config
+    ShaderCache m_shaderCache;      ///< Program binaries from earlier launches
     int m_width, m_height;
     
     // Shader programs
     GLuint m_quadShaderProgram;     ///< Fullscreen quad shader
     GLuint m_gridShaderProgram;     ///< Spacetime grid shader
-    GLuint m_computeShaderProgram;  ///< Ray tracing compute shader
+    GLuint m_trailShaderProgram;    ///< Body trail shader
+    /**
+     * @brief Ray tracing programs compiled for one black hole
+     */
+    struct GeodesicVariant {
+        GLuint direct = 0;          ///< One invocation per pixel
+        GLuint classify = 0;        ///< Tile classification pass (tile scheduling)
+        GLuint persistent = 0;      ///< Persistent-threads pass over queued rays
+    };
+    GeodesicVariant m_geodesic;     ///< Ray tracing variant for the current black hole
+    std::map<std::string, GeodesicVariant> m_geodesicVariants; ///< Ray tracing programs keyed by their #define block
+    GLuint m_deflectionShaderProgram; ///< Deflection table generation shader
+    GLuint m_accumulateShaderProgram; ///< Temporal accumulation shader
+    GLuint m_overlayShaderProgram;  ///< Text overlay shader
     
     // OpenGL objects
     GLuint m_quadVAO;              ///< Fullscreen quad vertex array
     GLuint m_quadVBO;              ///< Fullscreen quad vertex buffer
     GLuint m_gridVAO;              ///< Grid vertex array
-    GLuint m_gridVBO;              ///< Grid vertex buffer
-    GLuint m_gridEBO;              ///< Grid element buffer
+    GLuint m_gridEBO;              ///< Grid line indices (vertices are generated in grid.vert)
+    GLuint m_trailVAO;             ///< Empty vertex array for trails (vertices come from storage buffers)
+    GLuint m_trailSampleSSBO;      ///< Ring storage of every trail
+    GLuint m_trailSSBO;            ///< Per-body ring slot, head and count
+    size_t m_trailSampleCapacity;  ///< Samples m_trailSampleSSBO can hold
+    size_t m_trailCapacity;        ///< Bodies m_trailSSBO can hold
+    uint64_t m_trailVersion;       ///< Trail pool version last uploaded
+    GLuint m_overlayVAO;           ///< Empty vertex array for the overlay quad
+    GLuint m_overlayTexture;       ///< Rasterized overlay text
+    std::vector<unsigned char> m_overlayPixels; ///< Overlay text coverage being uploaded
     
     // Textures
     GLuint m_rayTracingTexture;    ///< Output texture for ray tracing
+    GLuint m_deflectionTrajectory; ///< 3D table of precomputed ray radii
+    GLuint m_deflectionOutcome;    ///< 2D table of ray sweep angle and escape/capture
+    GLuint m_historyTextures[2];   ///< Accumulated image, ping-ponged each resolve
+    int m_historyIndex;            ///< History texture holding the latest result
     
-    // Uniform buffer objects
-    GLuint m_cameraUBO;            ///< Camera uniform buffer
-    GLuint m_diskUBO;              ///< Accretion disk uniform buffer
-    GLuint m_objectsUBO;           ///< Objects uniform buffer
+    // Uniform buffer objects (each written only when its contents change)
+    BufferRing m_cameraUBO;        ///< Camera uniform block
+    BufferRing m_sceneUBO;         ///< Per-dispatch quality settings
+    BufferRing m_diskUBO;          ///< Accretion disk parameters
+    
+    // Object shader storage buffer
+    BufferRing m_objectsSSBO;      ///< Objects shader storage buffer
+    size_t m_objectsCapacity;      ///< Number of objects each region can hold
+    bool m_objectsUploaded;        ///< m_objectsSSBO holds the snapshot identified below
+    uint64_t m_objectsVersion;     ///< Body-state version of the uploaded snapshot
+    size_t m_objectsCount;         ///< Body count of the uploaded snapshot
+    GLuint m_externalObjects;      ///< Objects buffer owned by a GPU physics backend (0 if none)
+    GLuint m_rayQueueSSBO;         ///< Rays queued for the persistent-threads pass
+    
+    // Offscreen target (headless mode)
+    GLuint m_offscreenFBO;         ///< Framebuffer rendered into (0 = window)
+    GLuint m_offscreenColor;       ///< Color attachment
+    GLuint m_offscreenDepth;       ///< Depth attachment
     
     // Rendering state
+    Profiler* m_profiler;          ///< Stage timing (may be null)
     bool m_showGrid;               ///< Show spacetime grid
+    bool m_showTrails;             ///< Show body trails
     bool m_adaptiveQuality;        ///< Enable adaptive quality
+    bool m_useDeflectionTable;     ///< Shade far-field rays from the deflection table
+    bool m_tileScheduling;         ///< Classify tiles and integrate queued rays with persistent threads
+    bool m_variableRate;           ///< Trace the background around the black hole sparsely
+    int m_rayBudget;               ///< Rays per dispatch the variable-rate layout aims for
+    GLuint m_reconstructFBO;       ///< Target of the variable-rate reconstruction pass
+    GLuint m_reconstructTexture;   ///< Ray traced image with skipped pixels filled in
+    int m_reconstructWidth;        ///< Current reconstruction texture width
+    int m_reconstructHeight;       ///< Current reconstruction texture height
+    
+    // Temporal accumulation state
+    /**
+     * @brief Camera orientation used to detect changes and reproject history
+     */
+    struct CameraBasis {
+        glm::vec3 position;
+        glm::vec3 right;
+        glm::vec3 up;
+        glm::vec3 forward;
+    };
+    bool m_temporalAccumulation;   ///< Accumulate and reproject ray traced frames
+    int m_maxAccumulatedSamples;   ///< Samples after which a still view stops tracing
+    float m_temporalBlend;         ///< New-sample weight while the view changes
+    int m_accumulatedSamples;      ///< Samples averaged into the history so far
+    int m_jitterIndex;             ///< Position in the subpixel jitter sequence
+    bool m_historyValid;           ///< History holds an image
+    CameraBasis m_previousCamera;  ///< Camera of the history image
+    uint64_t m_previousStateVersion; ///< Body-state version of the history image
+    double m_previousBlackHoleMass; ///< Black hole mass of the history image
+    size_t m_previousObjectCount;  ///< Body count of the history image
     int m_gridIndexCount;          ///< Number of grid indices
+    int m_gridBuiltSize;           ///< rendering.gridSize the indices were built for
+    int m_computeWidth;            ///< Current ray tracing texture width
+    int m_computeHeight;           ///< Current ray tracing texture height
+    glm::vec4 m_blackHoleWell;     ///< Black hole position and Schwarzschild radius for grid.vert
     
     // Compute resolution settings
     int m_staticWidth, m_staticHeight;     ///< High quality resolution
@@ -126,11 +268,23 @@ private:
     GLuint createShaderProgram(const std::string& vertexPath, const std::string& fragmentPath);
     
     /**
-     * @brief Create compute shader program
-     * @param computePath Path to compute shader
-     * @return Linked compute program ID
+     * @brief Insert #define lines after a shader's #version directive
+     * @param source Shader source
+     * @param defines Lines to insert (each ending in a newline)
+     * @return Specialized source
+     */
+    std::string injectDefines(const std::string& source, const std::string& defines);
+    
+    /**
+     * @brief Use the ray tracing variant compiled for a black hole mass
+     *
+     * Per-mass constants are compiled into geodesic.comp as #defines so the
+     * compiler can fold them. Variants are cached by their #define block, so
+     * switching back to a mass seen before costs nothing.
+     *
+     * @param blackHoleMass Black hole mass in kg (0 keeps the current variant)
      */
-    GLuint createComputeProgram(const std::string& computePath);
+    void selectGeodesicProgram(double blackHoleMass);
     
     /**
      * @brief Initialize fullscreen quad for final rendering
@@ -138,22 +292,89 @@ private:
     void initializeQuad();
     
     /**
-     * @brief Generate and initialize spacetime grid
-     * @param objects List of objects affecting spacetime curvature
+     * @brief Build the spacetime grid line indices
+     * @param gridSize Cells per side
+     */
+    void generateGrid(int gridSize);
+    
+    /**
+     * @brief Precompute Schwarzschild ray trajectories with deflection.comp
      */
-    void generateGrid(const std::vector<Object>& objects);
+    void generateDeflectionTable();
     
     /**
      * @brief Initialize uniform buffer objects
      */
     void initializeUBOs();
     
+    /**
+     * @brief (Re)create the objects storage buffer ring
+     * @param capacity Number of objects each region must hold
+     */
+    void createObjectsBuffer(size_t capacity);
+    
+    /**
+     * @brief Variable-rate layout of one dispatch
+     */
+    struct VariableRateLayout {
+        bool enabled = false;           ///< Trace the outer image sparsely
+        glm::vec2 center{0.0f};         ///< Black hole position in dispatch pixels
+        float fullRateRadius = 0.0f;    ///< Full rate inside, 1/4 rate out to twice this, 1/16 beyond
+    };
+    
     /**
      * @brief Dispatch the compute shader for ray tracing
      * @param camera Current camera state
-     * @param objects List of objects in the scene
+     * @param objects Bodies in the scene
+     * @param jitter Subpixel ray offset in pixels
+     * @param variableRate Trace the outer image sparsely and reconstruct it
+     * @return Texture holding the traced image
+     */
+    GLuint dispatchCompute(const Camera& camera, const SimulationSnapshot& objects, const glm::vec2& jitter, 
+                           bool variableRate);
+    
+    /**
+     * @brief Choose the full-rate region around the black hole for the ray budget
+     *
+     * The region covers the shadow, the photon ring and the accretion disk.
+     * It shrinks when tracing it would exceed rendering.rayBudget.
+     *
+     * @param camera Current camera state
+     * @param width Dispatch width
+     * @param height Dispatch height
+     * @return Layout to trace with (disabled when it would save nothing)
+     */
+    VariableRateLayout planVariableRate(const Camera& camera, int width, int height) const;
+    
+    /**
+     * @brief Fill in the pixels a variable-rate dispatch skipped (fragment.frag)
+     * @param width Dispatch width
+     * @param height Dispatch height
+     * @return Reconstructed texture
+     */
+    GLuint reconstructVariableRate(int width, int height);
+    
+    /**
+     * @brief Trace a jittered sample and fold it into the accumulation history
+     *
+     * Skips tracing entirely once a still view has converged.
+     *
+     * @param camera Current camera state
+     * @param objects Bodies in the scene
+     * @return Texture to display
      */
-    void dispatchCompute(const Camera& camera, const std::vector<Object>& objects);
+    GLuint traceAccumulated(const Camera& camera, const SimulationSnapshot& objects);
+    
+    /**
+     * @brief Blend the latest ray traced sample into the history
+     * @param camera Current camera state
+     * @param basis Current camera orientation
+     * @param sample Texture holding the new sample
+     * @param reproject Reproject the history from the previous camera
+     * @param blend Weight of the new sample
+     */
+    void resolveAccumulation(const Camera& camera, const CameraBasis& basis, GLuint sample, 
+                             bool reproject, float blend);
     
     /**
      * @brief Upload camera data to GPU
@@ -161,16 +382,27 @@ private:
      */
     void uploadCameraUBO(const Camera& camera);
     
+    /**
+     * @brief Upload resolution, step budget and tolerance for this dispatch
+     * @param width Dispatch width
+     * @param height Dispatch height
+     * @param moving Use the reduced quality settings for a moving camera
+     * @param jitter Subpixel ray offset in pixels
+     * @param rate Variable-rate layout
+     */
+    void uploadSceneUBO(int width, int height, bool moving, const glm::vec2& jitter, 
+                        const VariableRateLayout& rate);
+    
     /**
      * @brief Upload accretion disk data to GPU
      */
     void uploadDiskUBO();
     
     /**
-     * @brief Upload object data to GPU
-     * @param objects List of objects to upload
+     * @brief Write object data into the objects storage buffer (skipped if the snapshot is unchanged)
+     * @param objects Bodies to upload
      */
-    void uploadObjectsUBO(const std::vector<Object>& objects);
+    void uploadObjectsSSBO(const SimulationSnapshot& objects);
     
     /**
      * @brief Render the spacetime grid
@@ -178,10 +410,18 @@ private:
      */
     void renderGrid(const glm::mat4& viewProjMatrix);
     
+    /**
+     * @brief Render every body's trail as one instanced line strip draw
+     * @param viewProjMatrix Combined view-projection matrix
+     * @param objects Bodies and their trails
+     */
+    void renderTrails(const glm::mat4& viewProjMatrix, const SimulationSnapshot& objects);
+    
     /**
      * @brief Render fullscreen quad with ray tracing result
+     * @param texture Image to display
      */
-    void renderFullscreenQuad();
+    void renderFullscreenQuad(GLuint texture);
     
     /**
      * @brief Check for OpenGL errors and log them
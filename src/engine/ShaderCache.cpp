@@ -0,0 +1,187 @@
+/**
+ * @file ShaderCache.cpp
+ * @brief Implementation of the program binary cache
+ */
+
+#include "ShaderCache.h"
+#include "../utils/Logger.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+constexpr char ENTRY_MAGIC[4] = {'B', 'H', 'S', 'C'};
+constexpr uint32_t ENTRY_VERSION = 1;
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+/**
+ * @brief Fold bytes into a 64-bit FNV-1a hash
+ */
+uint64_t hashBytes(uint64_t hash, const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Fold a string and its length into a hash, so concatenations differ
+ */
+uint64_t hashString(uint64_t hash, const std::string& text) {
+    const uint64_t length = text.size();
+    hash = hashBytes(hash, &length, sizeof(length));
+    return hashBytes(hash, text.data(), text.size());
+}
+
+/**
+ * @brief Read a GL identification string, tolerating a null result
+ */
+std::string glString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+}
+
+ShaderCache::ShaderCache(const Config& config)
+    : m_enabled(config.getBool("shaderCache.enabled", true))
+    , m_directory(config.getString("shaderCache.directory", "shader_cache"))
+    , m_driverHash(FNV_OFFSET)
+    , m_hits(0)
+    , m_misses(0) {
+    if (!m_enabled) return;
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) {
+        Logger::getInstance().log(Logger::Level::INFO,
+            "Driver offers no program binary formats, shader cache disabled");
+        m_enabled = false;
+        return;
+    }
+
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        m_driverHash = hashString(m_driverHash, glString(name));
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        Logger::getInstance().log(Logger::Level::WARNING,
+            "Cannot create shader cache directory " + m_directory + ", shader cache disabled");
+        m_enabled = false;
+    }
+}
+
+uint64_t ShaderCache::makeKey(const std::vector<std::string>& sources) const {
+    uint64_t key = m_driverHash;
+    for (const std::string& source : sources) {
+        key = hashString(key, source);
+    }
+    return key;
+}
+
+GLuint ShaderCache::load(uint64_t key) {
+    if (!m_enabled) return 0;
+
+    const std::string path = entryPath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        ++m_misses;
+        return 0;
+    }
+
+    EntryHeader header;
+    std::vector<char> binary;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    bool valid = file && std::memcmp(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC)) == 0 &&
+                 header.version == ENTRY_VERSION && header.key == key && header.length > 0;
+    if (valid) {
+        binary.resize(header.length);
+        file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+        valid = static_cast<bool>(file);
+    }
+    file.close();
+
+    GLuint program = 0;
+    if (valid) {
+        program = glCreateProgram();
+        glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+        GLint success = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glDeleteProgram(program);
+            program = 0;
+
+            // An unknown format raises GL_INVALID_ENUM; it is handled here, not by the caller's checks
+            while (glGetError() != GL_NO_ERROR) {}
+        }
+    }
+
+    if (!program) {
+        // Drivers may reject binaries from another build even with identical strings
+        Logger::getInstance().log(Logger::Level::DEBUG, "Discarding unusable shader cache entry " + path);
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        ++m_misses;
+        return 0;
+    }
+
+    ++m_hits;
+    return program;
+}
+
+void ShaderCache::prepare(GLuint program) const {
+    if (m_enabled) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+void ShaderCache::store(uint64_t key, GLuint program) {
+    if (!m_enabled) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+
+    EntryHeader header;
+    std::memcpy(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC));
+    header.version = ENTRY_VERSION;
+    header.key = key;
+    header.format = format;
+    header.length = static_cast<uint32_t>(written);
+
+    // Another instance starting at the same time must never read a partial entry
+    const std::string path = entryPath(key);
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        if (!file) {
+            Logger::getInstance().log(Logger::Level::WARNING, "Failed to write shader cache entry " + path);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+}
+
+std::string ShaderCache::entryPath(uint64_t key) const {
+    char filename[32];
+    std::snprintf(filename, sizeof(filename), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(m_directory) / filename).string();
+}
@@ -0,0 +1,106 @@
+/**
+ * @file ShaderCache.h
+ * @brief On-disk cache of linked shader program binaries
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../utils/Config.h"
+
+/**
+ * @brief Skips GLSL compilation on later launches by reloading linked program binaries
+ *
+ * Programs are keyed by a 64-bit FNV-1a hash of the GL vendor, renderer and
+ * version strings and of every stage's final source, so a changed shader,
+ * a different set of injected #defines or a driver update each produce a
+ * new key rather than a stale program. Each entry is one file,
+ * <shaderCache.directory>/<key>.bin, holding the binary format and blob
+ * returned by glGetProgramBinary. A binary the driver rejects is deleted and
+ * the caller compiles from source as if the cache were empty.
+ *
+ * The cache disables itself when the driver offers no program binary
+ * formats, and everything goes through the normal compile path.
+ */
+class ShaderCache {
+public:
+    /**
+     * @brief Read the cache settings and the driver identification
+     * @param config Configuration object (shaderCache section); requires a current GL context
+     */
+    explicit ShaderCache(const Config& config);
+
+    /**
+     * @brief Check whether binaries are loaded and stored
+     * @return False if disabled by config or unsupported by the driver
+     */
+    bool isEnabled() const { return m_enabled; }
+
+    /**
+     * @brief Build the cache key for a program
+     * @param sources Final source of every stage, in attachment order
+     * @return Key for load() and store()
+     */
+    uint64_t makeKey(const std::vector<std::string>& sources) const;
+
+    /**
+     * @brief Create a program from a cached binary
+     * @param key Program key
+     * @return Linked program, or 0 if there is no entry or the driver rejected it
+     */
+    GLuint load(uint64_t key);
+
+    /**
+     * @brief Ask the driver to keep a program's binary retrievable; call before linking
+     * @param program Program about to be linked
+     */
+    void prepare(GLuint program) const;
+
+    /**
+     * @brief Write a freshly linked program's binary to the cache
+     * @param key Program key
+     * @param program Linked program (prepared with prepare())
+     */
+    void store(uint64_t key, GLuint program);
+
+    /**
+     * @brief Get the number of programs loaded from the cache
+     * @return Cache hits since construction
+     */
+    size_t getHits() const { return m_hits; }
+
+    /**
+     * @brief Get the number of programs that had to be compiled
+     * @return Cache misses (including rejected binaries) since construction
+     */
+    size_t getMisses() const { return m_misses; }
+
+private:
+    /**
+     * @brief Fixed header in front of each cached binary
+     */
+    struct EntryHeader {
+        char magic[4];          ///< "BHSC"
+        uint32_t version;       ///< Entry layout version
+        uint64_t key;           ///< Program key (guards against renamed files)
+        uint32_t format;        ///< Binary format from glGetProgramBinary
+        uint32_t length;        ///< Binary size in bytes
+    };
+
+    bool m_enabled;             ///< Cache is in use
+    std::string m_directory;    ///< Directory holding the entries
+    uint64_t m_driverHash;      ///< Hash of the vendor, renderer and version strings
+    size_t m_hits;              ///< Programs loaded from binaries
+    size_t m_misses;            ///< Programs compiled from source
+
+    /**
+     * @brief Build the path of an entry
+     * @param key Program key
+     * @return Entry file path
+     */
+    std::string entryPath(uint64_t key) const;
+};
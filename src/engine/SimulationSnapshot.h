@@ -0,0 +1,53 @@
+/**
+ * @file SimulationSnapshot.h
+ * @brief Render-side copy of the simulation state
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../physics/BodyHandle.h"
+
+/**
+ * @brief Body state published by the simulation thread after a step
+ *
+ * Holds everything the renderer needs, so rendering never touches Physics.
+ * previousPositions holds the positions one step earlier, which lets the
+ * render thread interpolate between the last two steps. Trail samples are
+ * only copied when the trail pool has changed since this slot last held them.
+ * denseIndices resolves a BodyHandle in O(1): the body is
+ * denseIndices[handle.index] if handles there still matches the handle.
+ * stateVersion only advances when the bodies themselves changed, so consumers
+ * that cache work per scene can tell a real change from the clock ticking.
+ */
+struct SimulationSnapshot {
+    std::vector<glm::vec3> positions;           ///< Positions after the step
+    std::vector<glm::vec3> previousPositions;   ///< Positions before the step
+    std::vector<float> radii;                   ///< Body radii
+    std::vector<double> masses;                 ///< Body masses
+    std::vector<glm::vec4> colors;              ///< Body render colors
+    std::vector<BodyHandle> handles;            ///< Stable handle of each body
+    std::vector<uint32_t> denseIndices;         ///< Body index of each handle slot (INVALID_INDEX if free)
+    double blackHoleMass = 0.0;                 ///< Mass of the central black hole (kg)
+
+    std::vector<glm::vec3> trailSamples;        ///< Ring storage of every trail (TrailPool layout)
+    std::vector<glm::uvec4> trails;             ///< Per body: x = ring slot, y = ring head, z = valid samples
+    uint32_t trailLength = 0;                   ///< Samples per ring
+    uint64_t trailVersion = ~uint64_t(0);       ///< TrailPool version trailSamples was copied at
+
+    double simulationTime = 0.0;                ///< Simulated time after the step (s)
+    double wallTime = 0.0;                      ///< Steady-clock time the step's state is due (s)
+    float timeStep = 0.0f;                      ///< Fixed step length (s)
+    uint64_t step = 0;                          ///< Step counter
+    uint64_t stateVersion = 0;                  ///< Bumped when positions, radii, masses or handles change
+    bool moving = false;                        ///< previousPositions differ from positions
+
+    /**
+     * @brief Get number of bodies
+     * @return Body count
+     */
+    size_t size() const { return positions.size(); }
+};
@@ -0,0 +1,232 @@
+/**
+ * @file SimulationThread.cpp
+ * @brief Implementation of the fixed-timestep simulation thread
+ */
+
+#include "SimulationThread.h"
+#include "../utils/Logger.h"
+#include "../utils/Metrics.h"
+#include <chrono>
+#include <cstring>
+#include <string>
+
+namespace {
+
+/// Steps allowed per wakeup before the backlog is dropped (avoids a spiral of death)
+constexpr int MAX_CATCH_UP_STEPS = 8;
+
+constexpr uint64_t HASH_OFFSET = 0xcbf29ce484222325ull;
+constexpr uint64_t HASH_PRIME = 0x100000001b3ull;
+
+/**
+ * @brief Fold an array into a 64-bit hash eight bytes at a time
+ *
+ * FNV-1a over words rather than bytes: it only has to notice that the
+ * published state changed, and a byte loop would cost more than the copy.
+ */
+template<typename T>
+uint64_t hashArray(uint64_t hash, const std::vector<T>& values) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(values.data());
+    const size_t size = values.size() * sizeof(T);
+    size_t offset = 0;
+    for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes + offset, sizeof(word));
+        hash = (hash ^ word) * HASH_PRIME;
+    }
+    uint64_t tail = 0;
+    if (offset < size) {
+        std::memcpy(&tail, bytes + offset, size - offset);
+    }
+    return (hash ^ tail ^ size) * HASH_PRIME;
+}
+
+}
+
+SimulationThread::SimulationThread(Physics& physics)
+    : m_physics(physics)
+    , m_timeStep(physics.getTimeStep() > 0.0f ? physics.getTimeStep() : 0.016666f)
+    , m_running(false) {
+}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start() {
+    if (m_running) return;
+
+    // The renderer has a valid state before the first step completes
+    publishSnapshot(now());
+
+    m_running = true;
+    m_thread = std::thread(&SimulationThread::run, this);
+
+    Logger::getInstance().log(Logger::Level::INFO,
+        "Simulation thread started at " + std::to_string(1.0f / m_timeStep) + " Hz");
+}
+
+void SimulationThread::stop() {
+    if (!m_running) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_eventMutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    Logger::getInstance().log(Logger::Level::INFO, "Simulation thread stopped");
+}
+
+void SimulationThread::advance(int steps) {
+    if (m_running) return;
+
+    applyEvents();
+    for (int i = 0; i < steps; ++i) {
+        m_previousPositions = m_physics.getParticles().getPositions();
+        stepOnce();
+    }
+    publishSnapshot(now());
+}
+
+void SimulationThread::postKeyEvent(int key, int action, int mods) {
+    {
+        std::lock_guard<std::mutex> lock(m_eventMutex);
+        m_pendingEvents.push_back({key, action, mods});
+    }
+    m_wake.notify_all();
+}
+
+const SimulationSnapshot& SimulationThread::acquireSnapshot() {
+    m_snapshots.update();
+    return m_snapshots.getReadBuffer();
+}
+
+double SimulationThread::now() {
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(steady_clock::now().time_since_epoch()).count();
+}
+
+void SimulationThread::run() {
+    Metrics::getInstance().setThreadName("simulation");
+    using Clock = std::chrono::steady_clock;
+    const auto step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_timeStep));
+
+    // Wall-clock time at which the next step is due
+    Clock::time_point next = Clock::now() + step;
+
+    while (m_running) {
+        applyEvents();
+
+        int steps = 0;
+        while (Clock::now() >= next && steps < MAX_CATCH_UP_STEPS) {
+            m_previousPositions = m_physics.getParticles().getPositions();
+            stepOnce();
+            next += step;
+            ++steps;
+        }
+
+        if (steps > 0) {
+            // The newest state became due one step before the next one
+            double due = std::chrono::duration_cast<std::chrono::duration<double>>(
+                (next - step).time_since_epoch()).count();
+            publishSnapshot(due);
+        }
+
+        // Fell too far behind: drop the backlog rather than run ever more steps
+        if (steps == MAX_CATCH_UP_STEPS && Clock::now() >= next) {
+            Logger::getInstance().log(Logger::Level::DEBUG,
+                "Simulation thread behind real time, skipping backlog");
+            next = Clock::now() + step;
+        }
+
+        std::unique_lock<std::mutex> lock(m_eventMutex);
+        m_wake.wait_until(lock, next, [this] {
+            return !m_running || !m_pendingEvents.empty();
+        });
+    }
+}
+
+void SimulationThread::stepOnce() {
+    {
+        Profiler::CpuScope timer(m_profiler, Profiler::Stage::Physics);
+        m_physics.update(m_timeStep);
+    }
+
+    if (m_snapshotWriter && m_snapshotWriter->isDue(m_physics.getStepCount())) {
+        m_snapshotWriter->capture(m_physics);
+    }
+}
+
+void SimulationThread::applyEvents() {
+    {
+        std::lock_guard<std::mutex> lock(m_eventMutex);
+        m_events.swap(m_pendingEvents);
+    }
+
+    for (const KeyEvent& event : m_events) {
+        m_physics.processKeyboard(event.key, event.action, event.mods);
+    }
+    m_events.clear();
+}
+
+void SimulationThread::publishSnapshot(double wallTime) {
+    const ParticleStore& particles = m_physics.getParticles();
+    SimulationSnapshot& snapshot = m_snapshots.getWriteBuffer();
+
+    snapshot.positions = particles.getPositions();
+    snapshot.radii = particles.getRadii();
+    snapshot.masses = particles.getMasses();
+    snapshot.handles = particles.getHandles();
+
+    snapshot.colors.resize(particles.size());
+    snapshot.denseIndices.assign(particles.getSlotCount(), BodyHandle::INVALID_INDEX);
+    for (size_t i = 0; i < particles.size(); ++i) {
+        snapshot.colors[i] = particles.getInfo(i).color;
+        snapshot.denseIndices[snapshot.handles[i].index] = static_cast<uint32_t>(i);
+    }
+
+    // Bodies merged or swallowed this step break index correspondence; don't interpolate
+    if (m_previousPositions.size() == snapshot.positions.size()) {
+        snapshot.previousPositions = m_previousPositions;
+    } else {
+        snapshot.previousPositions = snapshot.positions;
+    }
+
+    // Samples change only every trails.sampleInterval steps; slots keep the last copy
+    const TrailPool& trails = particles.getTrails();
+    if (snapshot.trailVersion != trails.getVersion()) {
+        snapshot.trailSamples = trails.getSamples();
+        snapshot.trailVersion = trails.getVersion();
+    }
+    snapshot.trailLength = trails.getLength();
+    snapshot.trails.resize(particles.size());
+    for (size_t i = 0; i < particles.size(); ++i) {
+        TrailPool::Slot slot = particles.getInfo(i).trailSlot;
+        snapshot.trails[i] = glm::uvec4(slot, trails.getHead(slot), trails.getCount(slot), 0);
+    }
+
+    snapshot.blackHoleMass = m_physics.getBlackHole().getMass();
+    snapshot.simulationTime = m_physics.getSimulationTime();
+    snapshot.wallTime = wallTime;
+    snapshot.timeStep = m_timeStep;
+    snapshot.step = m_physics.getStepCount();
+
+    // Steps with gravity off, or a paused simulation, leave the bodies where they were
+    snapshot.moving = snapshot.previousPositions != snapshot.positions;
+    uint64_t hash = hashArray(HASH_OFFSET, snapshot.positions);
+    hash = hashArray(hash, snapshot.radii);
+    hash = hashArray(hash, snapshot.masses);
+    hash = hashArray(hash, snapshot.handles);
+    if (hash != m_stateHash || m_stateVersion == 0) {
+        m_stateHash = hash;
+        ++m_stateVersion;
+    }
+    snapshot.stateVersion = m_stateVersion;
+
+    m_snapshots.publish();
+}
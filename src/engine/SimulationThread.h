@@ -0,0 +1,145 @@
+/**
+ * @file SimulationThread.h
+ * @brief Dedicated thread advancing the physics at a fixed time step
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Profiler.h"
+#include "SimulationSnapshot.h"
+#include "SnapshotWriter.h"
+#include "TripleBuffer.h"
+#include "../physics/Physics.h"
+
+/**
+ * @brief Runs Physics on its own thread, decoupled from the render rate
+ *
+ * The thread advances the simulation in fixed steps of physics.timeStep, paced
+ * against the steady clock, and publishes a SimulationSnapshot after each batch
+ * of steps through a lock-free triple buffer. While running, the thread owns
+ * the Physics object exclusively; input meant for it is queued with
+ * postKeyEvent() and applied between steps.
+ */
+class SimulationThread {
+public:
+    /**
+     * @brief Create the simulation thread (not started)
+     * @param physics Physics system to advance (must outlive this object)
+     */
+    explicit SimulationThread(Physics& physics);
+
+    /**
+     * @brief Stop and join the thread
+     */
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    /**
+     * @brief Publish the initial state and start stepping
+     */
+    void start();
+
+    /**
+     * @brief Stop stepping and join the thread
+     */
+    void stop();
+
+    /**
+     * @brief Step synchronously on the calling thread and publish (thread not started)
+     *
+     * Used by headless rendering, where frames must follow simulated rather
+     * than wall-clock time.
+     *
+     * @param steps Number of fixed steps to take
+     */
+    void advance(int steps);
+
+    /**
+     * @brief Queue a keyboard event for Physics::processKeyboard
+     * @param key GLFW key code
+     * @param action GLFW action
+     * @param mods GLFW modifier keys
+     */
+    void postKeyEvent(int key, int action, int mods);
+
+    /**
+     * @brief Time each physics step into a profiler (call before start())
+     * @param profiler Profiler to record into (null disables timing)
+     */
+    void setProfiler(Profiler* profiler) { m_profiler = profiler; }
+
+    /**
+     * @brief Checkpoint the physics state whenever the writer says one is due (call before start())
+     * @param writer Snapshot writer (null disables checkpoints)
+     */
+    void setSnapshotWriter(SnapshotWriter* writer) { m_snapshotWriter = writer; }
+
+    /**
+     * @brief Get the newest published snapshot (render thread only)
+     * @return Snapshot valid until the next call
+     */
+    const SimulationSnapshot& acquireSnapshot();
+
+    /**
+     * @brief Get the steady-clock time used for pacing and interpolation
+     * @return Time in seconds
+     */
+    static double now();
+
+private:
+    /**
+     * @brief Queued input event
+     */
+    struct KeyEvent {
+        int key;
+        int action;
+        int mods;
+    };
+
+    Physics& m_physics;                             ///< Simulation being advanced
+    float m_timeStep;                               ///< Fixed step length (s)
+
+    std::thread m_thread;                           ///< Simulation thread
+    std::atomic<bool> m_running;                    ///< Cleared to stop the thread
+
+    std::mutex m_eventMutex;                        ///< Guards m_pendingEvents and wakeups
+    std::condition_variable m_wake;                 ///< Wakes the thread early for input or stop
+    std::vector<KeyEvent> m_pendingEvents;          ///< Events posted since the last drain
+    std::vector<KeyEvent> m_events;                 ///< Events being applied (sim thread)
+
+    TripleBuffer<SimulationSnapshot> m_snapshots;   ///< Published state
+    Profiler* m_profiler = nullptr;                 ///< Step timing (may be null)
+    SnapshotWriter* m_snapshotWriter = nullptr;     ///< Periodic checkpoints (may be null)
+    std::vector<glm::vec3> m_previousPositions;     ///< Positions before the latest step
+    uint64_t m_stateHash = 0;                       ///< Body-state hash of the last published snapshot
+    uint64_t m_stateVersion = 0;                    ///< Published as SimulationSnapshot::stateVersion
+
+    /**
+     * @brief Thread main loop
+     */
+    void run();
+
+    /**
+     * @brief Take one fixed step and checkpoint it if a snapshot is due
+     */
+    void stepOnce();
+
+    /**
+     * @brief Apply queued input events to Physics
+     */
+    void applyEvents();
+
+    /**
+     * @brief Copy the current Physics state into the back snapshot and publish it
+     * @param wallTime Steady-clock time the state is due
+     */
+    void publishSnapshot(double wallTime);
+};
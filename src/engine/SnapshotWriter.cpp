@@ -0,0 +1,92 @@
+/**
+ * @file SnapshotWriter.cpp
+ * @brief Implementation of the background checkpoint writer
+ */
+
+#include "SnapshotWriter.h"
+#include "../physics/SnapshotFile.h"
+#include "../utils/Logger.h"
+#include "../utils/Metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+SnapshotWriter::SnapshotWriter(const Config& config)
+    : m_interval(static_cast<uint64_t>(std::max(0, config.getInt("snapshot.interval", 0))))
+    , m_directory(config.getString("snapshot.directory", "snapshots"))
+    , m_pendingStep(0)
+    , m_hasPending(false)
+    , m_stopping(false) {
+    m_thread = std::thread(&SnapshotWriter::run, this);
+
+    if (m_interval > 0) {
+        Logger::getInstance().log(Logger::Level::INFO,
+            "Writing a snapshot every " + std::to_string(m_interval) + " steps to " + m_directory);
+    }
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_ready.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void SnapshotWriter::capture(const Physics& physics) {
+    const uint64_t step = physics.getStepCount();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_hasPending) {
+            Logger::getInstance().log(Logger::Level::WARNING,
+                "Snapshot writer still busy, skipping the snapshot at step " + std::to_string(step));
+            return;
+        }
+    }
+
+    // Only this thread touches the staging buffer, so encoding needs no lock
+    physics.encodeSnapshot(m_staging);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_staging.swap(m_pending);
+        m_pendingStep = step;
+        m_hasPending = true;
+    }
+    m_ready.notify_all();
+}
+
+void SnapshotWriter::run() {
+    Metrics::getInstance().setThreadName("snapshot");
+
+    while (true) {
+        uint64_t step;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_ready.wait(lock, [this] { return m_hasPending || m_stopping; });
+            if (!m_hasPending) break;
+
+            m_pending.swap(m_writing);
+            step = m_pendingStep;
+            m_hasPending = false;
+        }
+
+        const std::string path = snapshotPath(step);
+        if (SnapshotFile::write(path, m_writing)) {
+            Logger::getInstance().log(Logger::Level::DEBUG,
+                "Snapshot written: " + path + " (" + std::to_string(m_writing.size()) + " bytes)");
+        } else {
+            Logger::getInstance().log(Logger::Level::ERROR, "Failed to write snapshot " + path);
+        }
+    }
+}
+
+std::string SnapshotWriter::snapshotPath(uint64_t step) const {
+    char filename[64];
+    std::snprintf(filename, sizeof(filename), "snapshot_%010llu.bhs", static_cast<unsigned long long>(step));
+    return (std::filesystem::path(m_directory) / filename).string();
+}
@@ -0,0 +1,83 @@
+/**
+ * @file SnapshotWriter.h
+ * @brief Background thread that writes periodic simulation checkpoints
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../physics/Physics.h"
+#include "../utils/Config.h"
+
+/**
+ * @brief Writes a SnapshotFile every snapshot.interval physics steps without blocking the simulation
+ *
+ * capture() serializes the state into a staging buffer on the calling thread
+ * (a copy of each array) and hands it to the writer thread, which writes
+ * snapshot_<step>.bhs into snapshot.directory. At most one snapshot waits for
+ * the disk; if the previous one is still queued the new one is skipped rather
+ * than stalling the simulation. The staging, pending and writing buffers
+ * rotate and keep their capacity, and encoding writes into them in place, so
+ * steady-state checkpointing does not allocate.
+ */
+class SnapshotWriter {
+public:
+    /**
+     * @brief Read the snapshot settings and start the writer thread
+     * @param config Configuration object (snapshot section)
+     */
+    explicit SnapshotWriter(const Config& config);
+
+    /**
+     * @brief Write the queued snapshot, if any, and join the thread
+     */
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    /**
+     * @brief Check whether a snapshot is due after a step
+     * @param step Step count after the step
+     * @return True every snapshot.interval steps
+     */
+    bool isDue(uint64_t step) const { return m_interval > 0 && step % m_interval == 0; }
+
+    /**
+     * @brief Serialize the current state and queue it for writing
+     * @param physics Physics state (must not be stepped concurrently)
+     */
+    void capture(const Physics& physics);
+
+private:
+    uint64_t m_interval;                    ///< Steps between snapshots (0 disables them)
+    std::string m_directory;                ///< Output directory
+
+    std::thread m_thread;                   ///< Writer thread
+    std::mutex m_mutex;                     ///< Guards the pending buffer
+    std::condition_variable m_ready;        ///< Signals a pending snapshot or stop
+    std::vector<unsigned char> m_staging;   ///< Filled by capture() (caller's thread)
+    std::vector<unsigned char> m_pending;   ///< Queued for the writer thread
+    std::vector<unsigned char> m_writing;   ///< Being written
+    uint64_t m_pendingStep;                 ///< Step of the queued snapshot
+    bool m_hasPending;                      ///< m_pending holds a snapshot
+    bool m_stopping;                        ///< Thread should exit once idle
+
+    /**
+     * @brief Writer thread main loop
+     */
+    void run();
+
+    /**
+     * @brief Build the path of a snapshot
+     * @param step Step the snapshot was taken at
+     * @return Output path
+     */
+    std::string snapshotPath(uint64_t step) const;
+};
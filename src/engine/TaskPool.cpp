@@ -0,0 +1,128 @@
+/**
+ * @file TaskPool.cpp
+ * @brief Implementation of the work-stealing thread pool
+ */
+
+#include "TaskPool.h"
+#include "../utils/Logger.h"
+#include <string>
+
+namespace {
+
+thread_local const TaskPool* t_pool = nullptr;  ///< Pool owning the current thread
+thread_local size_t t_workerIndex = 0;          ///< Worker index within that pool
+
+}
+
+TaskPool::TaskPool(size_t threadCount)
+    : m_queuedTasks(0)
+    , m_stopping(false) {
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Slot threadCount - 1 belongs to the calling thread
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+        m_queues.back()->ring.resize(INITIAL_QUEUE_CAPACITY);
+    }
+
+    for (size_t i = 0; i + 1 < threadCount; ++i) {
+        m_threads.emplace_back(&TaskPool::workerLoop, this, i);
+    }
+
+    Logger::getInstance().log(Logger::Level::INFO,
+        "Task pool started with " + std::to_string(threadCount) + " threads");
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void TaskPool::workerLoop(size_t index) {
+    t_pool = this;
+    t_workerIndex = index;
+
+    while (true) {
+        if (runOneTask(index)) continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this] {
+            return m_stopping || m_queuedTasks.load(std::memory_order_acquire) > 0;
+        });
+        if (m_stopping) return;
+    }
+}
+
+bool TaskPool::runOneTask(size_t index) {
+    Task task;
+    bool found = false;
+
+    // Own queue first (LIFO keeps recently split work cache-hot)
+    {
+        WorkerQueue& own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.count > 0) {
+            --own.count;
+            task = own.ring[(own.head + own.count) & (own.ring.size() - 1)];
+            found = true;
+        }
+    }
+
+    // Steal the oldest task from another participant
+    for (size_t offset = 1; !found && offset < m_queues.size(); ++offset) {
+        WorkerQueue& victim = *m_queues[(index + offset) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.count > 0) {
+            task = victim.ring[victim.head];
+            victim.head = (victim.head + 1) & (victim.ring.size() - 1);
+            --victim.count;
+            found = true;
+        }
+    }
+
+    if (!found) return false;
+
+    m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+    task.invoke(task.context, task.begin, task.end, index);
+    task.remaining->fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void TaskPool::push(size_t index, const Task& task) {
+    {
+        WorkerQueue& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.count == queue.ring.size()) {
+            // Unroll into a ring twice the size; only the largest pass so far pays for this
+            std::vector<Task> grown(queue.ring.size() * 2);
+            for (size_t i = 0; i < queue.count; ++i) {
+                grown[i] = queue.ring[(queue.head + i) & (queue.ring.size() - 1)];
+            }
+            queue.ring.swap(grown);
+            queue.head = 0;
+        }
+        queue.ring[(queue.head + queue.count) & (queue.ring.size() - 1)] = task;
+        ++queue.count;
+    }
+    {
+        // Publish under the sleep mutex so a worker about to wait cannot miss it
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_queuedTasks.fetch_add(1, std::memory_order_release);
+    }
+}
+
+size_t TaskPool::currentWorkerIndex() const {
+    // Threads outside this pool use the caller slot
+    if (t_pool == this) return t_workerIndex;
+    return m_queues.size() - 1;
+}
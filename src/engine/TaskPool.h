@@ -0,0 +1,163 @@
+/**
+ * @file TaskPool.h
+ * @brief Work-stealing thread pool for data-parallel simulation passes
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Reusable pool of worker threads with per-worker task queues
+ *
+ * Each worker owns a ring of tasks; it pops its own work from the back and
+ * steals from the front of other workers' rings when it runs dry. A ring only
+ * grows when a pass queues more chunks than it has ever held, so steady-state
+ * dispatch does not allocate. The thread that calls parallelFor() takes part
+ * in the work as an extra worker, so a pool created with one thread runs
+ * everything inline. Every participant has a stable worker
+ * index in [0, getWorkerCount()), which callers use to address per-thread
+ * accumulation buffers without atomics. Only one thread outside the pool may
+ * call parallelFor() at a time, since all such callers share the caller slot.
+ */
+class TaskPool {
+public:
+    /**
+     * @brief Create the pool
+     * @param threadCount Total number of participating threads including the
+     *                    caller (0 = one per hardware thread)
+     */
+    explicit TaskPool(size_t threadCount = 0);
+
+    /**
+     * @brief Stop and join all worker threads
+     */
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    /**
+     * @brief Get number of participants (worker threads plus the caller)
+     * @return Number of distinct worker indices
+     */
+    size_t getWorkerCount() const { return m_queues.size(); }
+
+    /**
+     * @brief Run a range function over [begin, end) split into chunks
+     *
+     * Blocks until all chunks have completed. The function is invoked as
+     * fn(chunkBegin, chunkEnd, workerIndex).
+     *
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Maximum number of indices per chunk
+     * @param fn Function to invoke for each chunk
+     */
+    template <typename Fn>
+    void parallelFor(size_t begin, size_t end, size_t grain, Fn&& fn);
+
+private:
+    /**
+     * @brief A chunk of a parallelFor call (trivially copyable, no allocation)
+     */
+    struct Task {
+        void (*invoke)(void* context, size_t begin, size_t end, size_t worker);
+        void* context;
+        size_t begin;
+        size_t end;
+        std::atomic<size_t>* remaining;
+    };
+
+    static constexpr size_t INITIAL_QUEUE_CAPACITY = 256;  ///< Ring slots per worker (power of two)
+
+    /**
+     * @brief Double-ended ring of tasks owned by one worker
+     */
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::vector<Task> ring;     ///< Ring storage (power-of-two size, doubled when full)
+        size_t head = 0;            ///< Slot of the oldest task
+        size_t count = 0;           ///< Queued tasks
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;  ///< One queue per participant
+    std::vector<std::thread> m_threads;                   ///< Worker threads
+    std::mutex m_sleepMutex;                              ///< Guards sleeping workers
+    std::condition_variable m_wake;                       ///< Wakes idle workers
+    std::atomic<size_t> m_queuedTasks;                    ///< Tasks currently queued
+    bool m_stopping;                                      ///< Set when shutting down
+
+    /**
+     * @brief Main loop of a worker thread
+     * @param index Worker index
+     */
+    void workerLoop(size_t index);
+
+    /**
+     * @brief Run one task, preferring the worker's own queue and stealing otherwise
+     * @param index Worker index of the calling thread
+     * @return True if a task was run
+     */
+    bool runOneTask(size_t index);
+
+    /**
+     * @brief Queue a task on a worker's ring
+     * @param index Worker index
+     * @param task Task to queue
+     */
+    void push(size_t index, const Task& task);
+
+    /**
+     * @brief Get the worker index of the calling thread
+     * @return Worker index (the caller slot for threads outside the pool)
+     */
+    size_t currentWorkerIndex() const;
+};
+
+template <typename Fn>
+void TaskPool::parallelFor(size_t begin, size_t end, size_t grain, Fn&& fn) {
+    if (end <= begin) return;
+    if (grain == 0) grain = 1;
+
+    using Function = typename std::remove_reference<Fn>::type;
+    const size_t self = currentWorkerIndex();
+    const size_t chunks = (end - begin + grain - 1) / grain;
+
+    // Nothing to share: run inline
+    if (m_threads.empty() || chunks == 1) {
+        fn(begin, end, self);
+        return;
+    }
+
+    std::atomic<size_t> remaining(chunks);
+    Task task;
+    task.invoke = [](void* context, size_t b, size_t e, size_t worker) {
+        (*static_cast<Function*>(context))(b, e, worker);
+    };
+    task.context = const_cast<void*>(static_cast<const void*>(&fn));
+    task.remaining = &remaining;
+
+    // Deal chunks round-robin; stealing evens out the imbalance
+    for (size_t c = 0; c < chunks; ++c) {
+        task.begin = begin + c * grain;
+        task.end = std::min(end, task.begin + grain);
+        push((self + c) % m_queues.size(), task);
+    }
+    m_wake.notify_all();
+
+    // Help out until every chunk of this call has finished
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!runOneTask(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * @file TripleBuffer.h
+ * @brief Lock-free single-producer single-consumer triple buffer
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Hands the latest value from one writer thread to one reader thread
+ *
+ * Three slots rotate between the writer (back), the reader (front) and a shared
+ * middle slot. Publishing swaps the back slot into the middle and marks it
+ * fresh; the reader swaps a fresh middle slot into the front. Neither side
+ * ever blocks or copies, and the reader always sees the newest complete value.
+ *
+ * @tparam T Slot type; slots are reused, so vectors keep their capacity
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    /**
+     * @brief Get the slot the writer fills next
+     * @return Back slot (writer thread only)
+     */
+    T& getWriteBuffer() { return m_buffers[m_writeIndex]; }
+
+    /**
+     * @brief Publish the back slot to the reader
+     */
+    void publish() {
+        uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_writeIndex | FRESH_BIT),
+                                             std::memory_order_acq_rel);
+        m_writeIndex = previous & INDEX_MASK;
+    }
+
+    /**
+     * @brief Take the newest published slot if there is one
+     * @return True if the front slot changed (reader thread only)
+     */
+    bool update() {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH_BIT)) return false;
+
+        uint8_t previous = m_middle.exchange(m_readIndex, std::memory_order_acq_rel);
+        m_readIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Get the slot the reader currently owns
+     * @return Front slot (reader thread only)
+     */
+    const T& getReadBuffer() const { return m_buffers[m_readIndex]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;      ///< Slot index bits of m_middle
+    static constexpr uint8_t FRESH_BIT = 0x4;       ///< Set when the middle slot is unread
+
+    T m_buffers[3];                                 ///< Slot storage
+    uint8_t m_writeIndex = 0;                       ///< Back slot (writer-owned)
+    alignas(64) std::atomic<uint8_t> m_middle{1};   ///< Shared slot index and fresh flag
+    alignas(64) uint8_t m_readIndex = 2;            ///< Front slot (reader-owned)
+};
@@ -21,37 +21,127 @@
 #include <memory>
 #include <chrono>
 #include <exception>
+#include <string>
 
 #include "engine/Engine.h"
 #include "utils/Logger.h"
 #include "utils/Config.h"
+#include "utils/Metrics.h"
 
 using namespace std;
 using namespace std::chrono;
 
+/**
+ * @brief Print command line usage
+ * @param program Executable name
+ */
+static void printUsage(const char* program) {
+    cout << "Usage: " << program << " [options]\n"
+         << "  --config <file>        Configuration file (default: config/simulation.json)\n"
+         << "  --headless             Render offscreen with EGL and write frames to disk\n"
+         << "  --width <pixels>       Headless output width\n"
+         << "  --height <pixels>      Headless output height\n"
+         << "  --frames <count>       Number of headless frames (default: length of camera path)\n"
+         << "  --fps <rate>           Headless frame rate\n"
+         << "  --camera-path <file>   JSON camera keyframes for headless rendering\n"
+         << "  --output <directory>   Directory for headless frames\n"
+         << "  --format <name>        Headless output: png, ppm or ffmpeg\n"
+         << "  --video <file>         Video file written in ffmpeg format\n"
+         << "  --profile <file>       Append per-stage frame timings as JSON lines\n"
+         << "  --trace <file>         Write a Chrome trace-event JSON of CPU scopes\n"
+         << "  --snapshot-every <n>   Write a binary snapshot every n physics steps\n"
+         << "  --restore <file>       Resume from a binary snapshot\n"
+         << "  --help                 Show this message\n";
+}
+
 /**
  * @brief Main application entry point
  * 
  * Initializes all systems and runs the main simulation loop.
  * Includes comprehensive error handling and logging.
  */
-int main() {
+int main(int argc, char* argv[]) {
     try {
+        // Command line options override the configuration file
+        string configFile = "config/simulation.json";
+        Config overrides;
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            
+            if (arg == "--help" || arg == "-h") {
+                printUsage(argv[0]);
+                return EXIT_SUCCESS;
+            } else if (arg == "--headless") {
+                overrides.setBool("headless.enabled", true);
+            } else if (arg == "--config" && hasValue) {
+                configFile = argv[++i];
+            } else if (arg == "--width" && hasValue) {
+                overrides.setInt("headless.width", stoi(argv[++i]));
+            } else if (arg == "--height" && hasValue) {
+                overrides.setInt("headless.height", stoi(argv[++i]));
+            } else if (arg == "--frames" && hasValue) {
+                overrides.setInt("headless.frames", stoi(argv[++i]));
+            } else if (arg == "--fps" && hasValue) {
+                overrides.setFloat("headless.fps", stof(argv[++i]));
+            } else if (arg == "--camera-path" && hasValue) {
+                overrides.setString("headless.cameraPath", argv[++i]);
+            } else if (arg == "--output" && hasValue) {
+                overrides.setString("headless.outputDirectory", argv[++i]);
+            } else if (arg == "--format" && hasValue) {
+                overrides.setString("headless.format", argv[++i]);
+            } else if (arg == "--video" && hasValue) {
+                overrides.setString("headless.format", "ffmpeg");
+                overrides.setString("headless.videoFile", argv[++i]);
+            } else if (arg == "--profile" && hasValue) {
+                overrides.setString("profiler.output", argv[++i]);
+            } else if (arg == "--trace" && hasValue) {
+                overrides.setString("metrics.traceOutput", argv[++i]);
+            } else if (arg == "--snapshot-every" && hasValue) {
+                overrides.setInt("snapshot.interval", stoi(argv[++i]));
+            } else if (arg == "--restore" && hasValue) {
+                overrides.setString("snapshot.restore", argv[++i]);
+            } else {
+                cerr << "Unknown or incomplete option: " << arg << "\n";
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        
         // Initialize logging system
         Logger::getInstance().setLevel(Logger::Level::INFO);
         Logger::getInstance().log(Logger::Level::INFO, "🚀 Starting 3D Black Hole Simulation v2.0.0");
         
         // Load configuration
         Config config;
-        if (!config.loadFromFile("config/simulation.json")) {
+        if (!config.loadFromFile(configFile)) {
             Logger::getInstance().log(Logger::Level::WARNING, 
                 "⚠️  Could not load config file, using defaults");
         }
+        config.merge(overrides);
+        
+        Metrics::getInstance().setThreadName("main");
+        Metrics::getInstance().start(config);
         
         // Create and initialize the engine
         auto engine = make_unique<Engine>(config);
         Logger::getInstance().log(Logger::Level::INFO, "✅ Engine initialized successfully");
         
+        // Offline rendering: produce the frame sequence and exit
+        if (engine->isHeadless()) {
+            bool success = engine->runHeadless();
+            engine.reset();
+            Metrics::getInstance().stop();
+            Logger::getInstance().log(Logger::Level::INFO, 
+                success ? "✅ Headless render finished" : "💥 Headless render failed");
+            return success ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        
+        // Pick up edits to the configuration file while running
+        if (config.getBool("debug.hotReload", false)) {
+            engine->watchConfig(configFile, overrides);
+        }
+        
         // Performance tracking
         auto startTime = high_resolution_clock::now();
         auto lastFrameTime = startTime;
@@ -63,6 +153,9 @@ int main() {
         Logger::getInstance().log(Logger::Level::INFO, "   - Left Mouse: Orbit camera");
         Logger::getInstance().log(Logger::Level::INFO, "   - Scroll: Zoom in/out");
         Logger::getInstance().log(Logger::Level::INFO, "   - G key: Toggle gravity simulation");
+        Logger::getInstance().log(Logger::Level::INFO, "   - T key: Toggle body trails");
+        Logger::getInstance().log(Logger::Level::INFO, "   - F key: Follow next body with the camera");
+        Logger::getInstance().log(Logger::Level::INFO, "   - F3: Toggle frame profiler overlay");
         Logger::getInstance().log(Logger::Level::INFO, "   - ESC: Exit simulation");
         
         // Main simulation loop
@@ -91,6 +184,8 @@ int main() {
             }
         }
         
+        engine.reset();
+        Metrics::getInstance().stop();
         Logger::getInstance().log(Logger::Level::INFO, "✅ Simulation ended gracefully");
         
     } catch (const runtime_error& e) {
@@ -28,49 +28,13 @@ Object::Object(const glm::vec3& position,
     , m_color(color)
     , m_name(name)
     , m_type(type)
-    , m_active(true)
-    , m_forceSum(0.0f)
-    , m_maxHistorySize(100) {
-    
-    m_positionHistory.reserve(m_maxHistorySize);
-    m_positionHistory.push_back(position);
+    , m_active(true) {
     
     Logger::getInstance().log(Logger::Level::DEBUG, 
         "Object '" + m_name + "' created at position (" + 
         std::to_string(position.x) + ", " + std::to_string(position.y) + ", " + std::to_string(position.z) + ")");
 }
 
-void Object::updatePhysics(float deltaTime) {
-    if (!m_active || deltaTime <= 0.0f) return;
-    
-    // Calculate acceleration from accumulated forces (F = ma, so a = F/m)
-    if (m_mass > 0.0) {
-        m_acceleration = m_forceSum / static_cast<float>(m_mass);
-    } else {
-        m_acceleration = glm::vec3(0.0f);  // Massless objects don't accelerate
-    }
-    
-    // Integrate velocity (v = v₀ + at)
-    m_velocity += m_acceleration * deltaTime;
-    
-    // Integrate position (x = x₀ + vt)
-    m_position += m_velocity * deltaTime;
-    
-    // Update position history for trails
-    updateHistory();
-    
-    // Reset forces for next frame
-    resetForces();
-}
-
-void Object::applyForce(const glm::vec3& force) {
-    m_forceSum += force;
-}
-
-void Object::resetForces() {
-    m_forceSum = glm::vec3(0.0f);
-}
-
 double Object::getDistanceTo(const Object& other) const {
     glm::vec3 displacement = other.m_position - m_position;
     return static_cast<double>(glm::length(displacement));
@@ -182,13 +146,4 @@ Object Object::fromConfig(const std::vector<double>& position,
     }
     
     return Object(pos, vel, mass, radius, col, name);
-}
-
-void Object::updateHistory() {
-    m_positionHistory.push_back(m_position);
-    
-    // Limit history size to prevent memory growth
-    if (m_positionHistory.size() > m_maxHistorySize) {
-        m_positionHistory.erase(m_positionHistory.begin());
-    }
 }
\ No newline at end of file
@@ -72,23 +72,6 @@ public:
     void setType(Type type) { m_type = type; }
     void setActive(bool active) { m_active = active; }
     
-    /**
-     * @brief Update object physics (integrate motion)
-     * @param deltaTime Time step in seconds
-     */
-    void updatePhysics(float deltaTime);
-    
-    /**
-     * @brief Apply a force to the object
-     * @param force Force vector in Newtons
-     */
-    void applyForce(const glm::vec3& force);
-    
-    /**
-     * @brief Reset accumulated forces (call after integration)
-     */
-    void resetForces();
-    
     /**
      * @brief Get distance to another object
      * @param other Other object
@@ -156,14 +139,4 @@ private:
     
     // State
     bool m_active;              ///< Is object active in simulation?
-    glm::vec3 m_forceSum;       ///< Accumulated forces for this frame
-    
-    // History tracking (for trails, etc.)
-    std::vector<glm::vec3> m_positionHistory;  ///< Recent positions
-    size_t m_maxHistorySize;                   ///< Maximum history entries
-    
-    /**
-     * @brief Update position history
-     */
-    void updateHistory();
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+/**
+ * @file BodyHandle.h
+ * @brief Generational handle referring to one body across removals
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Stable reference to a body in a ParticleStore
+ *
+ * Dense body indices change whenever a body is removed, so anything that
+ * keeps a reference to a body between steps (the camera follow target, for
+ * example) holds a handle instead. The index names a slot in the store's
+ * handle table; the generation is bumped every time that slot is freed, so a
+ * handle to a removed body never resolves to the body that later reuses the
+ * slot.
+ */
+struct BodyHandle {
+    static constexpr uint32_t INVALID_INDEX = ~uint32_t(0);
+
+    uint32_t index = INVALID_INDEX;     ///< Slot in the handle table
+    uint32_t generation = 0;            ///< Slot generation the handle was issued at
+
+    /**
+     * @brief Check whether the handle was ever assigned (not whether the body still exists)
+     * @return True unless default constructed
+     */
+    bool isSet() const { return index != INVALID_INDEX; }
+
+    bool operator==(const BodyHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const BodyHandle& other) const { return !(*this == other); }
+};
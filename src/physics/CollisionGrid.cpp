@@ -0,0 +1,113 @@
+/**
+ * @file CollisionGrid.cpp
+ * @brief Implementation of the Morton-sorted collision grid
+ */
+
+#include "CollisionGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Spread the low 21 bits of a value so two zero bits follow each one
+ */
+inline uint64_t spreadBits(uint64_t value) {
+    value &= 0x1fffff;
+    value = (value | value << 32) & 0x1f00000000ffffull;
+    value = (value | value << 16) & 0x1f0000ff0000ffull;
+    value = (value | value << 8) & 0x100f00f00f00f00full;
+    value = (value | value << 4) & 0x10c30c30c30c30c3ull;
+    value = (value | value << 2) & 0x1249249249249249ull;
+    return value;
+}
+
+}
+
+void CollisionGrid::build(const std::vector<glm::vec3>& positions,
+                          const std::vector<float>& radii,
+                          const std::vector<uint8_t>& active) {
+    m_positions = &positions;
+    m_entries.clear();
+
+    glm::vec3 minBound(0.0f), maxBound(0.0f);
+    float maxRadius = 0.0f;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (!active[i]) continue;
+
+        if (m_entries.empty()) {
+            minBound = maxBound = positions[i];
+        } else {
+            minBound = glm::min(minBound, positions[i]);
+            maxBound = glm::max(maxBound, positions[i]);
+        }
+        maxRadius = std::max(maxRadius, radii[i]);
+        m_entries.push_back({0, static_cast<uint32_t>(i)});
+    }
+
+    if (m_entries.empty()) return;
+
+    // Touching bodies are at most 2 * maxRadius apart; coarser cells only when the extent needs more than 21 bits
+    glm::dvec3 extent = glm::dvec3(maxBound) - glm::dvec3(minBound);
+    double largest = std::max(extent.x, std::max(extent.y, extent.z));
+    double cellSize = std::max(2.0 * static_cast<double>(maxRadius), largest / MAX_CELL);
+    if (cellSize <= 0.0) cellSize = 1.0;
+
+    m_origin = glm::dvec3(minBound);
+    m_inverseCellSize = 1.0 / cellSize;
+
+    for (Entry& entry : m_entries) {
+        entry.code = encode(cellOf(positions[entry.index]));
+    }
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) {
+        return a.code != b.code ? a.code < b.code : a.index < b.index;
+    });
+}
+
+void CollisionGrid::findContacts(size_t begin, size_t end, const std::vector<float>& radii,
+                                 std::vector<Contact>& contacts) const {
+    const auto& positions = *m_positions;
+
+    for (size_t e = begin; e < end; ++e) {
+        const uint32_t i = m_entries[e].index;
+        const glm::uvec3 cell = cellOf(positions[i]);
+
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    // Unsigned wrap turns -1 into a value above MAX_CELL
+                    const glm::uvec3 neighbour(cell.x + dx, cell.y + dy, cell.z + dz);
+                    if (neighbour.x > MAX_CELL || neighbour.y > MAX_CELL || neighbour.z > MAX_CELL) continue;
+
+                    const uint64_t code = encode(neighbour);
+                    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), code,
+                        [](const Entry& entry, uint64_t value) { return entry.code < value; });
+
+                    for (; it != m_entries.end() && it->code == code; ++it) {
+                        const uint32_t j = it->index;
+                        if (j <= i) continue;
+
+                        // Same test and operand order as the all-pairs sweep, so results are unchanged
+                        double distance = glm::length(positions[j] - positions[i]);
+                        double combinedRadii = static_cast<double>(radii[i] + radii[j]);
+                        if (distance <= combinedRadii) {
+                            contacts.emplace_back(i, j);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+glm::uvec3 CollisionGrid::cellOf(const glm::vec3& position) const {
+    glm::dvec3 scaled = (glm::dvec3(position) - m_origin) * m_inverseCellSize;
+    return glm::uvec3(
+        static_cast<uint32_t>(std::clamp(scaled.x, 0.0, static_cast<double>(MAX_CELL))),
+        static_cast<uint32_t>(std::clamp(scaled.y, 0.0, static_cast<double>(MAX_CELL))),
+        static_cast<uint32_t>(std::clamp(scaled.z, 0.0, static_cast<double>(MAX_CELL))));
+}
+
+uint64_t CollisionGrid::encode(const glm::uvec3& cell) {
+    return spreadBits(cell.x) | spreadBits(cell.y) << 1 | spreadBits(cell.z) << 2;
+}
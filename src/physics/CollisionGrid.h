@@ -0,0 +1,89 @@
+/**
+ * @file CollisionGrid.h
+ * @brief Morton-sorted uniform grid used as the collision broad phase
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Uniform grid over the active bodies, stored as a sorted list of Morton codes
+ *
+ * The cell edge is at least twice the largest body radius, so two bodies can
+ * only touch if their cells are equal or adjacent. Bodies are sorted by the
+ * Morton code of their cell (ties by index), which keeps each cell contiguous and
+ * neighbouring cells close in memory; a neighbour cell is found with a binary
+ * search. The grid is rebuilt from scratch every step and holds no cells that
+ * have no bodies, so memory is O(N) however large the system is.
+ */
+class CollisionGrid {
+public:
+    /**
+     * @brief Body pair (lower index first)
+     */
+    using Contact = std::pair<uint32_t, uint32_t>;
+
+    /**
+     * @brief Rebuild the grid from body state
+     * @param positions Body positions
+     * @param radii Body radii
+     * @param active Active flags (inactive bodies are skipped)
+     */
+    void build(const std::vector<glm::vec3>& positions,
+               const std::vector<float>& radii,
+               const std::vector<uint8_t>& active);
+
+    /**
+     * @brief Find overlapping pairs for a range of grid entries
+     *
+     * Each pair is reported once, by the entry of its lower index, so disjoint
+     * ranges can be searched in parallel.
+     * @param begin First entry (in grid order)
+     * @param end One past the last entry
+     * @param radii Body radii the grid was built with
+     * @param contacts Receives overlapping pairs
+     */
+    void findContacts(size_t begin, size_t end, const std::vector<float>& radii,
+                      std::vector<Contact>& contacts) const;
+
+    /**
+     * @brief Get the number of bodies in the grid
+     * @return Active bodies at the last build
+     */
+    size_t size() const { return m_entries.size(); }
+
+private:
+    /**
+     * @brief One body and the Morton code of its cell
+     */
+    struct Entry {
+        uint64_t code;      ///< Interleaved cell coordinates
+        uint32_t index;     ///< Dense body index
+    };
+
+    static constexpr uint32_t MAX_CELL = (1u << 21) - 1;   ///< Largest coordinate per axis
+
+    std::vector<Entry> m_entries;                           ///< Bodies sorted by (code, index)
+    const std::vector<glm::vec3>* m_positions = nullptr;    ///< Positions the grid was built from
+    glm::dvec3 m_origin{0.0};                               ///< Corner of cell (0, 0, 0)
+    double m_inverseCellSize = 1.0;                         ///< Cells per meter
+
+    /**
+     * @brief Get the cell coordinates of a point
+     * @param position Point inside the grid bounds
+     * @return Cell coordinates in [0, MAX_CELL]
+     */
+    glm::uvec3 cellOf(const glm::vec3& position) const;
+
+    /**
+     * @brief Interleave three 21-bit cell coordinates
+     * @param cell Cell coordinates
+     * @return Morton code
+     */
+    static uint64_t encode(const glm::uvec3& cell);
+};
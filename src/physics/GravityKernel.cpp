@@ -0,0 +1,233 @@
+/**
+ * @file GravityKernel.cpp
+ * @brief Scalar, AVX2 and NEON implementations of the pairwise gravity kernel
+ */
+
+#include "GravityKernel.h"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GRAVITY_KERNEL_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#define GRAVITY_KERNEL_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+/// Signature shared by all kernel implementations
+using KernelFn = void (*)(const float* x, const float* y, const float* z, const float* strength,
+                          size_t count, float px, float py, float pz, float softeningSquared,
+                          float* out);
+
+/**
+ * @brief Accumulate a run of sources one at a time
+ *
+ * Also used for the tails left over by the vector kernels. The strength is
+ * multiplied by 1/r before 1/r² so far-away sources do not underflow float.
+ */
+void accumulateScalar(const float* x, const float* y, const float* z, const float* strength,
+                      size_t count, float px, float py, float pz, float softeningSquared,
+                      float* out) {
+    float ax = 0.0f, ay = 0.0f, az = 0.0f;
+
+    for (size_t j = 0; j < count; ++j) {
+        float dx = x[j] - px;
+        float dy = y[j] - py;
+        float dz = z[j] - pz;
+        float distSquared = dx * dx + dy * dy + dz * dz + softeningSquared;
+        if (distSquared <= 0.0f) continue;
+
+        float invDist = 1.0f / std::sqrt(distSquared);
+        float scale = strength[j] * invDist * (invDist * invDist);
+        ax += dx * scale;
+        ay += dy * scale;
+        az += dz * scale;
+    }
+
+    out[0] += ax;
+    out[1] += ay;
+    out[2] += az;
+}
+
+#if defined(GRAVITY_KERNEL_X86)
+
+/**
+ * @brief Sum the eight lanes of an AVX register
+ */
+__attribute__((target("avx2,fma")))
+inline float horizontalSum(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    return _mm_cvtss_f32(sum);
+}
+
+/**
+ * @brief Eight interactions per iteration with AVX2 + FMA
+ */
+__attribute__((target("avx2,fma")))
+void accumulateAvx2(const float* x, const float* y, const float* z, const float* strength,
+                    size_t count, float px, float py, float pz, float softeningSquared,
+                    float* out) {
+    const __m256 targetX = _mm256_set1_ps(px);
+    const __m256 targetY = _mm256_set1_ps(py);
+    const __m256 targetZ = _mm256_set1_ps(pz);
+    const __m256 eps2 = _mm256_set1_ps(softeningSquared);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 threeHalves = _mm256_set1_ps(1.5f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    __m256 ax = zero, ay = zero, az = zero;
+
+    size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + j), targetX);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + j), targetY);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + j), targetZ);
+
+        __m256 distSquared = _mm256_fmadd_ps(dx, dx, eps2);
+        distSquared = _mm256_fmadd_ps(dy, dy, distSquared);
+        distSquared = _mm256_fmadd_ps(dz, dz, distSquared);
+
+        // 12-bit estimate refined by one Newton step: y' = y (1.5 - 0.5 x y²)
+        __m256 invDist = _mm256_rsqrt_ps(distSquared);
+        __m256 halfX = _mm256_mul_ps(half, distSquared);
+        invDist = _mm256_mul_ps(invDist,
+            _mm256_fnmadd_ps(halfX, _mm256_mul_ps(invDist, invDist), threeHalves));
+
+        // Coincident sources (including the target itself) contribute nothing
+        invDist = _mm256_and_ps(invDist, _mm256_cmp_ps(distSquared, zero, _CMP_GT_OQ));
+
+        __m256 scale = _mm256_mul_ps(_mm256_loadu_ps(strength + j), invDist);
+        scale = _mm256_mul_ps(scale, _mm256_mul_ps(invDist, invDist));
+
+        ax = _mm256_fmadd_ps(dx, scale, ax);
+        ay = _mm256_fmadd_ps(dy, scale, ay);
+        az = _mm256_fmadd_ps(dz, scale, az);
+    }
+
+    out[0] += horizontalSum(ax);
+    out[1] += horizontalSum(ay);
+    out[2] += horizontalSum(az);
+
+    accumulateScalar(x + j, y + j, z + j, strength + j, count - j,
+                     px, py, pz, softeningSquared, out);
+}
+
+#endif
+
+#if defined(GRAVITY_KERNEL_NEON)
+
+/**
+ * @brief Four interactions per iteration with NEON
+ */
+void accumulateNeon(const float* x, const float* y, const float* z, const float* strength,
+                    size_t count, float px, float py, float pz, float softeningSquared,
+                    float* out) {
+    const float32x4_t targetX = vdupq_n_f32(px);
+    const float32x4_t targetY = vdupq_n_f32(py);
+    const float32x4_t targetZ = vdupq_n_f32(pz);
+    const float32x4_t eps2 = vdupq_n_f32(softeningSquared);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+
+    float32x4_t ax = zero, ay = zero, az = zero;
+
+    size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        float32x4_t dx = vsubq_f32(vld1q_f32(x + j), targetX);
+        float32x4_t dy = vsubq_f32(vld1q_f32(y + j), targetY);
+        float32x4_t dz = vsubq_f32(vld1q_f32(z + j), targetZ);
+
+        float32x4_t distSquared = vfmaq_f32(eps2, dx, dx);
+        distSquared = vfmaq_f32(distSquared, dy, dy);
+        distSquared = vfmaq_f32(distSquared, dz, dz);
+
+        // The NEON estimate has 8 bits, so two Newton steps are needed
+        float32x4_t invDist = vrsqrteq_f32(distSquared);
+        invDist = vmulq_f32(invDist, vrsqrtsq_f32(vmulq_f32(distSquared, invDist), invDist));
+        invDist = vmulq_f32(invDist, vrsqrtsq_f32(vmulq_f32(distSquared, invDist), invDist));
+
+        // Coincident sources (including the target itself) contribute nothing
+        uint32x4_t mask = vcgtq_f32(distSquared, zero);
+        invDist = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(invDist), mask));
+
+        float32x4_t scale = vmulq_f32(vld1q_f32(strength + j), invDist);
+        scale = vmulq_f32(scale, vmulq_f32(invDist, invDist));
+
+        ax = vfmaq_f32(ax, dx, scale);
+        ay = vfmaq_f32(ay, dy, scale);
+        az = vfmaq_f32(az, dz, scale);
+    }
+
+    out[0] += vaddvq_f32(ax);
+    out[1] += vaddvq_f32(ay);
+    out[2] += vaddvq_f32(az);
+
+    accumulateScalar(x + j, y + j, z + j, strength + j, count - j,
+                     px, py, pz, softeningSquared, out);
+}
+
+#endif
+
+/**
+ * @brief Pick the widest instruction set the CPU supports
+ */
+GravityKernel::Isa detectIsa() {
+#if defined(GRAVITY_KERNEL_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return GravityKernel::Isa::AVX2;
+    }
+#elif defined(GRAVITY_KERNEL_NEON)
+    // NEON is mandatory on ARMv8-A
+    return GravityKernel::Isa::NEON;
+#endif
+    return GravityKernel::Isa::SCALAR;
+}
+
+/**
+ * @brief Map an instruction set to its implementation
+ */
+KernelFn selectKernel(GravityKernel::Isa isa) {
+    switch (isa) {
+#if defined(GRAVITY_KERNEL_X86)
+        case GravityKernel::Isa::AVX2: return accumulateAvx2;
+#endif
+#if defined(GRAVITY_KERNEL_NEON)
+        case GravityKernel::Isa::NEON: return accumulateNeon;
+#endif
+        default: return accumulateScalar;
+    }
+}
+
+const GravityKernel::Isa s_isa = detectIsa();         ///< Instruction set chosen at startup
+const KernelFn s_kernel = selectKernel(s_isa);        ///< Matching implementation
+
+}
+
+void GravityKernel::accumulate(const GravitySources& sources, size_t begin, size_t end,
+                               const glm::vec3& target, float softeningSquared,
+                               glm::vec3& acceleration) {
+    if (end <= begin) return;
+
+    float out[3] = {acceleration.x, acceleration.y, acceleration.z};
+    s_kernel(sources.x.data() + begin, sources.y.data() + begin, sources.z.data() + begin,
+             sources.strength.data() + begin, end - begin,
+             target.x, target.y, target.z, softeningSquared, out);
+    acceleration = glm::vec3(out[0], out[1], out[2]);
+}
+
+GravityKernel::Isa GravityKernel::getIsa() {
+    return s_isa;
+}
+
+const char* GravityKernel::isaToString(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR: return "scalar";
+        case Isa::AVX2: return "AVX2";
+        case Isa::NEON: return "NEON";
+        default: return "unknown";
+    }
+}
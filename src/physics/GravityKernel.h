@@ -0,0 +1,102 @@
+/**
+ * @file GravityKernel.h
+ * @brief Vectorized pairwise gravity kernel with runtime instruction set dispatch
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Packed structure-of-arrays gravity sources
+ *
+ * Each source is a position and a strength (G·m for the direct solver, plain
+ * mass for the octree). Inactive bodies are packed with zero strength so that
+ * indices stay aligned with the particle store.
+ */
+struct GravitySources {
+    std::vector<float> x;           ///< Source x coordinates
+    std::vector<float> y;           ///< Source y coordinates
+    std::vector<float> z;           ///< Source z coordinates
+    std::vector<float> strength;    ///< Source strengths
+
+    /**
+     * @brief Resize all arrays
+     * @param count Number of sources
+     */
+    void resize(size_t count) {
+        x.resize(count);
+        y.resize(count);
+        z.resize(count);
+        strength.resize(count);
+    }
+
+    /**
+     * @brief Store a source
+     * @param index Source index
+     * @param position Source position
+     * @param value Source strength
+     */
+    void set(size_t index, const glm::vec3& position, float value) {
+        x[index] = position.x;
+        y[index] = position.y;
+        z[index] = position.z;
+        strength[index] = value;
+    }
+
+    /**
+     * @brief Get number of sources
+     * @return Source count
+     */
+    size_t size() const { return x.size(); }
+};
+
+/**
+ * @brief Inner loop of all pairwise gravity evaluations
+ *
+ * Sums strength * r / (|r|² + ε²)^(3/2) over a contiguous range of sources
+ * using a reciprocal square root refined by one Newton step. Sources that
+ * coincide with the target (zero softened distance) contribute nothing, so a
+ * body may be included in its own source range. The widest instruction set
+ * supported by the CPU (AVX2+FMA with 8 lanes, NEON with 4 lanes, or scalar)
+ * is selected once on first use.
+ */
+class GravityKernel {
+public:
+    /**
+     * @brief Instruction sets the kernel can run on
+     */
+    enum class Isa {
+        SCALAR,     ///< Portable scalar loop
+        AVX2,       ///< x86-64 AVX2 + FMA, 8 interactions per instruction
+        NEON        ///< ARMv8 NEON, 4 interactions per instruction
+    };
+
+    /**
+     * @brief Accumulate the field of sources [begin, end) at a target point
+     * @param sources Packed sources
+     * @param begin First source index
+     * @param end One past the last source index
+     * @param target Evaluation point
+     * @param softeningSquared Squared softening length ε²
+     * @param acceleration Acceleration to add to
+     */
+    static void accumulate(const GravitySources& sources, size_t begin, size_t end,
+                           const glm::vec3& target, float softeningSquared,
+                           glm::vec3& acceleration);
+
+    /**
+     * @brief Get the instruction set selected for this CPU
+     * @return Active instruction set
+     */
+    static Isa getIsa();
+
+    /**
+     * @brief Get string representation of an instruction set
+     * @param isa Instruction set
+     * @return Name as string
+     */
+    static const char* isaToString(Isa isa);
+};
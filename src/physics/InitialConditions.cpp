@@ -0,0 +1,398 @@
+/**
+ * @file InitialConditions.cpp
+ * @brief Implementation of the bulk initial-condition sources
+ */
+
+#include "InitialConditions.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string_view>
+
+namespace {
+
+/// Bodies per generator chunk; fixed so results do not depend on the thread count
+constexpr size_t GENERATOR_CHUNK = 16384;
+
+/// Bytes of CSV read per block
+constexpr size_t CSV_BLOCK_SIZE = 8u << 20;
+
+/// Smallest CSV range handed to one parse task
+constexpr size_t CSV_MIN_RANGE = 64u << 10;
+
+constexpr double TWO_PI = 6.283185307179586;
+
+/**
+ * @brief CSV columns the loader understands
+ */
+enum Column { X, Y, Z, VX, VY, VZ, MASS, RADIUS, RED, GREEN, BLUE, ALPHA, NAME, COLUMN_COUNT };
+
+constexpr const char* COLUMN_NAMES[COLUMN_COUNT] = {
+    "x", "y", "z", "vx", "vy", "vz", "mass", "radius", "r", "g", "b", "a", "name"
+};
+
+/**
+ * @brief Mapping from field position to column, read from the header line
+ */
+struct CsvLayout {
+    std::vector<int> columnOf;          ///< Column of each field, -1 if ignored
+    bool present[COLUMN_COUNT] = {};    ///< Column appears in the header
+};
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+    return text;
+}
+
+/**
+ * @brief Skip blank and comment lines
+ */
+bool isDataLine(std::string_view line) {
+    line = trim(line);
+    return !line.empty() && line.front() != '#';
+}
+
+bool parseHeader(std::string_view line, CsvLayout& layout, std::string& error) {
+    size_t start = 0;
+    while (start <= line.size()) {
+        size_t comma = line.find(',', start);
+        if (comma == std::string_view::npos) comma = line.size();
+        const std::string_view field = trim(line.substr(start, comma - start));
+
+        int column = -1;
+        for (int c = 0; c < COLUMN_COUNT; ++c) {
+            if (field == COLUMN_NAMES[c]) {
+                column = c;
+                layout.present[c] = true;
+                break;
+            }
+        }
+        layout.columnOf.push_back(column);
+        start = comma + 1;
+    }
+
+    for (int c : {X, Y, Z, MASS}) {
+        if (!layout.present[c]) {
+            error = std::string("missing required column '") + COLUMN_NAMES[c] + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Parse the complete lines in [begin, end) onto the end of a block
+ * @return Pointer to the first malformed line, or null if all parsed
+ */
+const char* parseRows(const char* begin, const char* end, const CsvLayout& layout,
+                      float defaultRadius, InitialConditions::Bodies& out) {
+    const size_t fieldCount = layout.columnOf.size();
+
+    while (begin < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+        if (!lineEnd) lineEnd = end;
+        const std::string_view line(begin, static_cast<size_t>(lineEnd - begin));
+        const char* lineStart = begin;
+        begin = lineEnd < end ? lineEnd + 1 : end;
+
+        if (!isDataLine(line)) continue;
+
+        double values[COLUMN_COUNT] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, defaultRadius, 1.0, 1.0, 1.0, 1.0, 0.0};
+        std::string_view name;
+        bool seen[COLUMN_COUNT] = {};
+
+        size_t start = 0;
+        for (size_t f = 0; f < fieldCount && start <= line.size(); ++f) {
+            size_t comma = line.find(',', start);
+            if (comma == std::string_view::npos) comma = line.size();
+            const std::string_view field = trim(line.substr(start, comma - start));
+            start = comma + 1;
+
+            const int column = layout.columnOf[f];
+            if (column < 0) continue;
+            seen[column] = true;
+
+            if (column == NAME) {
+                name = field;
+                continue;
+            }
+            // from_chars is locale independent and does not allocate
+            auto result = std::from_chars(field.data(), field.data() + field.size(), values[column]);
+            if (result.ec != std::errc() || result.ptr != field.data() + field.size()) {
+                return lineStart;
+            }
+        }
+        if (!seen[X] || !seen[Y] || !seen[Z] || !seen[MASS]) {
+            return lineStart;
+        }
+
+        out.positions.emplace_back(values[X], values[Y], values[Z]);
+        out.velocities.emplace_back(values[VX], values[VY], values[VZ]);
+        out.masses.push_back(values[MASS]);
+        out.radii.push_back(static_cast<float>(values[RADIUS]));
+        out.colors.emplace_back(values[RED], values[GREEN], values[BLUE], values[ALPHA]);
+        if (layout.present[NAME]) {
+            out.names.emplace_back(name);
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Independent random stream for one generator chunk
+ */
+std::mt19937_64 chunkGenerator(uint64_t seed, size_t chunk) {
+    std::seed_seq sequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                           static_cast<uint32_t>(chunk), static_cast<uint32_t>(chunk >> 32)};
+    return std::mt19937_64(sequence);
+}
+
+/**
+ * @brief Uniformly distributed unit vector
+ */
+glm::dvec3 randomDirection(std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double cosTheta = 2.0 * uniform(rng) - 1.0;
+    const double sinTheta = std::sqrt(std::max(0.0, 1.0 - cosTheta * cosTheta));
+    const double phi = TWO_PI * uniform(rng);
+    return glm::dvec3(sinTheta * std::cos(phi), cosTheta, sinTheta * std::sin(phi));
+}
+
+}
+
+void InitialConditions::Bodies::resize(size_t count) {
+    positions.resize(count);
+    velocities.resize(count);
+    masses.resize(count);
+    radii.resize(count);
+    colors.resize(count);
+}
+
+void InitialConditions::Bodies::append(Bodies& other) {
+    positions.insert(positions.end(), other.positions.begin(), other.positions.end());
+    velocities.insert(velocities.end(), other.velocities.begin(), other.velocities.end());
+    masses.insert(masses.end(), other.masses.begin(), other.masses.end());
+    radii.insert(radii.end(), other.radii.begin(), other.radii.end());
+    colors.insert(colors.end(), other.colors.begin(), other.colors.end());
+    names.insert(names.end(), std::make_move_iterator(other.names.begin()), std::make_move_iterator(other.names.end()));
+
+    // Cleared rather than released so a reused staging block keeps its capacity
+    other.positions.clear();
+    other.velocities.clear();
+    other.masses.clear();
+    other.radii.clear();
+    other.colors.clear();
+    other.names.clear();
+}
+
+bool InitialConditions::loadCsv(const std::string& path, float defaultRadius, TaskPool& pool,
+                                Bodies& out, std::string& error) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "cannot open file";
+        return false;
+    }
+
+    CsvLayout layout;
+    bool haveHeader = false;
+    std::vector<char> buffer(CSV_BLOCK_SIZE);
+    std::vector<Bodies> parts;
+    size_t carried = 0;         // Bytes of an unfinished line kept at the front of the buffer
+    size_t blockOffset = 0;     // File offset of buffer[0]
+    bool ok = true;
+
+    while (ok) {
+        if (carried == buffer.size()) buffer.resize(buffer.size() * 2);   // Line longer than a block
+        const size_t read = std::fread(buffer.data() + carried, 1, buffer.size() - carried, file);
+        const size_t filled = carried + read;
+        const bool atEnd = read == 0;
+        if (filled == 0) break;
+
+        // Only complete lines are parsed; the tail waits for the next block unless the file ended
+        const char* data = buffer.data();
+        size_t complete = filled;
+        if (!atEnd) {
+            const char* lastNewline = nullptr;
+            for (size_t i = filled; i > 0; --i) {
+                if (data[i - 1] == '\n') {
+                    lastNewline = data + i - 1;
+                    break;
+                }
+            }
+            if (!lastNewline) {
+                carried = filled;
+                continue;
+            }
+            complete = static_cast<size_t>(lastNewline - data) + 1;
+        }
+
+        size_t start = 0;
+        while (!haveHeader && start < complete) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(data + start, '\n', complete - start));
+            const size_t length = lineEnd ? static_cast<size_t>(lineEnd - (data + start)) : complete - start;
+            const std::string_view line(data + start, length);
+            start += length + 1;
+            if (!isDataLine(line)) continue;
+
+            if (!parseHeader(trim(line), layout, error)) {
+                ok = false;
+            }
+            haveHeader = true;
+        }
+        start = std::min(start, complete);
+
+        if (ok && start < complete) {
+            // Split the block at line boundaries; ranges are parsed in parallel and appended in order
+            const size_t rangeCount = std::clamp<size_t>((complete - start) / CSV_MIN_RANGE, 1, pool.getWorkerCount() * 4);
+            std::vector<size_t> bounds(rangeCount + 1, complete);
+            bounds[0] = start;
+            for (size_t r = 1; r < rangeCount; ++r) {
+                size_t split = std::max(bounds[r - 1], start + (complete - start) * r / rangeCount);
+                const void* newline = std::memchr(data + split, '\n', complete - split);
+                bounds[r] = newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) + 1 : complete;
+            }
+
+            parts.resize(rangeCount);
+            std::vector<const char*> failures(rangeCount, nullptr);
+            pool.parallelFor(0, rangeCount, 1, [&](size_t begin, size_t end, size_t) {
+                for (size_t r = begin; r < end; ++r) {
+                    failures[r] = parseRows(data + bounds[r], data + bounds[r + 1], layout, defaultRadius, parts[r]);
+                }
+            });
+
+            for (size_t r = 0; r < rangeCount; ++r) {
+                if (failures[r]) {
+                    error = "malformed row at byte " + std::to_string(blockOffset + static_cast<size_t>(failures[r] - data));
+                    ok = false;
+                    break;
+                }
+                out.append(parts[r]);
+            }
+        }
+
+        if (atEnd) break;
+        carried = filled - complete;
+        std::memmove(buffer.data(), buffer.data() + complete, carried);
+        blockOffset += complete;
+    }
+
+    if (ok && std::ferror(file)) {
+        error = "read error";
+        ok = false;
+    }
+    std::fclose(file);
+
+    if (ok && !haveHeader) {
+        error = "file has no header line";
+        ok = false;
+    }
+    if (ok && !out.names.empty() && out.names.size() != out.size()) {
+        error = "inconsistent name column";
+        ok = false;
+    }
+    return ok;
+}
+
+void InitialConditions::generatePlummer(const PlummerParams& params, double gravityConstant,
+                                        TaskPool& pool, Bodies& out) {
+    const size_t first = out.size();
+    const size_t count = params.count;
+    out.resize(first + count);
+    if (count == 0) return;
+
+    const double a = params.scaleRadius;
+    const double bodyMass = params.totalMass / static_cast<double>(count);
+    const glm::vec4 color(1.0f, 0.9f, 0.7f, 1.0f);
+    const size_t chunks = (count + GENERATOR_CHUNK - 1) / GENERATOR_CHUNK;
+
+    pool.parallelFor(0, chunks, 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t chunk = begin; chunk < end; ++chunk) {
+            std::mt19937_64 rng = chunkGenerator(params.seed, chunk);
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+            const size_t chunkEnd = std::min(count, (chunk + 1) * GENERATOR_CHUNK);
+            for (size_t i = chunk * GENERATOR_CHUNK; i < chunkEnd; ++i) {
+                // Radius from the inverted cumulative mass M(r)/M = r³ / (r² + a²)^(3/2)
+                double r;
+                do {
+                    const double fraction = std::max(uniform(rng), 1e-12);
+                    r = a / std::sqrt(std::pow(fraction, -2.0 / 3.0) - 1.0);
+                } while (r > 20.0 * a);
+
+                // Speed as a fraction q of escape speed, with density q²(1 - q²)^(7/2)
+                double q, y;
+                do {
+                    q = uniform(rng);
+                    y = 0.1 * uniform(rng);
+                } while (y > q * q * std::pow(1.0 - q * q, 3.5));
+                const double escapeSpeed = std::sqrt(2.0 * gravityConstant * params.totalMass) /
+                                           std::pow(r * r + a * a, 0.25);
+
+                const size_t index = first + i;
+                out.positions[index] = glm::vec3(randomDirection(rng) * r);
+                out.velocities[index] = glm::vec3(randomDirection(rng) * (q * escapeSpeed));
+                out.masses[index] = bodyMass;
+                out.radii[index] = params.bodyRadius;
+                out.colors[index] = color;
+            }
+        }
+    });
+
+    // Sampling noise leaves a small net offset and drift; remove it before placing the sphere
+    glm::dvec3 meanPosition(0.0), meanVelocity(0.0);
+    for (size_t i = first; i < first + count; ++i) {
+        meanPosition += glm::dvec3(out.positions[i]);
+        meanVelocity += glm::dvec3(out.velocities[i]);
+    }
+    const glm::vec3 positionShift = glm::vec3(glm::dvec3(params.center) - meanPosition / static_cast<double>(count));
+    const glm::vec3 velocityShift = glm::vec3(glm::dvec3(params.bulkVelocity) - meanVelocity / static_cast<double>(count));
+
+    pool.parallelFor(first, first + count, GENERATOR_CHUNK, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            out.positions[i] += positionShift;
+            out.velocities[i] += velocityShift;
+        }
+    });
+}
+
+void InitialConditions::generateDisk(const DiskParams& params, const glm::vec3& blackHolePosition,
+                                     double blackHoleMass, double gravityConstant,
+                                     TaskPool& pool, Bodies& out) {
+    const size_t first = out.size();
+    const size_t count = params.count;
+    out.resize(first + count);
+    if (count == 0) return;
+
+    const double gm = gravityConstant * blackHoleMass;
+    const glm::vec4 color(0.8f, 0.6f, 0.4f, 1.0f);
+    const size_t chunks = (count + GENERATOR_CHUNK - 1) / GENERATOR_CHUNK;
+
+    pool.parallelFor(0, chunks, 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t chunk = begin; chunk < end; ++chunk) {
+            std::mt19937_64 rng = chunkGenerator(params.seed, chunk);
+            std::uniform_real_distribution<double> radius(params.innerRadius, params.outerRadius);
+            std::uniform_real_distribution<double> angle(0.0, TWO_PI);
+            std::uniform_real_distribution<double> height(-0.5 * params.thickness, 0.5 * params.thickness);
+
+            const size_t chunkEnd = std::min(count, (chunk + 1) * GENERATOR_CHUNK);
+            for (size_t i = chunk * GENERATOR_CHUNK; i < chunkEnd; ++i) {
+                // Uniform in r gives a surface density proportional to 1/r
+                const double r = radius(rng);
+                const double phi = angle(rng);
+                const double speed = std::sqrt(gm / r);
+
+                const size_t index = first + i;
+                out.positions[index] = blackHolePosition +
+                    glm::vec3(glm::dvec3(r * std::cos(phi), height(rng), r * std::sin(phi)));
+                out.velocities[index] = glm::vec3(glm::dvec3(-std::sin(phi), 0.0, std::cos(phi)) * speed);
+                out.masses[index] = params.bodyMass;
+                out.radii[index] = params.bodyRadius;
+                out.colors[index] = color;
+            }
+        }
+    });
+}
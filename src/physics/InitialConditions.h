@@ -0,0 +1,130 @@
+/**
+ * @file InitialConditions.h
+ * @brief Bulk loaders and procedural generators for large initial conditions
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../engine/TaskPool.h"
+
+/**
+ * @brief Builds large sets of bodies without going through Object or JSON
+ *
+ * Every source fills a Bodies staging block (the same arrays the particle
+ * store holds) in parallel on the physics task pool, which Physics then
+ * appends to the store in one bulk copy. Generators split their bodies into
+ * fixed-size chunks with one random stream per chunk, so a given seed gives
+ * the same scene whatever the thread count.
+ */
+class InitialConditions {
+public:
+    /**
+     * @brief Bodies in structure-of-arrays form, ready for ParticleStore::append
+     */
+    struct Bodies {
+        std::vector<glm::vec3> positions;   ///< Positions (meters)
+        std::vector<glm::vec3> velocities;  ///< Velocities (m/s)
+        std::vector<double> masses;         ///< Masses (kg)
+        std::vector<float> radii;           ///< Radii (meters)
+        std::vector<glm::vec4> colors;      ///< RGBA colors
+        std::vector<std::string> names;     ///< Names (empty: generated from the index)
+
+        /**
+         * @brief Get the number of bodies
+         * @return Body count
+         */
+        size_t size() const { return positions.size(); }
+
+        /**
+         * @brief Resize every array (names are left alone)
+         * @param count New body count
+         */
+        void resize(size_t count);
+
+        /**
+         * @brief Move another block's bodies onto the end of this one
+         * @param other Block to append (left empty)
+         */
+        void append(Bodies& other);
+    };
+
+    /**
+     * @brief Plummer sphere settings
+     */
+    struct PlummerParams {
+        size_t count = 10000;                   ///< Number of bodies
+        double totalMass = 1.0e33;              ///< Mass of the whole sphere (kg)
+        double scaleRadius = 2.0e10;            ///< Plummer radius a (m)
+        float bodyRadius = 1.0e9f;              ///< Radius of each body (m)
+        glm::vec3 center{4.0e11f, 0.0f, 0.0f};  ///< Sphere center (m)
+        glm::vec3 bulkVelocity{0.0f};           ///< Velocity added to every body (m/s)
+        uint64_t seed = 1;                      ///< Random seed
+    };
+
+    /**
+     * @brief Keplerian disk settings
+     */
+    struct DiskParams {
+        size_t count = 10000;                   ///< Number of bodies
+        double innerRadius = 3.0e10;            ///< Inner edge (m)
+        double outerRadius = 2.0e11;            ///< Outer edge (m)
+        double thickness = 2.0e9;               ///< Full height of the disk (m)
+        double bodyMass = 1.0e24;               ///< Mass of each body (kg)
+        float bodyRadius = 1.0e9f;              ///< Radius of each body (m)
+        uint64_t seed = 1;                      ///< Random seed
+    };
+
+    /**
+     * @brief Stream bodies from a CSV file
+     *
+     * The first line names the columns: x, y, z and mass are required; vx, vy,
+     * vz, radius, r, g, b, a and name are optional, and unknown columns are
+     * ignored. Lines that are empty or start with '#' are skipped. The file is
+     * read in large blocks and each block's lines are parsed in parallel, so
+     * memory stays bounded by the block size plus the bodies themselves.
+     * @param path CSV file
+     * @param defaultRadius Radius for rows without a radius column (m)
+     * @param pool Task pool for parsing
+     * @param out Receives the bodies
+     * @param error Receives the reason on failure
+     * @return True if every row parsed
+     */
+    static bool loadCsv(const std::string& path, float defaultRadius, TaskPool& pool,
+                        Bodies& out, std::string& error);
+
+    /**
+     * @brief Generate a Plummer sphere in equilibrium under its own gravity
+     *
+     * Radii and speeds are drawn from the Plummer distribution function
+     * (Aarseth, Hénon and Wielen 1974), so the sphere is in virial
+     * equilibrium; radii beyond 20 scale radii are redrawn.
+     * @param params Sphere settings
+     * @param gravityConstant G
+     * @param pool Task pool for generation
+     * @param out Receives the bodies
+     */
+    static void generatePlummer(const PlummerParams& params, double gravityConstant,
+                                TaskPool& pool, Bodies& out);
+
+    /**
+     * @brief Generate a thin disk of bodies on circular orbits around the black hole
+     *
+     * Bodies lie in the y = 0 plane the accretion disk uses, with a surface
+     * density falling off as 1/r and prograde Keplerian speeds for the black
+     * hole's mass alone.
+     * @param params Disk settings
+     * @param blackHolePosition Disk center (m)
+     * @param blackHoleMass Mass the orbits are computed for (kg)
+     * @param gravityConstant G
+     * @param pool Task pool for generation
+     * @param out Receives the bodies
+     */
+    static void generateDisk(const DiskParams& params, const glm::vec3& blackHolePosition,
+                             double blackHoleMass, double gravityConstant,
+                             TaskPool& pool, Bodies& out);
+};
@@ -0,0 +1,373 @@
+/**
+ * @file Octree.cpp
+ * @brief Implementation of the Barnes-Hut octree
+ */
+
+#include "Octree.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+/// Depth limit guarding against coincident bodies splitting forever
+constexpr int MAX_DEPTH = 32;
+
+/**
+ * @brief Get the octant of a point relative to a cube center
+ * @param position Point to classify
+ * @param center Cube center
+ * @return Octant index in [0, 8)
+ */
+inline int octantOf(const glm::vec3& position, const glm::vec3& center) {
+    return (position.x >= center.x ? 1 : 0) |
+           (position.y >= center.y ? 2 : 0) |
+           (position.z >= center.z ? 4 : 0);
+}
+
+}
+
+void Octree::build(const std::vector<glm::vec3>& positions,
+                   const std::vector<double>& masses,
+                   const std::vector<uint8_t>& active) {
+    m_positions = &positions;
+    m_masses = &masses;
+    m_nodes.clear();
+    m_indices.clear();
+    m_masslessActive = 0;
+
+    // Only active, massive bodies source gravity
+    glm::vec3 minBound(0.0f), maxBound(0.0f);
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (!active[i]) continue;
+        if (masses[i] <= 0.0) {
+            ++m_masslessActive;
+            continue;
+        }
+
+        if (m_indices.empty()) {
+            minBound = maxBound = positions[i];
+        } else {
+            minBound = glm::min(minBound, positions[i]);
+            maxBound = glm::max(maxBound, positions[i]);
+        }
+        m_indices.push_back(static_cast<uint32_t>(i));
+    }
+
+    if (m_indices.empty()) return;
+
+    m_scratch.resize(m_indices.size());
+    m_nodes.reserve(2 * m_indices.size() / LEAF_CAPACITY + 1);
+
+    glm::vec3 extent = maxBound - minBound;
+    float halfSize = 0.5f * std::max(extent.x, std::max(extent.y, extent.z));
+    halfSize = halfSize * 1.001f + 1.0f;  // Keep boundary bodies strictly inside
+
+    buildNode(0.5f * (minBound + maxBound), halfSize, 0, static_cast<uint32_t>(m_indices.size()), 0);
+
+    // Pack sources in tree order so every leaf bucket is a contiguous kernel range
+    m_sources.resize(m_indices.size());
+    for (size_t k = 0; k < m_indices.size(); ++k) {
+        uint32_t b = m_indices[k];
+        m_sources.set(k, positions[b], static_cast<float>(masses[b]));
+    }
+}
+
+int Octree::buildNode(const glm::vec3& center, float halfSize, uint32_t begin, uint32_t count, int depth) {
+    const auto& positions = *m_positions;
+    const auto& masses = *m_masses;
+
+    int nodeIndex = static_cast<int>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    // Mass moments of this subtree
+    double mass = 0.0;
+    glm::dvec3 weighted(0.0);
+    for (uint32_t k = begin; k < begin + count; ++k) {
+        uint32_t b = m_indices[k];
+        mass += masses[b];
+        weighted += glm::dvec3(positions[b]) * masses[b];
+    }
+
+    Node node;
+    node.center = center;
+    node.halfSize = halfSize;
+    node.centerOfMass = glm::vec3(weighted / mass);
+    node.mass = mass;
+    std::fill(std::begin(node.children), std::end(node.children), -1);
+    node.begin = begin;
+    node.count = count;
+    node.parent = -1;
+    node.leaf = count <= static_cast<uint32_t>(LEAF_CAPACITY) || depth >= MAX_DEPTH;
+    m_nodes[nodeIndex] = node;
+
+    if (node.leaf) return nodeIndex;
+
+    // Counting sort of the range by octant
+    uint32_t octantCount[8] = {0};
+    for (uint32_t k = begin; k < begin + count; ++k) {
+        ++octantCount[octantOf(positions[m_indices[k]], center)];
+    }
+
+    uint32_t octantStart[8];
+    uint32_t offset = begin;
+    for (int o = 0; o < 8; ++o) {
+        octantStart[o] = offset;
+        offset += octantCount[o];
+    }
+
+    uint32_t cursor[8];
+    std::copy(std::begin(octantStart), std::end(octantStart), std::begin(cursor));
+    for (uint32_t k = begin; k < begin + count; ++k) {
+        uint32_t b = m_indices[k];
+        m_scratch[cursor[octantOf(positions[b], center)]++] = b;
+    }
+    std::copy(m_scratch.begin() + begin, m_scratch.begin() + begin + count, m_indices.begin() + begin);
+
+    // Recurse into non-empty octants
+    float childHalf = 0.5f * halfSize;
+    for (int o = 0; o < 8; ++o) {
+        if (octantCount[o] == 0) continue;
+
+        glm::vec3 childCenter = center + glm::vec3(
+            (o & 1) ? childHalf : -childHalf,
+            (o & 2) ? childHalf : -childHalf,
+            (o & 4) ? childHalf : -childHalf);
+
+        int child = buildNode(childCenter, childHalf, octantStart[o], octantCount[o], depth + 1);
+        m_nodes[nodeIndex].children[o] = child;
+        m_nodes[child].parent = nodeIndex;
+    }
+
+    return nodeIndex;
+}
+
+glm::vec3 Octree::computeAcceleration(size_t index, double G, float theta, float softeningSquared,
+                                      uint64_t* interactions) const {
+    glm::dvec3 acceleration(0.0);
+    accumulate((*m_positions)[index], index, theta, softeningSquared, &acceleration, nullptr, interactions);
+    return glm::vec3(acceleration * G);
+}
+
+double Octree::computePotential(size_t index, double G, float theta, float softeningSquared) const {
+    double potential = 0.0;
+    accumulate((*m_positions)[index], index, theta, softeningSquared, nullptr, &potential);
+    return potential * G;
+}
+
+void Octree::accumulate(const glm::vec3& position, size_t index, float theta, float softeningSquared,
+                        glm::dvec3* acceleration, double* potential, uint64_t* interactions) const {
+    if (m_nodes.empty()) return;
+
+    const auto& positions = *m_positions;
+    const auto& masses = *m_masses;
+    const double thetaSquared = static_cast<double>(theta) * theta;
+
+    // Bucket sums stay in float inside the kernel and are folded in at the end
+    glm::vec3 leafAcceleration(0.0f);
+    uint64_t evaluated = 0;
+
+    int stack[8 * MAX_DEPTH + 8];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+
+        if (node.leaf) {
+            evaluated += node.count;
+            if (acceleration) {
+                // The body itself sits at zero distance and contributes nothing
+                GravityKernel::accumulate(m_sources, node.begin, node.begin + node.count,
+                                          position, softeningSquared, leafAcceleration);
+            }
+            if (potential) {
+                for (uint32_t k = node.begin; k < node.begin + node.count; ++k) {
+                    uint32_t b = m_indices[k];
+                    if (b == index) continue;
+
+                    glm::dvec3 displacement = glm::dvec3(positions[b]) - glm::dvec3(position);
+                    double distSquared = glm::dot(displacement, displacement) + softeningSquared;
+                    if (distSquared <= 0.0) continue;
+
+                    *potential -= masses[b] / std::sqrt(distSquared);
+                }
+            }
+            continue;
+        }
+
+        glm::dvec3 displacement = glm::dvec3(node.centerOfMass) - glm::dvec3(position);
+        double distSquared = glm::dot(displacement, displacement);
+        double size = 2.0 * node.halfSize;
+
+        // Never approximate a node that contains the evaluation point
+        glm::vec3 local = position - node.center;
+        bool inside = std::abs(local.x) <= node.halfSize &&
+                      std::abs(local.y) <= node.halfSize &&
+                      std::abs(local.z) <= node.halfSize;
+
+        if (!inside && size * size < thetaSquared * distSquared) {
+            // Far enough away: treat the whole subtree as a point mass
+            double softDistSquared = distSquared + softeningSquared;
+            double dist = std::sqrt(softDistSquared);
+            ++evaluated;
+            if (acceleration) *acceleration += displacement * (node.mass / (softDistSquared * dist));
+            if (potential) *potential -= node.mass / dist;
+        } else {
+            for (int child : node.children) {
+                if (child >= 0) stack[top++] = child;
+            }
+        }
+    }
+
+    if (acceleration) *acceleration += glm::dvec3(leafAcceleration);
+    if (interactions) *interactions += evaluated;
+}
+
+void Octree::setVelocities(const std::vector<glm::vec3>& velocities) {
+    const auto& masses = *m_masses;
+    const size_t bodyCount = m_positions->size();
+    m_slots.assign(bodyCount, NO_SLOT);
+    m_leafOf.assign(bodyCount, -1);
+    m_nodeVelocities.resize(m_nodes.size());
+    m_nodeOffsets.assign(m_nodes.size(), glm::vec3(0.0f));
+    m_sourceVelocities.resize(m_indices.size());
+    m_sourceOffsets.assign(m_indices.size(), glm::vec3(0.0f));
+
+    // Children always follow their parent in the pool, so a reverse sweep is bottom-up
+    for (size_t n = m_nodes.size(); n-- > 0;) {
+        const Node& node = m_nodes[n];
+        glm::dvec3 momentum(0.0);
+        if (node.leaf) {
+            for (uint32_t k = node.begin; k < node.begin + node.count; ++k) {
+                uint32_t b = m_indices[k];
+                m_slots[b] = k;
+                m_leafOf[b] = static_cast<int>(n);
+                m_sourceVelocities[k] = velocities[b];
+                momentum += glm::dvec3(velocities[b]) * masses[b];
+            }
+        } else {
+            for (int child : node.children) {
+                if (child >= 0) momentum += glm::dvec3(m_nodeVelocities[child]) * m_nodes[child].mass;
+            }
+        }
+        m_nodeVelocities[n] = glm::vec3(momentum / node.mass);
+    }
+}
+
+void Octree::kick(size_t index, const glm::vec3& deltaVelocity, float time) {
+    if (index >= m_slots.size() || m_slots[index] == NO_SLOT) return;
+
+    // x(t) = x₀ + v·t - Σ Δv·tₖ, for a body and for any mass-weighted mean of bodies
+    const uint32_t slot = m_slots[index];
+    m_sourceVelocities[slot] += deltaVelocity;
+    m_sourceOffsets[slot] -= deltaVelocity * time;
+
+    const double mass = (*m_masses)[index];
+    for (int n = m_leafOf[index]; n >= 0; n = m_nodes[n].parent) {
+        const glm::vec3 change = deltaVelocity * static_cast<float>(mass / m_nodes[n].mass);
+        m_nodeVelocities[n] += change;
+        m_nodeOffsets[n] -= change * time;
+    }
+}
+
+glm::vec3 Octree::computeDriftedAcceleration(size_t index, const glm::vec3& position, float time, double G,
+                                             float theta, float softeningSquared,
+                                             uint64_t* interactions) const {
+    if (m_nodes.empty()) return glm::vec3(0.0f);
+
+    const double thetaSquared = static_cast<double>(theta) * theta;
+    const uint32_t slot = index < m_slots.size() ? m_slots[index] : NO_SLOT;
+    glm::dvec3 acceleration(0.0);
+    uint64_t evaluated = 0;
+
+    int stack[8 * MAX_DEPTH + 8];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const int n = stack[--top];
+        const Node& node = m_nodes[n];
+
+        if (node.leaf) {
+            // Predicted sources no longer coincide with the body's own position, so skip it by slot
+            evaluated += node.count;
+            for (uint32_t k = node.begin; k < node.begin + node.count; ++k) {
+                if (k == slot) continue;
+
+                glm::vec3 source = glm::vec3(m_sources.x[k], m_sources.y[k], m_sources.z[k]) +
+                                   m_sourceOffsets[k] + m_sourceVelocities[k] * time;
+                glm::dvec3 displacement = glm::dvec3(source) - glm::dvec3(position);
+                double distSquared = glm::dot(displacement, displacement) + softeningSquared;
+                if (distSquared <= 0.0) continue;
+
+                acceleration += displacement * (m_sources.strength[k] / (distSquared * std::sqrt(distSquared)));
+            }
+            continue;
+        }
+
+        glm::vec3 centerOfMass = node.centerOfMass + m_nodeOffsets[n] + m_nodeVelocities[n] * time;
+        glm::dvec3 displacement = glm::dvec3(centerOfMass) - glm::dvec3(position);
+        double distSquared = glm::dot(displacement, displacement);
+        double size = 2.0 * node.halfSize;
+
+        glm::vec3 local = position - node.center;
+        bool inside = (slot >= node.begin && slot < node.begin + node.count) ||
+                      (std::abs(local.x) <= node.halfSize &&
+                       std::abs(local.y) <= node.halfSize &&
+                       std::abs(local.z) <= node.halfSize);
+
+        if (!inside && size * size < thetaSquared * distSquared) {
+            double softDistSquared = distSquared + softeningSquared;
+            ++evaluated;
+            acceleration += displacement * (node.mass / (softDistSquared * std::sqrt(softDistSquared)));
+        } else {
+            for (int child : node.children) {
+                if (child >= 0) stack[top++] = child;
+            }
+        }
+    }
+
+    if (interactions) *interactions += evaluated;
+    return glm::vec3(acceleration * G);
+}
+
+void Octree::findOverlaps(size_t index, const std::vector<float>& radii, float maxRadius,
+                          std::vector<std::pair<uint32_t, uint32_t>>& contacts) const {
+    if (m_nodes.empty()) return;
+
+    const auto& positions = *m_positions;
+    const glm::vec3 position = positions[index];
+    const float reach = radii[index] + maxRadius;
+
+    int stack[8 * MAX_DEPTH + 8];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+
+        // Every body in the node lies in its cube, so a cube grown by the reach bounds all contacts
+        glm::vec3 local = glm::abs(position - node.center);
+        float bound = node.halfSize + reach;
+        if (local.x > bound || local.y > bound || local.z > bound) continue;
+
+        if (node.leaf) {
+            for (uint32_t k = node.begin; k < node.begin + node.count; ++k) {
+                uint32_t b = m_indices[k];
+                if (b <= index) continue;
+
+                double distance = glm::length(positions[b] - position);
+                double combinedRadii = static_cast<double>(radii[index] + radii[b]);
+                if (distance <= combinedRadii) {
+                    contacts.emplace_back(static_cast<uint32_t>(index), b);
+                }
+            }
+            continue;
+        }
+
+        for (int child : node.children) {
+            if (child >= 0) stack[top++] = child;
+        }
+    }
+}
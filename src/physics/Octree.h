@@ -0,0 +1,190 @@
+/**
+ * @file Octree.h
+ * @brief Barnes-Hut octree for O(N log N) gravitational force evaluation
+ */
+
+#pragma once
+
+#include "GravityKernel.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Spatial octree storing mass moments for the Barnes-Hut approximation
+ *
+ * The tree is rebuilt from scratch every step. Each node stores its total mass
+ * and center of mass; during traversal a node whose size-to-distance ratio is
+ * below the opening angle theta is treated as a single point mass, otherwise
+ * its children are visited. Leaves hold small buckets of bodies that are
+ * summed directly with the vectorized GravityKernel; their positions and masses
+ * are packed contiguously in tree order so each bucket is one kernel call.
+ *
+ * Between builds the tree can also be drifted: after setVelocities() every
+ * source and center of mass moves along its recorded velocity, and kick()
+ * folds velocity changes into those predictions, so block timestep sub-steps
+ * evaluate a few bodies without rebuilding the tree.
+ */
+class Octree {
+public:
+    /**
+     * @brief Maximum number of bodies stored in a leaf before it is split
+     */
+    static constexpr int LEAF_CAPACITY = 32;
+
+    /**
+     * @brief Rebuild the tree from body state
+     * @param positions Body positions
+     * @param masses Body masses
+     * @param active Active flags (inactive bodies are skipped)
+     */
+    void build(const std::vector<glm::vec3>& positions,
+               const std::vector<double>& masses,
+               const std::vector<uint8_t>& active);
+
+    /**
+     * @brief Compute gravitational acceleration at a body's position
+     * @param index Index of the body (excluded from its own field)
+     * @param G Gravitational constant
+     * @param theta Opening angle
+     * @param softeningSquared Squared softening length (m²)
+     * @param interactions Incremented by the bucket sources and node approximations evaluated (optional)
+     * @return Acceleration vector (m/s²)
+     */
+    glm::vec3 computeAcceleration(size_t index, double G, float theta, float softeningSquared = 0.0f,
+                                  uint64_t* interactions = nullptr) const;
+
+    /**
+     * @brief Compute gravitational potential at a body's position
+     * @param index Index of the body (excluded from its own field)
+     * @param G Gravitational constant
+     * @param theta Opening angle
+     * @param softeningSquared Squared softening length (m²)
+     * @return Potential (J/kg, negative)
+     */
+    double computePotential(size_t index, double G, float theta, float softeningSquared = 0.0f) const;
+
+    /**
+     * @brief Record body velocities so the tree can be drifted without a rebuild
+     *
+     * Must be called while the positions the tree was built from are still
+     * current; it restarts every drift prediction at time 0. O(N).
+     * @param velocities Body velocities
+     */
+    void setVelocities(const std::vector<glm::vec3>& velocities);
+
+    /**
+     * @brief Fold a body's velocity change into the drift predictions
+     *
+     * Updates the body's own source and the center of mass of every node above
+     * it, so predictions stay exact for piecewise-linear motion. O(depth).
+     * @param index Body index
+     * @param deltaVelocity Velocity change
+     * @param time Time since setVelocities() at which the change happens (s)
+     */
+    void kick(size_t index, const glm::vec3& deltaVelocity, float time);
+
+    /**
+     * @brief Compute gravitational acceleration against the drifted tree
+     *
+     * Sources and centers of mass are taken at their predicted positions; node
+     * cubes keep their built geometry, so a node is opened whenever it holds the
+     * body, wherever the body has drifted to.
+     * @param index Index of the body (excluded from its own field)
+     * @param position Body's current position
+     * @param time Time since setVelocities() (s)
+     * @param G Gravitational constant
+     * @param theta Opening angle
+     * @param softeningSquared Squared softening length (m²)
+     * @param interactions Incremented by the sources and node approximations evaluated (optional)
+     * @return Acceleration vector (m/s²)
+     */
+    glm::vec3 computeDriftedAcceleration(size_t index, const glm::vec3& position, float time, double G,
+                                         float theta, float softeningSquared = 0.0f,
+                                         uint64_t* interactions = nullptr) const;
+
+    /**
+     * @brief Find bodies overlapping one body, for use as a collision broad phase
+     *
+     * Only bodies with a higher index are reported, so every pair appears once
+     * when all bodies are queried. Positions are the ones the tree was built from.
+     * @param index Body to test
+     * @param radii Body radii
+     * @param maxRadius Largest radius of any body in the tree
+     * @param contacts Receives (index, other) for each overlapping body
+     */
+    void findOverlaps(size_t index, const std::vector<float>& radii, float maxRadius,
+                      std::vector<std::pair<uint32_t, uint32_t>>& contacts) const;
+    
+    /**
+     * @brief Check whether every active body was inserted (massless bodies are not)
+     * @return True if the tree can stand in for the whole active set
+     */
+    bool containsAllActive() const { return m_masslessActive == 0; }
+
+    /**
+     * @brief Get number of nodes in the tree
+     * @return Node count
+     */
+    size_t getNodeCount() const { return m_nodes.size(); }
+
+private:
+    /**
+     * @brief Tree node covering a cube of space
+     */
+    struct Node {
+        glm::vec3 center;           ///< Geometric center of the cube
+        float halfSize;             ///< Half the cube's edge length
+        glm::vec3 centerOfMass;     ///< Mass-weighted center of the contained bodies
+        double mass;                ///< Total mass of the contained bodies
+        int children[8];            ///< Child node indices (-1 if empty)
+        uint32_t begin;             ///< First entry in the body index array
+        uint32_t count;             ///< Number of bodies in this subtree
+        int parent;                 ///< Parent node index (-1 for the root)
+        bool leaf;                  ///< True if bodies are stored directly
+    };
+
+    /// m_slots entry of bodies the tree does not contain
+    static constexpr uint32_t NO_SLOT = ~uint32_t(0);
+
+    std::vector<Node> m_nodes;              ///< Node pool (root is node 0)
+    std::vector<uint32_t> m_indices;        ///< Body indices, grouped by node
+    std::vector<uint32_t> m_scratch;        ///< Partition scratch space
+    GravitySources m_sources;               ///< Positions and masses in index-array order
+    const std::vector<glm::vec3>* m_positions = nullptr;  ///< Positions the tree was built from
+    const std::vector<double>* m_masses = nullptr;        ///< Masses the tree was built from
+    size_t m_masslessActive = 0;            ///< Active bodies left out for having no mass
+
+    // Drift state, kept apart from the nodes so ordinary walks stay compact
+    std::vector<uint32_t> m_slots;              ///< Index-array entry of each body (NO_SLOT if absent)
+    std::vector<int> m_leafOf;                  ///< Leaf holding each body (-1 if absent)
+    std::vector<glm::vec3> m_nodeVelocities;    ///< Center-of-mass velocity of each node
+    std::vector<glm::vec3> m_nodeOffsets;       ///< Sum of -Δv·t over kicks, per node
+    std::vector<glm::vec3> m_sourceVelocities;  ///< Velocity of each source, in m_sources order
+    std::vector<glm::vec3> m_sourceOffsets;     ///< Sum of -Δv·t over kicks, per source
+
+    /**
+     * @brief Recursively build a subtree over a range of body indices
+     * @param center Cube center
+     * @param halfSize Cube half size
+     * @param begin First entry in the index array
+     * @param count Number of entries
+     * @param depth Current depth
+     * @return Index of the created node
+     */
+    int buildNode(const glm::vec3& center, float halfSize, uint32_t begin, uint32_t count, int depth);
+
+    /**
+     * @brief Walk the tree and accumulate the field at a point
+     * @param position Evaluation point
+     * @param index Body to exclude
+     * @param theta Opening angle
+     * @param softeningSquared Squared softening length
+     * @param acceleration Accumulated G-free acceleration (sum m r / |r|³), or nullptr
+     * @param potential Accumulated G-free potential (sum -m / |r|), or nullptr
+     * @param interactions Incremented by the bucket sources and node approximations evaluated, or nullptr
+     */
+    void accumulate(const glm::vec3& position, size_t index, float theta, float softeningSquared,
+                    glm::dvec3* acceleration, double* potential, uint64_t* interactions = nullptr) const;
+};
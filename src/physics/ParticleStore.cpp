@@ -0,0 +1,179 @@
+/**
+ * @file ParticleStore.cpp
+ * @brief Implementation of the structure-of-arrays body storage
+ */
+
+#include "ParticleStore.h"
+#include <string>
+#include <vector>
+
+BodyHandle ParticleStore::add(const Object& object) {
+    BodyHandle handle = allocateHandle();
+
+    m_positions.push_back(object.getPosition());
+    m_velocities.push_back(object.getVelocity());
+    m_accelerations.push_back(glm::vec3(0.0f));
+    m_masses.push_back(object.getMass());
+    m_radii.push_back(object.getRadius());
+    m_active.push_back(object.isActive() ? 1 : 0);
+    m_levels.push_back(0);
+    m_handles.push_back(handle);
+
+    ParticleInfo& info = m_info[handle.index];
+    info.name = object.getName();
+    info.color = object.getColor();
+    info.type = object.getType();
+    info.trailSlot = m_trails.allocate(object.getPosition());
+
+    return handle;
+}
+
+size_t ParticleStore::append(size_t count,
+                             const glm::vec3* positions,
+                             const glm::vec3* velocities,
+                             const double* masses,
+                             const float* radii,
+                             const uint8_t* active) {
+    const size_t first = size();
+    reserve(first + count);
+
+    m_positions.insert(m_positions.end(), positions, positions + count);
+    m_velocities.insert(m_velocities.end(), velocities, velocities + count);
+    m_accelerations.resize(first + count, glm::vec3(0.0f));
+    m_masses.insert(m_masses.end(), masses, masses + count);
+    m_radii.insert(m_radii.end(), radii, radii + count);
+    m_active.insert(m_active.end(), active, active + count);
+    m_levels.resize(first + count, 0);
+
+    for (size_t i = 0; i < count; ++i) {
+        BodyHandle handle = allocateHandle();
+        m_handles.push_back(handle);
+
+        ParticleInfo& info = m_info[handle.index];
+        info.color = glm::vec4(1.0f);
+        info.type = Object::Type::PLANET;
+        info.trailSlot = m_trails.allocate(positions[i]);
+    }
+
+    return first;
+}
+
+BodyHandle ParticleStore::allocateHandle() {
+    BodyHandle handle;
+    if (!m_freeSlots.empty()) {
+        handle.index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        handle.index = static_cast<uint32_t>(m_slots.size());
+        m_slots.push_back({INVALID_DENSE, 0});
+        m_info.emplace_back();
+    }
+    handle.generation = m_slots[handle.index].generation;
+    m_slots[handle.index].dense = static_cast<uint32_t>(m_handles.size());
+    return handle;
+}
+
+void ParticleStore::remove(size_t index) {
+    if (index >= size()) return;
+    swapRemove(index);
+}
+
+size_t ParticleStore::removeInactive() {
+    size_t removed = 0;
+    size_t i = 0;
+    while (i < size()) {
+        if (m_active[i]) {
+            ++i;
+            continue;
+        }
+        // The body swapped into i has not been looked at yet, so i stays put
+        swapRemove(i);
+        ++removed;
+    }
+    return removed;
+}
+
+void ParticleStore::swapRemove(size_t index) {
+    const BodyHandle removed = m_handles[index];
+    Slot& slot = m_slots[removed.index];
+    m_trails.release(m_info[removed.index].trailSlot);
+    m_info[removed.index] = ParticleInfo();
+    slot.dense = INVALID_DENSE;
+    slot.generation++;
+    m_freeSlots.push_back(removed.index);
+
+    const size_t last = size() - 1;
+    if (index != last) {
+        m_positions[index] = m_positions[last];
+        m_velocities[index] = m_velocities[last];
+        m_accelerations[index] = m_accelerations[last];
+        m_masses[index] = m_masses[last];
+        m_radii[index] = m_radii[last];
+        m_active[index] = m_active[last];
+        m_levels[index] = m_levels[last];
+        m_handles[index] = m_handles[last];
+        m_slots[m_handles[index].index].dense = static_cast<uint32_t>(index);
+    }
+
+    m_positions.pop_back();
+    m_velocities.pop_back();
+    m_accelerations.pop_back();
+    m_masses.pop_back();
+    m_radii.pop_back();
+    m_active.pop_back();
+    m_levels.pop_back();
+    m_handles.pop_back();
+}
+
+void ParticleStore::clear() {
+    // Outstanding handles must stop resolving, so live slots are freed rather than dropped
+    for (const BodyHandle& handle : m_handles) {
+        m_slots[handle.index].dense = INVALID_DENSE;
+        m_slots[handle.index].generation++;
+        m_info[handle.index] = ParticleInfo();
+        m_freeSlots.push_back(handle.index);
+    }
+
+    m_positions.clear();
+    m_velocities.clear();
+    m_accelerations.clear();
+    m_masses.clear();
+    m_radii.clear();
+    m_active.clear();
+    m_levels.clear();
+    m_handles.clear();
+    m_trails.clear();
+}
+
+void ParticleStore::configureTrails(size_t length, size_t sampleInterval) {
+    m_trails.configure(length, sampleInterval);
+
+    // Existing bodies restart their trails at their current positions
+    for (size_t i = 0; i < size(); ++i) {
+        getInfo(i).trailSlot = m_trails.allocate(m_positions[i]);
+    }
+}
+
+void ParticleStore::reserve(size_t count) {
+    m_positions.reserve(count);
+    m_velocities.reserve(count);
+    m_accelerations.reserve(count);
+    m_masses.reserve(count);
+    m_radii.reserve(count);
+    m_active.reserve(count);
+    m_levels.reserve(count);
+    m_handles.reserve(count);
+    m_slots.reserve(count);
+    m_info.reserve(count);
+    m_trails.reserve(count);
+}
+
+void ParticleStore::recordTrails() {
+    if (!m_trails.beginSample()) return;
+
+    for (size_t i = 0; i < size(); ++i) {
+        if (!m_active[i]) continue;
+        m_trails.record(getInfo(i).trailSlot, m_positions[i]);
+    }
+    m_trails.endSample();
+}
@@ -0,0 +1,234 @@
+/**
+ * @file ParticleStore.h
+ * @brief Structure-of-arrays storage for the bodies in the physics simulation
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BodyHandle.h"
+#include "TrailPool.h"
+#include "../objects/Object.h"
+
+/**
+ * @brief Cache-friendly body storage used by the physics and rendering systems
+ *
+ * The state touched by the force loops (position, velocity, acceleration, mass,
+ * radius and active flag) lives in separate contiguous arrays indexed by a dense
+ * body index. Data that is only needed for presentation (name, color, type and
+ * trail slot) lives in a cold side table indexed by handle slot, so it is never
+ * pulled through cache by the N-body passes. Trails themselves live in one
+ * shared TrailPool.
+ *
+ * Removal swaps the last body into the freed index, so dense indices are not
+ * stable: hold a BodyHandle and resolve it with indexOf() instead. Freed handle
+ * slots go on a free list and are reused with a bumped generation.
+ */
+class ParticleStore {
+public:
+    /**
+     * @brief indexOf() result for a handle whose body no longer exists
+     */
+    static constexpr size_t INVALID_INDEX = ~size_t(0);
+
+    /**
+     * @brief Cold per-body data that the simulation loops never touch
+     */
+    struct ParticleInfo {
+        std::string name;                   ///< Body name
+        glm::vec4 color;                    ///< RGBA color for rendering
+        Object::Type type;                  ///< Body type
+        TrailPool::Slot trailSlot;          ///< Slot of the body's trail in the trail pool
+    };
+
+    /**
+     * @brief Set the trail length and sample rate (drops existing trails)
+     * @param length Samples kept per trail
+     * @param sampleInterval Physics steps between samples
+     */
+    void configureTrails(size_t length, size_t sampleInterval);
+
+    /**
+     * @brief Add a body described by an object
+     * @param object Object providing the initial state
+     * @return Handle of the new body
+     */
+    BodyHandle add(const Object& object);
+
+    /**
+     * @brief Append bodies given as whole arrays (bulk loads such as snapshot restore)
+     *
+     * Each hot array is copied in one pass; accelerations and block levels start
+     * at zero. Cold data gets a white color and the planet type and can be filled
+     * in through getInfo() afterwards.
+     * @param count Number of bodies
+     * @param positions Positions (count entries)
+     * @param velocities Velocities (count entries)
+     * @param masses Masses (count entries)
+     * @param radii Radii (count entries)
+     * @param active Active flags (count entries)
+     * @return Dense index of the first appended body
+     */
+    size_t append(size_t count,
+                  const glm::vec3* positions,
+                  const glm::vec3* velocities,
+                  const double* masses,
+                  const float* radii,
+                  const uint8_t* active);
+
+    /**
+     * @brief Remove the body at a dense index by moving the last body into its place
+     * @param index Dense index of the body to remove
+     */
+    void remove(size_t index);
+
+    /**
+     * @brief Remove every inactive body in one pass
+     *
+     * Each removal is a swap with the last body, so the pass is O(N) however
+     * many bodies go; the order of the remaining bodies is not preserved.
+     * @return Number of bodies removed
+     */
+    size_t removeInactive();
+
+    /**
+     * @brief Check whether a handle still refers to a body
+     * @param handle Body handle
+     * @return True if the body has not been removed
+     */
+    bool isValid(BodyHandle handle) const {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation
+            && m_slots[handle.index].dense != INVALID_DENSE;
+    }
+
+    /**
+     * @brief Resolve a handle to the body's current dense index
+     * @param handle Body handle
+     * @return Dense index, or INVALID_INDEX if the body has been removed
+     */
+    size_t indexOf(BodyHandle handle) const {
+        return isValid(handle) ? m_slots[handle.index].dense : INVALID_INDEX;
+    }
+
+    /**
+     * @brief Remove all bodies
+     */
+    void clear();
+
+    /**
+     * @brief Reserve storage for a number of bodies
+     * @param count Number of bodies to reserve space for
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Get number of bodies
+     * @return Body count
+     */
+    size_t size() const { return m_handles.size(); }
+
+    /**
+     * @brief Check if the store holds no bodies
+     * @return True if empty
+     */
+    bool empty() const { return m_handles.empty(); }
+
+    /**
+     * @brief Get number of handle slots, free or in use
+     * @return Size of the handle table
+     */
+    size_t getSlotCount() const { return m_slots.size(); }
+
+    // Hot arrays (indexed by dense body index)
+    const std::vector<glm::vec3>& getPositions() const { return m_positions; }
+    std::vector<glm::vec3>& getPositions() { return m_positions; }
+    const std::vector<glm::vec3>& getVelocities() const { return m_velocities; }
+    std::vector<glm::vec3>& getVelocities() { return m_velocities; }
+    const std::vector<glm::vec3>& getAccelerations() const { return m_accelerations; }
+    std::vector<glm::vec3>& getAccelerations() { return m_accelerations; }
+    const std::vector<double>& getMasses() const { return m_masses; }
+    std::vector<double>& getMasses() { return m_masses; }
+    const std::vector<float>& getRadii() const { return m_radii; }
+    std::vector<float>& getRadii() { return m_radii; }
+    const std::vector<uint8_t>& getActiveFlags() const { return m_active; }
+    std::vector<uint8_t>& getActiveFlags() { return m_active; }
+    const std::vector<uint8_t>& getTimestepLevels() const { return m_levels; }
+    std::vector<uint8_t>& getTimestepLevels() { return m_levels; }
+    const std::vector<BodyHandle>& getHandles() const { return m_handles; }
+
+    /**
+     * @brief Get cold data for the body at a dense index
+     * @param index Dense body index
+     * @return Reference to the body's cold data
+     */
+    const ParticleInfo& getInfo(size_t index) const { return m_info[m_handles[index].index]; }
+
+    /**
+     * @brief Get non-const cold data for the body at a dense index
+     * @param index Dense body index
+     * @return Reference to the body's cold data
+     */
+    ParticleInfo& getInfo(size_t index) { return m_info[m_handles[index].index]; }
+
+    /**
+     * @brief Get the name of the body at a dense index
+     * @param index Dense body index
+     * @return Body name
+     */
+    const std::string& getName(size_t index) const { return getInfo(index).name; }
+
+    /**
+     * @brief Append current positions of all active bodies to their trails
+     *
+     * Called once per physics step; only every sampleInterval-th call records.
+     */
+    void recordTrails();
+
+    /**
+     * @brief Get the shared trail storage
+     * @return Trail pool (slots are listed in each body's ParticleInfo)
+     */
+    const TrailPool& getTrails() const { return m_trails; }
+
+private:
+    static constexpr uint32_t INVALID_DENSE = ~uint32_t(0);
+
+    /**
+     * @brief Handle table entry
+     */
+    struct Slot {
+        uint32_t dense;                     ///< Dense index of the body, INVALID_DENSE when free
+        uint32_t generation;                ///< Bumped each time the slot is freed
+    };
+
+    /**
+     * @brief Take a free handle slot for a body about to be appended at the end
+     * @return Handle pointing at dense index size()
+     */
+    BodyHandle allocateHandle();
+
+    /**
+     * @brief Move the last body into a dense index and drop the last entry
+     * @param index Dense index being vacated
+     */
+    void swapRemove(size_t index);
+
+    // Hot state, one entry per body
+    std::vector<glm::vec3> m_positions;     ///< Positions (meters)
+    std::vector<glm::vec3> m_velocities;    ///< Velocities (m/s)
+    std::vector<glm::vec3> m_accelerations; ///< Accelerations (m/s²)
+    std::vector<double> m_masses;           ///< Masses (kg)
+    std::vector<float> m_radii;             ///< Physical radii (meters)
+    std::vector<uint8_t> m_active;          ///< Non-zero if body is active
+    std::vector<uint8_t> m_levels;          ///< Block timestep level (step = timeStep / 2^level)
+    std::vector<BodyHandle> m_handles;      ///< Handle of each body
+
+    // Handle table and cold state, indexed by handle slot
+    std::vector<Slot> m_slots;              ///< Dense index and generation per slot
+    std::vector<uint32_t> m_freeSlots;      ///< Freed slots available for reuse
+    std::vector<ParticleInfo> m_info;       ///< Presentation data per slot
+    TrailPool m_trails;                     ///< Trail ring buffers of all bodies
+};
@@ -4,32 +4,67 @@
  */
 
 #include "Physics.h"
+#include "InitialConditions.h"
+#include "SnapshotFile.h"
 #include "../utils/Logger.h"
+#include "../utils/Metrics.h"
+#include "../utils/Settings.h"
 #include <GLFW/glfw3.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <map>
+#include <utility>
+
+namespace {
+
+/// Rows of the pairwise triangle per task (rows shrink, stealing rebalances)
+constexpr size_t PAIR_GRAIN = 16;
+
+/// Targets per task for the direct solver (each one sweeps every source)
+constexpr size_t TARGET_GRAIN = 32;
+
+/// Bodies per task for independent per-body passes
+constexpr size_t BODY_GRAIN = 256;
+
+/// Bodies per task for collision broad-phase queries
+constexpr size_t CONTACT_GRAIN = 64;
+
+/// Deepest block timestep level accepted from the config (2^20 ticks per step)
+constexpr int MAX_BLOCK_LEVEL = 20;
+
+/**
+ * @brief Build the central black hole from its resolved settings
+ */
+BlackHole createBlackHole(const Settings::BlackHoleSettings& settings) {
+    return BlackHole(settings.position, settings.mass, settings.name);
+}
+
+}
 
 Physics::Physics(const Config& config)
     : m_config(config)
-    , m_blackHole(
-        glm::vec3(
-            config.getDoubleArray("blackHole.position", {0.0, 0.0, 0.0})[0],
-            config.getDoubleArray("blackHole.position", {0.0, 0.0, 0.0})[1],
-            config.getDoubleArray("blackHole.position", {0.0, 0.0, 0.0})[2]
-        ),
-        config.getDouble("blackHole.mass", 8.54e36),
-        config.getString("blackHole.name", "Sagittarius A*")
-    )
+    , m_blackHole(createBlackHole(Settings::BlackHoleSettings::fromConfig(config)))
     , m_gravityEnabled(config.getBool("physics.enableGravity", false))
     , m_integrationMethod(IntegrationMethod::RK4)
+    , m_forceSolver(ForceSolver::DIRECT)
+    , m_theta(config.getFloat("physics.theta", 0.5f))
+    , m_softening(config.getFloat("physics.softening", 0.0f))
     , m_timeStep(config.getFloat("physics.timeStep", 0.016666f))
     , m_G(config.getDouble("physics.gravityConstant", 6.67430e-11))
+    , m_octreeCurrent(false)
+    , m_taskPool(std::make_unique<TaskPool>(
+        static_cast<size_t>(std::max(0, config.getInt("performance.threads", 0)))))
+    , m_accelerationsValid(false)
+    , m_blockTimesteps(config.getBool("physics.blockTimesteps", false))
+    , m_maxBlockLevel(std::clamp(config.getInt("physics.maxBlockLevel", 8), 0, MAX_BLOCK_LEVEL))
+    , m_timestepAccuracy(config.getFloat("physics.timestepAccuracy", 0.02f))
     , m_simulationTime(0.0)
-    , m_stepCount(0) {
+    , m_stepCount(0)
+    , m_interactionCount(0) {
     
     // Parse integration method from config
     std::string methodStr = config.getString("physics.integrationMethod", "rk4");
@@ -41,12 +76,39 @@ Physics::Physics(const Config& config)
         m_integrationMethod = IntegrationMethod::RK4;
     }
     
-    initializeObjects();
+    if (m_blockTimesteps && m_integrationMethod != IntegrationMethod::LEAPFROG) {
+        Logger::getInstance().log(Logger::Level::WARNING, 
+            "physics.blockTimesteps only applies to the leapfrog integrator, using a global step");
+    }
+    
+    // Parse force solver from config
+    std::string solverStr = config.getString("physics.forceSolver", "direct");
+    if (solverStr == "barnes_hut") {
+        m_forceSolver = ForceSolver::BARNES_HUT;
+    } else {
+        m_forceSolver = ForceSolver::DIRECT;
+    }
+    
+    m_threadCollisions.resize(m_taskPool->getWorkerCount());
+    m_threadInteractions.resize(m_taskPool->getWorkerCount());
+    m_particles.configureTrails(
+        static_cast<size_t>(std::max(1, config.getInt("trails.length", 100))),
+        static_cast<size_t>(std::max(1, config.getInt("trails.sampleInterval", 1))));
+    
+    // Defaults are only created when the configured source added nothing
     loadObjectsFromConfig();
+    initializeObjects();
+    
+    std::string restorePath = config.getString("snapshot.restore", "");
+    if (!restorePath.empty()) {
+        restoreSnapshot(restorePath);
+    }
     
     Logger::getInstance().log(Logger::Level::INFO, 
-        "Physics system initialized with " + std::to_string(m_objects.size()) + 
-        " objects, integration method: " + integrationMethodToString(m_integrationMethod));
+        "Physics system initialized with " + std::to_string(m_particles.size()) + 
+        " objects, integration method: " + integrationMethodToString(m_integrationMethod) + 
+        ", force solver: " + forceSolverToString(m_forceSolver) +
+        ", gravity kernel: " + GravityKernel::isaToString(GravityKernel::getIsa()));
 }
 
 void Physics::update(float deltaTime) {
@@ -55,56 +117,61 @@ void Physics::update(float deltaTime) {
     m_simulationTime += deltaTime;
     m_stepCount++;
     
+    // Integrate motion using selected method (evaluates gravity as needed)
+    integrateMotion(deltaTime);
+    
     if (m_gravityEnabled) {
-        // Calculate all gravitational forces
-        calculateGravitationalForces();
-        applyBlackHoleGravity();
-        
-        // Integrate motion using selected method
-        integrateMotion(deltaTime);
-        
         // Handle collisions and cleanup
         handleCollisions();
         removeSwallowedObjects();
     }
     
-    // Update all objects
-    for (auto& object : m_objects) {
-        object.updatePhysics(deltaTime);
-    }
+    // Update position history for trails
+    m_particles.recordTrails();
     
     // Log performance info occasionally
     if (m_stepCount % 3600 == 0) { // Every 60 seconds at 60 FPS
-        Logger::getInstance().log(Logger::Level::DEBUG, 
-            "Physics: " + std::to_string(m_stepCount) + " steps, " + 
-            std::to_string(m_simulationTime) + "s simulated");
+        std::string message = "Physics: " + std::to_string(m_stepCount) + " steps, " + 
+            std::to_string(m_simulationTime) + "s simulated";
+        
+        if (m_blockTimesteps && m_integrationMethod == IntegrationMethod::LEAPFROG) {
+            std::vector<size_t> bodiesPerLevel(m_maxBlockLevel + 1, 0);
+            for (uint8_t level : m_particles.getTimestepLevels()) bodiesPerLevel[level]++;
+            
+            message += ", bodies per block level:";
+            for (size_t level = 0; level < bodiesPerLevel.size(); ++level) {
+                if (bodiesPerLevel[level] == 0) continue;
+                message += " " + std::to_string(level) + "=" + std::to_string(bodiesPerLevel[level]);
+            }
+        }
+        Logger::getInstance().log(Logger::Level::DEBUG, message);
     }
 }
 
-void Physics::addObject(const Object& object) {
-    if (m_objects.size() >= 16) {  // Limit for GPU uniform buffer
-        Logger::getInstance().log(Logger::Level::WARNING, 
-            "Cannot add object: maximum limit of 16 objects reached");
-        return;
-    }
-    
-    m_objects.push_back(object);
+BodyHandle Physics::addObject(const Object& object) {
+    BodyHandle handle = m_particles.add(object);
+    m_accelerationsValid = false;
     Logger::getInstance().log(Logger::Level::INFO, 
         "Object '" + object.getName() + "' added to physics simulation");
+    return handle;
 }
 
-void Physics::removeObject(size_t index) {
-    if (index >= m_objects.size()) return;
+bool Physics::removeObject(BodyHandle handle) {
+    size_t index = m_particles.indexOf(handle);
+    if (index == ParticleStore::INVALID_INDEX) return false;
     
-    std::string name = m_objects[index].getName();
-    m_objects.erase(m_objects.begin() + index);
+    std::string name = m_particles.getName(index);
+    m_particles.remove(index);
+    m_accelerationsValid = false;
     Logger::getInstance().log(Logger::Level::INFO, 
         "Object '" + name + "' removed from physics simulation");
+    return true;
 }
 
 void Physics::clearObjects() {
-    size_t count = m_objects.size();
-    m_objects.clear();
+    size_t count = m_particles.size();
+    m_particles.clear();
+    m_accelerationsValid = false;
     Logger::getInstance().log(Logger::Level::INFO, 
         "Cleared " + std::to_string(count) + " objects from physics simulation");
 }
@@ -114,14 +181,84 @@ void Physics::resetSimulation() {
     m_stepCount = 0;
     
     // Reset all objects to initial state (would need to store initial conditions)
-    for (auto& object : m_objects) {
-        object.setVelocity(glm::vec3(0.0f));
-        object.resetForces();
-    }
+    auto& velocities = m_particles.getVelocities();
+    auto& accelerations = m_particles.getAccelerations();
+    std::fill(velocities.begin(), velocities.end(), glm::vec3(0.0f));
+    std::fill(accelerations.begin(), accelerations.end(), glm::vec3(0.0f));
+    m_accelerationsValid = false;
     
     Logger::getInstance().log(Logger::Level::INFO, "Physics simulation reset");
 }
 
+void Physics::encodeSnapshot(std::vector<unsigned char>& out) const {
+    SnapshotFile::State state;
+    state.stepCount = m_stepCount;
+    state.simulationTime = m_simulationTime;
+    state.blackHoleMass = m_blackHole.getMass();
+    state.blackHolePosition = m_blackHole.getPosition();
+    state.accelerationsValid = m_accelerationsValid;
+    SnapshotFile::encode(m_particles, state, out);
+}
+
+bool Physics::saveSnapshot(const std::string& path) const {
+    std::vector<unsigned char> bytes;
+    encodeSnapshot(bytes);
+    if (!SnapshotFile::write(path, bytes)) {
+        Logger::getInstance().log(Logger::Level::ERROR, "Failed to write snapshot " + path);
+        return false;
+    }
+    return true;
+}
+
+bool Physics::restoreSnapshot(const std::string& path) {
+    SnapshotFile file;
+    std::string error;
+    if (!file.open(path, error)) {
+        Logger::getInstance().log(Logger::Level::ERROR, 
+            "Cannot restore snapshot " + path + ": " + error);
+        return false;
+    }
+    
+    using Section = SnapshotFile::Section;
+    const size_t count = static_cast<size_t>(file.getHeader().bodyCount);
+    
+    m_particles.clear();
+    m_particles.append(count,
+                       file.section<glm::vec3>(Section::POSITIONS),
+                       file.section<glm::vec3>(Section::VELOCITIES),
+                       file.section<double>(Section::MASSES),
+                       file.section<float>(Section::RADII),
+                       file.section<uint8_t>(Section::ACTIVE));
+    std::copy_n(file.section<glm::vec3>(Section::ACCELERATIONS), count, m_particles.getAccelerations().begin());
+    
+    const uint8_t* levels = file.section<uint8_t>(Section::LEVELS);
+    const uint8_t* types = file.section<uint8_t>(Section::TYPES);
+    const glm::vec4* colors = file.section<glm::vec4>(Section::COLORS);
+    auto& storeLevels = m_particles.getTimestepLevels();
+    for (size_t i = 0; i < count; ++i) {
+        storeLevels[i] = static_cast<uint8_t>(std::min<int>(levels[i], m_maxBlockLevel));
+        
+        ParticleStore::ParticleInfo& info = m_particles.getInfo(i);
+        info.name = std::string(file.getName(i));
+        info.color = colors[i];
+        info.type = types[i] <= static_cast<uint8_t>(Object::Type::TEST_MASS)
+            ? static_cast<Object::Type>(types[i]) : Object::Type::PLANET;
+    }
+    
+    SnapshotFile::State state = file.getState();
+    m_stepCount = static_cast<size_t>(state.stepCount);
+    m_simulationTime = state.simulationTime;
+    m_blackHole.setMass(state.blackHoleMass);
+    m_blackHole.setPosition(state.blackHolePosition);
+    m_accelerationsValid = state.accelerationsValid;
+    m_octreeCurrent = false;
+    
+    Logger::getInstance().log(Logger::Level::INFO, 
+        "Restored " + std::to_string(count) + " objects from " + path + " at step " + 
+        std::to_string(m_stepCount) + " (" + std::to_string(m_simulationTime) + "s simulated)");
+    return true;
+}
+
 void Physics::processKeyboard(int key, int action, int mods) {
     if (action == GLFW_PRESS) {
         switch (key) {
@@ -158,47 +295,78 @@ double Physics::getTotalEnergy() const {
 }
 
 double Physics::getKineticEnergy() const {
+    const auto& velocities = m_particles.getVelocities();
+    const auto& masses = m_particles.getMasses();
+    const auto& active = m_particles.getActiveFlags();
+    
     double totalKE = 0.0;
-    for (const auto& object : m_objects) {
-        if (object.isActive()) {
-            totalKE += object.getKineticEnergy();
+    for (size_t i = 0; i < m_particles.size(); ++i) {
+        if (active[i] && masses[i] > 0.0) {
+            double speedSquared = static_cast<double>(glm::dot(velocities[i], velocities[i]));
+            totalKE += 0.5 * masses[i] * speedSquared;
         }
     }
     return totalKE;
 }
 
 double Physics::getPotentialEnergy() const {
-    double totalPE = 0.0;
+    const auto& positions = m_particles.getPositions();
+    const auto& masses = m_particles.getMasses();
+    const auto& active = m_particles.getActiveFlags();
+    const size_t count = m_particles.size();
     
-    // Gravitational potential energy between all pairs of objects
-    for (size_t i = 0; i < m_objects.size(); ++i) {
-        const auto& obj1 = m_objects[i];
-        if (!obj1.isActive()) continue;
-        
-        // Potential energy with black hole
-        double distance = glm::length(obj1.getPosition() - m_blackHole.getPosition());
-        if (distance > 0.0) {
-            totalPE -= m_G * m_blackHole.getMass() * obj1.getMass() / distance;
-        }
+    const double softeningSquared = static_cast<double>(m_softening) * m_softening;
+    
+    Octree octree;
+    if (m_forceSolver == ForceSolver::BARNES_HUT) {
+        octree.build(positions, masses, active);
+    }
+    
+    // Per-worker partial sums, added in worker order
+    std::vector<double> partialPE(m_taskPool->getWorkerCount(), 0.0);
+    
+    m_taskPool->parallelFor(0, count, PAIR_GRAIN, [&](size_t begin, size_t end, size_t worker) {
+        double pe = 0.0;
         
-        // Potential energy with other objects
-        for (size_t j = i + 1; j < m_objects.size(); ++j) {
-            const auto& obj2 = m_objects[j];
-            if (!obj2.isActive()) continue;
+        for (size_t i = begin; i < end; ++i) {
+            if (!active[i]) continue;
             
-            distance = obj1.getDistanceTo(obj2);
+            // Potential energy with black hole
+            double distance = glm::length(positions[i] - m_blackHole.getPosition());
             if (distance > 0.0) {
-                totalPE -= m_G * obj1.getMass() * obj2.getMass() / distance;
+                pe -= m_G * m_blackHole.getMass() * masses[i] / distance;
+            }
+            
+            // Potential energy with other objects
+            if (m_forceSolver == ForceSolver::DIRECT) {
+                for (size_t j = i + 1; j < count; ++j) {
+                    if (!active[j]) continue;
+                    
+                    glm::vec3 displacement = positions[j] - positions[i];
+                    distance = std::sqrt(static_cast<double>(glm::dot(displacement, displacement)) + softeningSquared);
+                    if (distance > 0.0) {
+                        pe -= m_G * masses[i] * masses[j] / distance;
+                    }
+                }
+            } else {
+                // Each pair appears twice in the per-body potentials, hence the 1/2
+                pe += 0.5 * masses[i] * octree.computePotential(i, m_G, m_theta, m_softening * m_softening);
             }
         }
-    }
+        
+        partialPE[worker] += pe;
+    });
     
+    double totalPE = 0.0;
+    for (double pe : partialPE) {
+        totalPE += pe;
+    }
     return totalPE;
 }
 
 void Physics::initializeObjects() {
     // Create some default test objects if none exist
-    if (m_objects.empty()) {
+    if (m_particles.empty()) {
         // Add default test objects
         Object star1(
             glm::vec3(4e11f, 0.0f, 0.0f),    // Position
@@ -226,70 +394,300 @@ void Physics::initializeObjects() {
 }
 
 void Physics::loadObjectsFromConfig() {
-    // This would load objects from the JSON configuration
-    // For now, we use the default objects created in initializeObjects()
-    Logger::getInstance().log(Logger::Level::DEBUG, 
-        "Loading objects from configuration (using defaults for now)");
+    const std::string source = m_config.getString("initialConditions.source", "default");
+    if (source == "default") return;
+    
+    if (source == "config") {
+        loadConfigObjects();
+        return;
+    }
+    
+    const auto start = std::chrono::steady_clock::now();
+    const std::string file = m_config.getString("initialConditions.file", "");
+    const uint64_t seed = static_cast<uint64_t>(std::max(0, m_config.getInt("initialConditions.seed", 1)));
+    const size_t count = static_cast<size_t>(std::max(0, m_config.getInt("initialConditions.count", 10000)));
+    const float bodyRadius = m_config.getFloat("initialConditions.bodyRadius", 1.0e9f);
+    
+    InitialConditions::Bodies bodies;
+    Object::Type type = Object::Type::PLANET;
+    std::string namePrefix = "Body";
+    
+    if (source == "snapshot") {
+        // A snapshot used as a starting point, so the run starts its own clock
+        if (restoreSnapshot(file)) {
+            m_simulationTime = 0.0;
+            m_stepCount = 0;
+        }
+        return;
+    } else if (source == "csv") {
+        std::string error;
+        if (!InitialConditions::loadCsv(file, bodyRadius, *m_taskPool, bodies, error)) {
+            Logger::getInstance().log(Logger::Level::ERROR, 
+                "Cannot load initial conditions from " + file + ": " + error);
+            return;
+        }
+    } else if (source == "plummer") {
+        InitialConditions::PlummerParams params;
+        params.count = count;
+        params.seed = seed;
+        params.bodyRadius = bodyRadius;
+        params.totalMass = m_config.getDouble("initialConditions.plummer.totalMass", params.totalMass);
+        params.scaleRadius = m_config.getDouble("initialConditions.plummer.scaleRadius", params.scaleRadius);
+        std::vector<double> center = m_config.getDoubleArray("initialConditions.plummer.center", {4e11, 0.0, 0.0});
+        if (center.size() == 3) params.center = glm::vec3(center[0], center[1], center[2]);
+        
+        // By default the sphere's center moves on a circular orbit around the black hole
+        if (m_config.getBool("initialConditions.plummer.orbitBlackHole", true)) {
+            glm::dvec3 offset = glm::dvec3(params.center) - glm::dvec3(m_blackHole.getPosition());
+            double distance = std::sqrt(offset.x * offset.x + offset.z * offset.z);
+            if (distance > 0.0) {
+                double speed = std::sqrt(m_G * m_blackHole.getMass() / distance);
+                params.bulkVelocity = glm::vec3(glm::dvec3(-offset.z, 0.0, offset.x) * (speed / distance));
+            }
+        }
+        
+        InitialConditions::generatePlummer(params, m_G, *m_taskPool, bodies);
+        type = Object::Type::STAR;
+        namePrefix = "Plummer";
+    } else if (source == "disk") {
+        InitialConditions::DiskParams params;
+        params.count = count;
+        params.seed = seed;
+        params.bodyRadius = bodyRadius;
+        params.innerRadius = m_config.getDouble("initialConditions.disk.innerRadius", params.innerRadius);
+        params.outerRadius = m_config.getDouble("initialConditions.disk.outerRadius", params.outerRadius);
+        params.thickness = m_config.getDouble("initialConditions.disk.thickness", params.thickness);
+        params.bodyMass = m_config.getDouble("initialConditions.disk.bodyMass", params.bodyMass);
+        
+        InitialConditions::generateDisk(params, m_blackHole.getPosition(), m_blackHole.getMass(), m_G,
+                                        *m_taskPool, bodies);
+        type = Object::Type::ASTEROID;
+        namePrefix = "Disk";
+    } else {
+        Logger::getInstance().log(Logger::Level::WARNING, 
+            "Unknown initialConditions.source '" + source + "', using the default objects");
+        return;
+    }
+    
+    addBodies(bodies, type, namePrefix);
+    
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    Logger::getInstance().log(Logger::Level::INFO, 
+        "Loaded " + std::to_string(bodies.size()) + " objects from " + source + 
+        (source == "csv" ? " " + file : std::string()) + " in " + std::to_string(elapsed) + " ms");
 }
 
-void Physics::calculateGravitationalForces() {
-    // Calculate forces between all pairs of objects
-    for (size_t i = 0; i < m_objects.size(); ++i) {
-        auto& obj1 = m_objects[i];
-        if (!obj1.isActive()) continue;
-        
-        for (size_t j = i + 1; j < m_objects.size(); ++j) {
-            auto& obj2 = m_objects[j];
-            if (!obj2.isActive()) continue;
-            
-            // Calculate gravitational force between obj1 and obj2
-            glm::vec3 displacement = obj2.getPosition() - obj1.getPosition();
-            double distance = glm::length(displacement);
+void Physics::loadConfigObjects() {
+    const nlohmann::json& json = m_config.getJson();
+    auto objects = json.find("objects");
+    if (objects == json.end() || !objects->is_array()) {
+        Logger::getInstance().log(Logger::Level::WARNING, 
+            "initialConditions.source is 'config' but there is no objects array");
+        return;
+    }
+    
+    auto readVec = [](const nlohmann::json& entry, const char* key, std::vector<double> fallback) {
+        std::vector<double> value = entry.value(key, fallback);
+        return value.size() >= fallback.size() ? value : fallback;
+    };
+    
+    for (const nlohmann::json& entry : *objects) {
+        try {
+            std::vector<double> position = readVec(entry, "position", {0.0, 0.0, 0.0});
+            std::vector<double> velocity = readVec(entry, "velocity", {0.0, 0.0, 0.0});
+            std::vector<double> color = readVec(entry, "color", {1.0, 1.0, 1.0, 1.0});
             
-            if (distance > 0.0) {
-                // F = G * m1 * m2 / r²
-                double forceMagnitude = m_G * obj1.getMass() * obj2.getMass() / (distance * distance);
-                glm::vec3 forceDirection = glm::normalize(displacement);
-                glm::vec3 force = forceDirection * static_cast<float>(forceMagnitude);
-                
-                // Apply equal and opposite forces (Newton's 3rd law)
-                obj1.applyForce(force);
-                obj2.applyForce(-force);
+            Object object(
+                glm::vec3(position[0], position[1], position[2]),
+                glm::vec3(velocity[0], velocity[1], velocity[2]),
+                entry.value("mass", 1.0e24),
+                entry.value("radius", 1.0e9f),
+                glm::vec4(color[0], color[1], color[2], color[3]),
+                entry.value("name", std::string("Object")),
+                Object::Type::PLANET
+            );
+            addObject(object);
+        } catch (const nlohmann::json::exception& e) {
+            Logger::getInstance().log(Logger::Level::WARNING, 
+                std::string("Skipping malformed entry in objects: ") + e.what());
+        }
+    }
+}
+
+void Physics::addBodies(const InitialConditions::Bodies& bodies, Object::Type type,
+                        const std::string& namePrefix) {
+    const size_t count = bodies.size();
+    const std::vector<uint8_t> active(count, 1);
+    const size_t first = m_particles.append(count, bodies.positions.data(), bodies.velocities.data(),
+                                            bodies.masses.data(), bodies.radii.data(), active.data());
+    
+    for (size_t i = 0; i < count; ++i) {
+        ParticleStore::ParticleInfo& info = m_particles.getInfo(first + i);
+        info.name = bodies.names.empty() ? namePrefix + " " + std::to_string(i) : bodies.names[i];
+        info.color = bodies.colors[i];
+        info.type = type;
+    }
+    m_accelerationsValid = false;
+}
+
+void Physics::computeAccelerations(const std::vector<glm::vec3>& positions,
+                                   std::vector<glm::vec3>& accelerations,
+                                   const std::vector<uint32_t>* targets) {
+    if (targets) {
+        for (uint32_t i : *targets) accelerations[i] = glm::vec3(0.0f);
+    } else {
+        std::fill(accelerations.begin(), accelerations.end(), glm::vec3(0.0f));
+    }
+    
+    if (m_gravityEnabled) {
+        calculateGravitationalForces(positions, accelerations, targets);
+        applyBlackHoleGravity(positions, accelerations, targets);
+    }
+}
+
+void Physics::calculateGravitationalForces(const std::vector<glm::vec3>& positions,
+                                           std::vector<glm::vec3>& accelerations,
+                                           const std::vector<uint32_t>* targets) {
+    ScopedTimer timer(Metrics::Id::Forces);
+    switch (m_forceSolver) {
+        case ForceSolver::DIRECT:
+            calculateDirectForces(positions, accelerations, targets);
+            break;
+        case ForceSolver::BARNES_HUT:
+            calculateBarnesHutForces(positions, accelerations, targets);
+            break;
+    }
+}
+
+void Physics::calculateDirectForces(const std::vector<glm::vec3>& positions,
+                                    std::vector<glm::vec3>& accelerations,
+                                    const std::vector<uint32_t>* targets) {
+    const auto& masses = m_particles.getMasses();
+    const auto& active = m_particles.getActiveFlags();
+    const size_t count = m_particles.size();
+    const float softeningSquared = m_softening * m_softening;
+    
+    // Pack sources once per evaluation; inactive bodies get zero strength
+    m_sources.resize(count);
+    for (size_t j = 0; j < count; ++j) {
+        m_sources.set(j, positions[j], active[j] ? static_cast<float>(m_G * masses[j]) : 0.0f);
+    }
+    
+    // Each target sweeps all sources, so workers write disjoint outputs
+    const size_t targetCount = targets ? targets->size() : count;
+    m_interactionCount += static_cast<uint64_t>(targetCount) * count;
+    m_taskPool->parallelFor(0, targetCount, TARGET_GRAIN, [&](size_t begin, size_t end, size_t) {
+        for (size_t k = begin; k < end; ++k) {
+            const size_t i = targets ? (*targets)[k] : k;
+            if (!active[i]) continue;
+            GravityKernel::accumulate(m_sources, 0, count, positions[i], softeningSquared, accelerations[i]);
+        }
+    });
+}
+
+void Physics::calculateBarnesHutForces(const std::vector<glm::vec3>& positions,
+                                       std::vector<glm::vec3>& accelerations,
+                                       const std::vector<uint32_t>* targets) {
+    const auto& active = m_particles.getActiveFlags();
+    const float softeningSquared = m_softening * m_softening;
+    
+    {
+        ScopedTimer timer(Metrics::Id::OctreeBuild);
+        m_octree.build(positions, m_particles.getMasses(), active);
+    }
+    
+    // Tree walks only read the tree, so bodies are independent
+    const size_t targetCount = targets ? targets->size() : m_particles.size();
+    std::fill(m_threadInteractions.begin(), m_threadInteractions.end(), 0);
+    m_taskPool->parallelFor(0, targetCount, BODY_GRAIN / 4, [&](size_t begin, size_t end, size_t worker) {
+        uint64_t interactions = 0;
+        for (size_t k = begin; k < end; ++k) {
+            const size_t i = targets ? (*targets)[k] : k;
+            if (!active[i]) continue;
+            accelerations[i] += m_octree.computeAcceleration(i, m_G, m_theta, softeningSquared, &interactions);
+        }
+        m_threadInteractions[worker] += interactions;
+    });
+    for (uint64_t interactions : m_threadInteractions) {
+        m_interactionCount += interactions;
+    }
+}
+
+void Physics::computeDriftedAccelerations(const std::vector<glm::vec3>& positions,
+                                         std::vector<glm::vec3>& accelerations,
+                                         const std::vector<uint32_t>& targets, float time) {
+    const float softeningSquared = m_softening * m_softening;
+    
+    {
+        ScopedTimer timer(Metrics::Id::Forces);
+        std::fill(m_threadInteractions.begin(), m_threadInteractions.end(), 0);
+        m_taskPool->parallelFor(0, targets.size(), BODY_GRAIN / 4, [&](size_t begin, size_t end, size_t worker) {
+            uint64_t interactions = 0;
+            for (size_t k = begin; k < end; ++k) {
+                const uint32_t i = targets[k];
+                accelerations[i] = m_octree.computeDriftedAcceleration(i, positions[i], time, m_G, m_theta,
+                                                                       softeningSquared, &interactions);
             }
+            m_threadInteractions[worker] += interactions;
+        });
+        for (uint64_t interactions : m_threadInteractions) {
+            m_interactionCount += interactions;
         }
     }
+    
+    applyBlackHoleGravity(positions, accelerations, &targets);
 }
 
-void Physics::applyBlackHoleGravity() {
+void Physics::applyBlackHoleGravity(const std::vector<glm::vec3>& positions,
+                                    std::vector<glm::vec3>& accelerations,
+                                    const std::vector<uint32_t>* targets) {
     glm::vec3 blackHolePos = m_blackHole.getPosition();
     double blackHoleMass = m_blackHole.getMass();
+    double minDistance = m_blackHole.getSchwarzschildRadius() * 0.1;
     
-    for (auto& object : m_objects) {
-        if (!object.isActive()) continue;
-        
-        glm::vec3 displacement = blackHolePos - object.getPosition();
-        double distance = glm::length(displacement);
-        
-        // Don't apply force if too close (avoid singularity)
-        double minDistance = m_blackHole.getSchwarzschildRadius() * 0.1;
-        if (distance > minDistance) {
-            // F = G * M * m / r²
-            double forceMagnitude = m_G * blackHoleMass * object.getMass() / (distance * distance);
-            glm::vec3 forceDirection = glm::normalize(displacement);
-            glm::vec3 force = forceDirection * static_cast<float>(forceMagnitude);
+    const auto& active = m_particles.getActiveFlags();
+    
+    const size_t targetCount = targets ? targets->size() : m_particles.size();
+    m_taskPool->parallelFor(0, targetCount, BODY_GRAIN, [&](size_t begin, size_t end, size_t) {
+        for (size_t k = begin; k < end; ++k) {
+            const size_t i = targets ? (*targets)[k] : k;
+            if (!active[i]) continue;
             
-            object.applyForce(force);
+            glm::vec3 displacement = blackHolePos - positions[i];
+            double distance = glm::length(displacement);
+            
+            // Don't apply force if too close (avoid singularity)
+            if (distance > minDistance) {
+                // a = G * M / r²
+                double acceleration = m_G * blackHoleMass / (distance * distance);
+                glm::vec3 direction = glm::normalize(displacement);
+                accelerations[i] += direction * static_cast<float>(acceleration);
+            }
         }
-    }
+    });
 }
 
 void Physics::integrateMotion(float deltaTime) {
+    // Keep scratch buffers sized to the system; only reallocates when bodies are added
+    const size_t count = m_particles.size();
+    m_stagePositions.resize(count);
+    m_stageVelocities.resize(count);
+    m_stageAccelerations.resize(count);
+    m_velocitySum.resize(count);
+    m_accelerationSum.resize(count);
+    const bool treeCurrent = m_octreeCurrent;
+    m_octreeCurrent = false;
+    
     switch (m_integrationMethod) {
         case IntegrationMethod::EULER:
             integrateEuler(deltaTime);
             break;
         case IntegrationMethod::LEAPFROG:
-            integrateLeapfrog(deltaTime);
+            if (m_blockTimesteps) {
+                integrateBlockLeapfrog(deltaTime, treeCurrent);
+            } else {
+                integrateLeapfrog(deltaTime);
+            }
             break;
         case IntegrationMethod::RK4:
             integrateRK4(deltaTime);
@@ -298,73 +696,341 @@ void Physics::integrateMotion(float deltaTime) {
 }
 
 void Physics::integrateEuler(float deltaTime) {
-    // Simple Euler integration (handled by Object::updatePhysics)
-    // This is the default behavior, so we don't need to do anything special here
+    // Semi-implicit Euler: v = v₀ + a(x₀)t, then x = x₀ + vt
+    auto& positions = m_particles.getPositions();
+    auto& velocities = m_particles.getVelocities();
+    auto& accelerations = m_particles.getAccelerations();
+    const auto& active = m_particles.getActiveFlags();
+    
+    computeAccelerations(positions, accelerations);
+    
+    for (size_t i = 0; i < m_particles.size(); ++i) {
+        if (!active[i]) continue;
+        
+        velocities[i] += accelerations[i] * deltaTime;
+        positions[i] += velocities[i] * deltaTime;
+    }
+    
+    // Accelerations belong to the pre-step positions
+    m_accelerationsValid = false;
 }
 
 void Physics::integrateLeapfrog(float deltaTime) {
-    // Leapfrog integration - better for orbital mechanics
-    // For now, fallback to Euler (could be improved)
-    integrateEuler(deltaTime);
+    // Kick-drift-kick leapfrog: symplectic, one force evaluation per step
+    auto& positions = m_particles.getPositions();
+    auto& velocities = m_particles.getVelocities();
+    auto& accelerations = m_particles.getAccelerations();
+    const auto& active = m_particles.getActiveFlags();
+    const size_t count = m_particles.size();
+    const float halfStep = 0.5f * deltaTime;
+    
+    // Reuse a(xₙ) from the previous step's closing kick when it is still valid
+    if (!m_accelerationsValid) {
+        computeAccelerations(positions, accelerations);
+    }
+    
+    // Half kick and full drift
+    for (size_t i = 0; i < count; ++i) {
+        if (!active[i]) continue;
+        
+        velocities[i] += accelerations[i] * halfStep;
+        positions[i] += velocities[i] * deltaTime;
+    }
+    
+    // Closing half kick with a(xₙ₊₁)
+    computeAccelerations(positions, accelerations);
+    
+    for (size_t i = 0; i < count; ++i) {
+        if (!active[i]) continue;
+        velocities[i] += accelerations[i] * halfStep;
+    }
+    
+    // The closing kick built the tree at xₙ₊₁, which is what collision detection looks at
+    m_accelerationsValid = true;
+    m_octreeCurrent = m_gravityEnabled && m_forceSolver == ForceSolver::BARNES_HUT;
+}
+
+void Physics::integrateBlockLeapfrog(float deltaTime, bool treeCurrent) {
+    // Kick-drift-kick per body on nested power-of-two steps, counted in ticks of the finest step
+    auto& positions = m_particles.getPositions();
+    auto& velocities = m_particles.getVelocities();
+    auto& accelerations = m_particles.getAccelerations();
+    auto& levels = m_particles.getTimestepLevels();
+    const auto& active = m_particles.getActiveFlags();
+    const size_t count = m_particles.size();
+    const uint32_t ticks = 1u << m_maxBlockLevel;
+    const double tick = static_cast<double>(deltaTime) / ticks;
+    
+    // Without a previous step there is no jerk estimate yet, so levels come from |a| alone
+    if (!m_accelerationsValid) {
+        computeAccelerations(positions, accelerations);
+        for (size_t i = 0; i < count; ++i) {
+            levels[i] = chooseTimestepLevel(i, accelerations[i], 0.0, deltaTime);
+        }
+        treeCurrent = true;
+    }
+    
+    // Group bodies by level once; afterwards a body only moves when its level changes
+    m_levelBodies.resize(static_cast<size_t>(m_maxBlockLevel) + 1);
+    for (auto& bodies : m_levelBodies) bodies.clear();
+    m_levelSlots.resize(count);
+    m_driftTicks.assign(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        if (!active[i]) continue;
+        
+        // Every step starts at tick 0
+        velocities[i] += accelerations[i] * static_cast<float>(0.5 * (ticks >> levels[i]) * tick);
+        m_levelSlots[i] = static_cast<uint32_t>(m_levelBodies[levels[i]].size());
+        m_levelBodies[levels[i]].push_back(static_cast<uint32_t>(i));
+    }
+    
+    // Sub-steps walk the tree the last closing tick built, drifted forward, rather than a new one
+    const bool drifted = treeCurrent && m_gravityEnabled && m_forceSolver == ForceSolver::BARNES_HUT;
+    if (drifted) {
+        m_octree.setVelocities(velocities);
+    }
+    
+    auto driftTo = [&](uint32_t i, uint32_t t) {
+        positions[i] += velocities[i] * static_cast<float>((t - m_driftTicks[i]) * tick);
+        m_driftTicks[i] = t;
+    };
+    
+    uint32_t t = 0;
+    while (t < ticks) {
+        // The finest occupied level ends first, and every coarser boundary is also one of its
+        int finest = m_maxBlockLevel;
+        while (finest > 0 && m_levelBodies[finest].empty()) --finest;
+        const uint32_t span = ticks >> finest;
+        t = t - t % span + span;
+        
+        // Bodies whose step ends here are the levels whose span divides t
+        m_blockTargets.clear();
+        for (int level = m_maxBlockLevel; level >= 0 && t % (ticks >> level) == 0; --level) {
+            m_blockTargets.insert(m_blockTargets.end(), m_levelBodies[level].begin(), m_levelBodies[level].end());
+        }
+        
+        if (t == ticks || !drifted) {
+            // Direct sums read every position; the closing tick also rebuilds the tree for the next step
+            for (size_t i = 0; i < count; ++i) {
+                if (active[i]) driftTo(static_cast<uint32_t>(i), t);
+            }
+            if (t == ticks) {
+                computeAccelerations(positions, m_stageAccelerations);
+            } else {
+                computeAccelerations(positions, m_stageAccelerations, &m_blockTargets);
+            }
+        } else {
+            for (uint32_t i : m_blockTargets) driftTo(i, t);
+            computeDriftedAccelerations(positions, m_stageAccelerations, m_blockTargets,
+                                        static_cast<float>(t * tick));
+        }
+        
+        for (uint32_t i : m_blockTargets) {
+            const uint8_t previousLevel = levels[i];
+            const double stepLength = (ticks >> previousLevel) * tick;
+            const double jerk = glm::length(m_stageAccelerations[i] - accelerations[i]) / stepLength;
+            accelerations[i] = m_stageAccelerations[i];
+            glm::vec3 kick = accelerations[i] * static_cast<float>(0.5 * stepLength);
+            
+            // Finer steps fit any boundary; coarser ones go up one level, and only where that step would start
+            uint8_t level = chooseTimestepLevel(i, accelerations[i], jerk, deltaTime);
+            if (level < previousLevel) {
+                level = previousLevel - 1;
+                if (t % (ticks >> level) != 0) level = previousLevel;
+            }
+            levels[i] = level;
+            
+            if (t < ticks) {
+                // The next step starts where this one closed, so its opening half kick joins this kick
+                kick += accelerations[i] * static_cast<float>(0.5 * (ticks >> level) * tick);
+                if (drifted) {
+                    m_octree.kick(i, kick, static_cast<float>(t * tick));
+                }
+                if (level != previousLevel) {
+                    std::vector<uint32_t>& from = m_levelBodies[previousLevel];
+                    from[m_levelSlots[i]] = from.back();
+                    m_levelSlots[from.back()] = m_levelSlots[i];
+                    from.pop_back();
+                    m_levelSlots[i] = static_cast<uint32_t>(m_levelBodies[level].size());
+                    m_levelBodies[level].push_back(i);
+                }
+            }
+            velocities[i] += kick;
+        }
+    }
+    
+    // The last tick closed every body, so the tree was built at the synchronized positions
+    m_accelerationsValid = true;
+    m_octreeCurrent = m_gravityEnabled && m_forceSolver == ForceSolver::BARNES_HUT;
+}
+
+uint8_t Physics::chooseTimestepLevel(size_t index, const glm::vec3& acceleration, double jerk,
+                                     float deltaTime) const {
+    const double magnitude = glm::length(acceleration);
+    if (magnitude <= 0.0) return 0;
+    
+    double distance = glm::length(m_particles.getPositions()[index] - m_blackHole.getPosition());
+    distance = std::max(distance, static_cast<double>(m_blackHole.getSchwarzschildRadius()));
+    
+    double timescale = std::sqrt(distance / magnitude);
+    if (jerk > 0.0) {
+        timescale = std::min(timescale, magnitude / jerk);
+    }
+    
+    const double step = m_timestepAccuracy * timescale;
+    if (step >= deltaTime) return 0;
+    
+    const int level = static_cast<int>(std::ceil(std::log2(deltaTime / step)));
+    return static_cast<uint8_t>(std::clamp(level, 0, m_maxBlockLevel));
 }
 
 void Physics::integrateRK4(float deltaTime) {
-    // Runge-Kutta 4th order - most accurate but slower
-    // For now, fallback to Euler (could be improved with proper RK4 implementation)
-    integrateEuler(deltaTime);
+    // Classic four-stage Runge-Kutta over the whole system state (x, v)
+    auto& positions = m_particles.getPositions();
+    auto& velocities = m_particles.getVelocities();
+    auto& accelerations = m_particles.getAccelerations();
+    const auto& active = m_particles.getActiveFlags();
+    const size_t count = m_particles.size();
+    const float halfStep = 0.5f * deltaTime;
+    
+    // Stage 1: k₁ = (v, a(x))
+    computeAccelerations(positions, accelerations);
+    for (size_t i = 0; i < count; ++i) {
+        m_velocitySum[i] = velocities[i];
+        m_accelerationSum[i] = accelerations[i];
+        m_stagePositions[i] = positions[i] + velocities[i] * halfStep;
+        m_stageVelocities[i] = velocities[i] + accelerations[i] * halfStep;
+    }
+    
+    // Stages 2 and 3 evaluate at the midpoint; weights 2 in the final sum
+    for (int stage = 2; stage <= 3; ++stage) {
+        computeAccelerations(m_stagePositions, m_stageAccelerations);
+        const float stageStep = (stage == 2) ? halfStep : deltaTime;
+        
+        for (size_t i = 0; i < count; ++i) {
+            m_velocitySum[i] += 2.0f * m_stageVelocities[i];
+            m_accelerationSum[i] += 2.0f * m_stageAccelerations[i];
+            
+            glm::vec3 stageVelocity = m_stageVelocities[i];
+            m_stagePositions[i] = positions[i] + stageVelocity * stageStep;
+            m_stageVelocities[i] = velocities[i] + m_stageAccelerations[i] * stageStep;
+        }
+    }
+    
+    // Stage 4 evaluates at the end of the step
+    computeAccelerations(m_stagePositions, m_stageAccelerations);
+    
+    const float sixthStep = deltaTime / 6.0f;
+    for (size_t i = 0; i < count; ++i) {
+        if (!active[i]) continue;
+        
+        m_velocitySum[i] += m_stageVelocities[i];
+        m_accelerationSum[i] += m_stageAccelerations[i];
+        
+        positions[i] += m_velocitySum[i] * sixthStep;
+        velocities[i] += m_accelerationSum[i] * sixthStep;
+    }
+    
+    m_accelerationsValid = false;
 }
 
 void Physics::handleCollisions() {
-    for (size_t i = 0; i < m_objects.size(); ++i) {
-        auto& obj1 = m_objects[i];
-        if (!obj1.isActive()) continue;
+    ScopedTimer timer(Metrics::Id::Collisions);
+    const auto& positions = m_particles.getPositions();
+    const auto& masses = m_particles.getMasses();
+    const auto& radii = m_particles.getRadii();
+    auto& active = m_particles.getActiveFlags();
+    const size_t count = m_particles.size();
+    
+    // Broad phase: only bodies in nearby cells (or tree nodes) reach the distance test.
+    // Both run in parallel against the pre-collision state.
+    if (m_octreeCurrent && m_octree.containsAllActive()) {
+        float maxRadius = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            if (active[i]) maxRadius = std::max(maxRadius, radii[i]);
+        }
         
-        for (size_t j = i + 1; j < m_objects.size(); ++j) {
-            auto& obj2 = m_objects[j];
-            if (!obj2.isActive()) continue;
-            
-            if (obj1.isCollidingWith(obj2)) {
-                Logger::getInstance().log(Logger::Level::INFO, 
-                    "Collision detected between '" + obj1.getName() + "' and '" + obj2.getName() + "'");
-                
-                // Simple collision response - merge objects
-                if (obj1.getMass() >= obj2.getMass()) {
-                    // obj1 absorbs obj2
-                    obj2.setActive(false);
-                } else {
-                    // obj2 absorbs obj1
-                    obj1.setActive(false);
-                }
+        m_taskPool->parallelFor(0, count, CONTACT_GRAIN, [&](size_t begin, size_t end, size_t worker) {
+            for (size_t i = begin; i < end; ++i) {
+                if (!active[i]) continue;
+                m_octree.findOverlaps(i, radii, maxRadius, m_threadCollisions[worker]);
             }
+        });
+    } else {
+        m_collisionGrid.build(positions, radii, active);
+        m_taskPool->parallelFor(0, m_collisionGrid.size(), CONTACT_GRAIN, [&](size_t begin, size_t end, size_t worker) {
+            m_collisionGrid.findContacts(begin, end, radii, m_threadCollisions[worker]);
+        });
+    }
+    
+    std::vector<std::pair<uint32_t, uint32_t>>& contacts = m_threadCollisions[0];
+    for (size_t w = 1; w < m_threadCollisions.size(); ++w) {
+        contacts.insert(contacts.end(), m_threadCollisions[w].begin(), m_threadCollisions[w].end());
+        m_threadCollisions[w].clear();
+    }
+    
+    // Resolve in (i, j) order so merges match a sequential sweep regardless of thread count
+    std::sort(contacts.begin(), contacts.end());
+    
+    for (const auto& contact : contacts) {
+        size_t i = contact.first;
+        size_t j = contact.second;
+        if (!active[i] || !active[j]) continue;
+        
+        if (Logger::getInstance().isEnabled(Logger::Level::INFO)) {
+            Logger::getInstance().log(Logger::Level::INFO, 
+                "Collision detected between '" + m_particles.getName(i) + "' and '" + m_particles.getName(j) + "'");
+        }
+        
+        // Simple collision response - merge objects
+        if (masses[i] >= masses[j]) {
+            // Body i absorbs body j
+            active[j] = 0;
+        } else {
+            // Body j absorbs body i
+            active[i] = 0;
         }
     }
+    
+    contacts.clear();
 }
 
 void Physics::removeSwallowedObjects() {
-    auto it = m_objects.begin();
-    while (it != m_objects.end()) {
-        if (it->isActive() && m_blackHole.isInsideEventHorizon(it->getPosition())) {
-            Logger::getInstance().log(Logger::Level::INFO, 
-                "Object '" + it->getName() + "' crossed the event horizon and was absorbed");
-            it = m_objects.erase(it);
-        } else if (!it->isActive()) {
+    auto& active = m_particles.getActiveFlags();
+    const auto& positions = m_particles.getPositions();
+    const bool logAbsorbed = Logger::getInstance().isEnabled(Logger::Level::INFO);
+    const bool logRemoved = Logger::getInstance().isEnabled(Logger::Level::DEBUG);
+    
+    // Mark first, then compact once: each removal is a swap with the last body
+    for (size_t i = 0; i < m_particles.size(); ++i) {
+        if (active[i] && m_blackHole.isInsideEventHorizon(positions[i])) {
+            if (logAbsorbed) {
+                Logger::getInstance().log(Logger::Level::INFO, 
+                    "Object '" + m_particles.getName(i) + "' crossed the event horizon and was absorbed");
+            }
+            active[i] = 0;
+        } else if (!active[i] && logRemoved) {
             Logger::getInstance().log(Logger::Level::DEBUG, 
-                "Removing inactive object '" + it->getName() + "'");
-            it = m_objects.erase(it);
-        } else {
-            ++it;
+                "Removing inactive object '" + m_particles.getName(i) + "'");
         }
     }
+    
+    if (m_particles.removeInactive() > 0) {
+        m_accelerationsValid = false;
+    }
 }
 
 glm::vec3 Physics::calculateAcceleration(size_t objectIndex) const {
-    if (objectIndex >= m_objects.size()) return glm::vec3(0.0f);
+    if (objectIndex >= m_particles.size()) return glm::vec3(0.0f);
     
-    const auto& object = m_objects[objectIndex];
+    const auto& positions = m_particles.getPositions();
+    const auto& masses = m_particles.getMasses();
+    const auto& active = m_particles.getActiveFlags();
+    const glm::vec3 position = positions[objectIndex];
     glm::vec3 totalAcceleration(0.0f);
     
     // Acceleration from black hole
-    glm::vec3 displacement = m_blackHole.getPosition() - object.getPosition();
+    glm::vec3 displacement = m_blackHole.getPosition() - position;
     double distance = glm::length(displacement);
     
     if (distance > m_blackHole.getSchwarzschildRadius() * 0.1) {
@@ -374,15 +1040,14 @@ glm::vec3 Physics::calculateAcceleration(size_t objectIndex) const {
     }
     
     // Acceleration from other objects
-    for (size_t i = 0; i < m_objects.size(); ++i) {
-        if (i == objectIndex || !m_objects[i].isActive()) continue;
+    for (size_t i = 0; i < m_particles.size(); ++i) {
+        if (i == objectIndex || !active[i]) continue;
         
-        const auto& other = m_objects[i];
-        displacement = other.getPosition() - object.getPosition();
+        displacement = positions[i] - position;
         distance = glm::length(displacement);
         
         if (distance > 0.0) {
-            double acceleration = m_G * other.getMass() / (distance * distance);
+            double acceleration = m_G * masses[i] / (distance * distance);
             glm::vec3 direction = glm::normalize(displacement);
             totalAcceleration += direction * static_cast<float>(acceleration);
         }
@@ -398,4 +1063,12 @@ std::string Physics::integrationMethodToString(IntegrationMethod method) const {
         case IntegrationMethod::RK4: return "Runge-Kutta 4";
         default: return "Unknown";
     }
-}
\ No newline at end of file
+}
+
+std::string Physics::forceSolverToString(ForceSolver solver) const {
+    switch (solver) {
+        case ForceSolver::DIRECT: return "Direct";
+        case ForceSolver::BARNES_HUT: return "Barnes-Hut";
+        default: return "Unknown";
+    }
+}
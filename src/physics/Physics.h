@@ -10,6 +10,12 @@
 #include "../objects/Object.h"
 #include "../utils/Config.h"
 #include "BlackHole.h"
+#include "ParticleStore.h"
+#include "Octree.h"
+#include "CollisionGrid.h"
+#include "InitialConditions.h"
+#include "GravityKernel.h"
+#include "../engine/TaskPool.h"
 #include <string>
 #include <map>
 #include <GLFW/glfw3.h>
@@ -32,6 +38,14 @@ public:
         RK4             ///< Runge-Kutta 4th order (accurate, slower)
     };
     
+    /**
+     * @brief Algorithms for evaluating mutual gravity between bodies
+     */
+    enum class ForceSolver {
+        DIRECT,         ///< Exact O(N²) pairwise summation (accuracy reference)
+        BARNES_HUT      ///< O(N log N) octree approximation
+    };
+    
     /**
      * @brief Construct physics system
      * @param config Configuration object
@@ -45,10 +59,10 @@ public:
     void update(float deltaTime);
     
     /**
-     * @brief Get list of all objects in the simulation
-     * @return Reference to object list
+     * @brief Get the structure-of-arrays store of all bodies in the simulation
+     * @return Reference to the particle store
      */
-    const std::vector<Object>& getObjects() const { return m_objects; }
+    const ParticleStore& getParticles() const { return m_particles; }
     
     /**
      * @brief Get the central black hole
@@ -65,14 +79,16 @@ public:
     /**
      * @brief Add an object to the simulation
      * @param object Object to add
+     * @return Handle that keeps referring to the body across removals
      */
-    void addObject(const Object& object);
+    BodyHandle addObject(const Object& object);
     
     /**
      * @brief Remove an object from the simulation
-     * @param index Index of object to remove
+     * @param handle Handle of the object to remove
+     * @return True if the object still existed
      */
-    void removeObject(size_t index);
+    bool removeObject(BodyHandle handle);
     
     /**
      * @brief Clear all objects from the simulation
@@ -83,7 +99,7 @@ public:
      * @brief Enable or disable gravity simulation
      * @param enabled True to enable gravity
      */
-    void setGravityEnabled(bool enabled) { m_gravityEnabled = enabled; }
+    void setGravityEnabled(bool enabled) { m_gravityEnabled = enabled; m_accelerationsValid = false; }
     
     /**
      * @brief Check if gravity is currently enabled
@@ -94,7 +110,7 @@ public:
     /**
      * @brief Toggle gravity on/off
      */
-    void toggleGravity() { m_gravityEnabled = !m_gravityEnabled; }
+    void toggleGravity() { m_gravityEnabled = !m_gravityEnabled; m_accelerationsValid = false; }
     
     /**
      * @brief Set integration method
@@ -108,11 +124,75 @@ public:
      */
     IntegrationMethod getIntegrationMethod() const { return m_integrationMethod; }
     
+    /**
+     * @brief Set the mutual gravity solver
+     * @param solver Force solver to use
+     */
+    void setForceSolver(ForceSolver solver) { m_forceSolver = solver; m_accelerationsValid = false; }
+    
+    /**
+     * @brief Get current mutual gravity solver
+     * @return Current force solver
+     */
+    ForceSolver getForceSolver() const { return m_forceSolver; }
+    
+    /**
+     * @brief Get the fixed step length the simulation thread advances by
+     * @return Time step in seconds (physics.timeStep)
+     */
+    float getTimeStep() const { return m_timeStep; }
+    
+    /**
+     * @brief Get total simulated time
+     * @return Simulated time in seconds
+     */
+    double getSimulationTime() const { return m_simulationTime; }
+    
+    /**
+     * @brief Get number of steps taken
+     * @return Step count
+     */
+    size_t getStepCount() const { return m_stepCount; }
+    
+    /**
+     * @brief Get the number of force terms the solvers have evaluated so far
+     *
+     * The direct solver counts every target against every body; Barnes-Hut
+     * counts the leaf bucket sources and accepted node approximations its
+     * tree walks actually evaluated.
+     * @return Force terms since construction
+     */
+    uint64_t getInteractionCount() const { return m_interactionCount; }
+    
     /**
      * @brief Reset all objects to their initial positions and velocities
      */
     void resetSimulation();
     
+    /**
+     * @brief Serialize the bodies and simulation state as a snapshot file image
+     * @param out Receives the file bytes (reuses its capacity)
+     */
+    void encodeSnapshot(std::vector<unsigned char>& out) const;
+    
+    /**
+     * @brief Write a snapshot file synchronously
+     * @param path Destination path
+     * @return True on success
+     */
+    bool saveSnapshot(const std::string& path) const;
+    
+    /**
+     * @brief Replace all bodies and the simulation state with a snapshot
+     *
+     * The file is memory-mapped and its arrays copied straight into the
+     * particle store. Restoring with the same physics settings continues the
+     * run exactly where the snapshot was taken.
+     * @param path Snapshot path
+     * @return False if the file could not be read (the current state is kept)
+     */
+    bool restoreSnapshot(const std::string& path);
+    
     /**
      * @brief Process keyboard input for physics controls
      * @param key GLFW key code
@@ -141,18 +221,46 @@ public:
 
 private:
     Config m_config;                        ///< Configuration settings
-    std::vector<Object> m_objects;          ///< List of objects in simulation
+    ParticleStore m_particles;              ///< Bodies in simulation (SoA layout)
     BlackHole m_blackHole;                  ///< Central black hole
     
     // Physics parameters
     bool m_gravityEnabled;                  ///< Is gravity simulation enabled?
     IntegrationMethod m_integrationMethod; ///< Numerical integration method
+    ForceSolver m_forceSolver;              ///< Mutual gravity algorithm
+    float m_theta;                          ///< Barnes-Hut opening angle
+    float m_softening;                      ///< Plummer softening length (m)
     float m_timeStep;                       ///< Physics time step
     double m_G;                             ///< Gravitational constant
+    Octree m_octree;                        ///< Barnes-Hut tree, rebuilt every step
+    bool m_octreeCurrent;                   ///< m_octree was built from the post-step positions
+    CollisionGrid m_collisionGrid;          ///< Collision broad phase when the tree can't be reused
+    GravitySources m_sources;               ///< Packed positions and G·m for the direct solver
+    
+    // Parallel evaluation
+    std::unique_ptr<TaskPool> m_taskPool;   ///< Worker threads for force and collision passes
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> m_threadCollisions;  ///< Per-worker contact lists
+    std::vector<uint64_t> m_threadInteractions;  ///< Per-worker Barnes-Hut force terms (scratch)
+    
+    // Integrator state
+    bool m_accelerationsValid;              ///< Stored accelerations match current positions
+    bool m_blockTimesteps;                  ///< Leapfrog uses per-body power-of-two steps
+    int m_maxBlockLevel;                    ///< Finest block step is timeStep / 2^m_maxBlockLevel
+    float m_timestepAccuracy;               ///< Block step criterion factor (eta)
+    std::vector<uint32_t> m_blockTargets;   ///< Bodies whose block step ends at the current tick (scratch)
+    std::vector<std::vector<uint32_t>> m_levelBodies;  ///< Active bodies on each block level (scratch)
+    std::vector<uint32_t> m_levelSlots;     ///< Position of each body in its m_levelBodies list (scratch)
+    std::vector<uint32_t> m_driftTicks;     ///< Tick each body's position was last drifted to (scratch)
+    std::vector<glm::vec3> m_stagePositions;     ///< RK4 stage positions (scratch)
+    std::vector<glm::vec3> m_stageVelocities;    ///< RK4 stage velocities (scratch)
+    std::vector<glm::vec3> m_stageAccelerations; ///< RK4 stage accelerations (scratch)
+    std::vector<glm::vec3> m_velocitySum;        ///< RK4 weighted velocity sum (scratch)
+    std::vector<glm::vec3> m_accelerationSum;    ///< RK4 weighted acceleration sum (scratch)
     
     // Performance tracking
     double m_simulationTime;                ///< Total simulation time elapsed
     size_t m_stepCount;                     ///< Number of simulation steps
+    uint64_t m_interactionCount;            ///< Force terms evaluated by the force solvers
     
     /**
      * @brief Initialize physics system with default objects
@@ -160,19 +268,77 @@ private:
     void initializeObjects();
     
     /**
-     * @brief Load objects from configuration
+     * @brief Load objects from the configured initial-condition source
+     *
+     * initialConditions.source selects "default" (the built-in test bodies),
+     * "config" (the objects array), "csv" or "snapshot" (initialConditions.file),
+     * or a generated "plummer" sphere or Keplerian "disk".
      */
     void loadObjectsFromConfig();
     
     /**
-     * @brief Calculate gravitational forces between all objects
+     * @brief Add the bodies listed in the configuration's objects array
+     */
+    void loadConfigObjects();
+    
+    /**
+     * @brief Append a block of bodies to the particle store in one bulk copy
+     * @param bodies Bodies to add
+     * @param type Type given to every body
+     * @param namePrefix Prefix of the generated names when the block has none
+     */
+    void addBodies(const InitialConditions::Bodies& bodies, Object::Type type,
+                   const std::string& namePrefix);
+    
+    /**
+     * @brief Evaluate total accelerations of all bodies at the given positions
+     * @param positions Body positions to evaluate at
+     * @param accelerations Output accelerations (overwritten for the evaluated bodies)
+     * @param targets Dense indices of the bodies to evaluate (null = all bodies)
      */
-    void calculateGravitationalForces();
+    void computeAccelerations(const std::vector<glm::vec3>& positions,
+                              std::vector<glm::vec3>& accelerations,
+                              const std::vector<uint32_t>* targets = nullptr);
     
     /**
-     * @brief Apply gravitational force from black hole to objects
+     * @brief Accumulate mutual gravitational accelerations of all bodies
+     * @param positions Body positions to evaluate at
+     * @param accelerations Accelerations to add to
+     * @param targets Dense indices of the bodies to evaluate (null = all bodies)
      */
-    void applyBlackHoleGravity();
+    void calculateGravitationalForces(const std::vector<glm::vec3>& positions,
+                                      std::vector<glm::vec3>& accelerations,
+                                      const std::vector<uint32_t>* targets = nullptr);
+    
+    /**
+     * @brief Exact pairwise summation of mutual accelerations
+     * @param positions Body positions to evaluate at
+     * @param accelerations Accelerations to add to
+     * @param targets Dense indices of the bodies to evaluate (null = all bodies)
+     */
+    void calculateDirectForces(const std::vector<glm::vec3>& positions,
+                               std::vector<glm::vec3>& accelerations,
+                               const std::vector<uint32_t>* targets = nullptr);
+    
+    /**
+     * @brief Barnes-Hut approximation of mutual accelerations
+     * @param positions Body positions to evaluate at
+     * @param accelerations Accelerations to add to
+     * @param targets Dense indices of the bodies to evaluate (null = all bodies)
+     */
+    void calculateBarnesHutForces(const std::vector<glm::vec3>& positions,
+                                  std::vector<glm::vec3>& accelerations,
+                                  const std::vector<uint32_t>* targets = nullptr);
+    
+    /**
+     * @brief Accumulate gravitational acceleration from the black hole
+     * @param positions Body positions to evaluate at
+     * @param accelerations Accelerations to add to
+     * @param targets Dense indices of the bodies to evaluate (null = all bodies)
+     */
+    void applyBlackHoleGravity(const std::vector<glm::vec3>& positions,
+                               std::vector<glm::vec3>& accelerations,
+                               const std::vector<uint32_t>* targets = nullptr);
     
     /**
      * @brief Integrate object motion using selected method
@@ -192,6 +358,49 @@ private:
      */
     void integrateLeapfrog(float deltaTime);
     
+    /**
+     * @brief Leapfrog step with hierarchical block timesteps
+     *
+     * Each body advances with its own step deltaTime / 2^level, where the level
+     * comes from chooseTimestepLevel. Steps nest, so at any tick the bodies whose
+     * step ends there are closed with a force evaluation for just that subset.
+     * Everyone else drifts lazily: a body's position is only brought up to date
+     * when its own step ends. All bodies are synchronized again at deltaTime.
+     *
+     * With Barnes-Hut the tree is built once per step, by the closing evaluation
+     * at deltaTime; the sub-steps of the next step walk that tree drifted forward
+     * (see Octree::kick) instead of rebuilding it.
+     * @param deltaTime Time step (the coarsest block step)
+     * @param treeCurrent m_octree was built from the current positions
+     */
+    void integrateBlockLeapfrog(float deltaTime, bool treeCurrent);
+
+    /**
+     * @brief Accelerations of a few bodies against the drifted Barnes-Hut tree
+     * @param positions Body positions (only the targets' need to be current)
+     * @param accelerations Output, written for the targets only
+     * @param targets Bodies to evaluate
+     * @param time Time since the tree's velocities were recorded (s)
+     */
+    void computeDriftedAccelerations(const std::vector<glm::vec3>& positions,
+                                     std::vector<glm::vec3>& accelerations,
+                                     const std::vector<uint32_t>& targets, float time);
+    
+    /**
+     * @brief Pick the block level a body's next step should use
+     *
+     * The step is eta times the smaller of the acceleration timescale |a| / |ȧ|
+     * and the free-fall time sqrt(r / |a|) at the body's distance from the black
+     * hole, rounded down to a power-of-two fraction of deltaTime.
+     * @param index Dense body index
+     * @param acceleration Body acceleration at its current position
+     * @param jerk Magnitude of the acceleration change rate (0 if unknown)
+     * @param deltaTime Coarsest block step
+     * @return Level in [0, m_maxBlockLevel]
+     */
+    uint8_t chooseTimestepLevel(size_t index, const glm::vec3& acceleration, double jerk,
+                                float deltaTime) const;
+    
     /**
      * @brief Runge-Kutta 4th order integration step
      * @param deltaTime Time step
@@ -221,4 +430,11 @@ private:
      * @return Method name as string
      */
     std::string integrationMethodToString(IntegrationMethod method) const;
+    
+    /**
+     * @brief Get string representation of force solver
+     * @param solver Force solver
+     * @return Solver name as string
+     */
+    std::string forceSolverToString(ForceSolver solver) const;
 };
\ No newline at end of file
@@ -0,0 +1,339 @@
+/**
+ * @file SnapshotFile.cpp
+ * @brief Implementation of the binary snapshot format
+ */
+
+#include "SnapshotFile.h"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char MAGIC[8] = {'B', 'H', 'S', 'N', 'A', 'P', '\0', '\0'};
+
+/// Sections start on cache-line boundaries so mapped arrays are aligned for any element type
+constexpr size_t SECTION_ALIGNMENT = 64;
+
+static_assert(sizeof(SnapshotFile::Header) == 256, "Snapshot header layout changed");
+static_assert(sizeof(glm::vec3) == 12 && sizeof(glm::vec4) == 16, "glm vectors must be tightly packed");
+
+/**
+ * @brief Check that the host stores integers little-endian, as the format does
+ */
+bool isLittleEndian() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+/**
+ * @brief Slice-by-8 lookup tables for the IEEE CRC-32 polynomial
+ */
+const std::array<std::array<uint32_t, 256>, 8>& crcTables() {
+    static const auto tables = [] {
+        std::array<std::array<uint32_t, 256>, 8> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (size_t s = 1; s < 8; ++s) {
+                t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+            }
+        }
+        return t;
+    }();
+    return tables;
+}
+
+/**
+ * @brief Round a file offset up to the section alignment
+ */
+size_t alignOffset(size_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+}
+
+SnapshotFile::~SnapshotFile() {
+    close();
+}
+
+void SnapshotFile::encode(const ParticleStore& particles, const State& state,
+                          std::vector<unsigned char>& out) {
+    const size_t count = particles.size();
+
+    // Hot arrays are copied straight from the store; cold data is gathered into its sections below
+    size_t nameBytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        nameBytes += particles.getInfo(i).name.size();
+    }
+
+    const void* sources[static_cast<size_t>(Section::COUNT)] = {
+        particles.getPositions().data(),
+        particles.getVelocities().data(),
+        particles.getAccelerations().data(),
+        particles.getMasses().data(),
+        particles.getRadii().data(),
+        nullptr,
+        particles.getActiveFlags().data(),
+        particles.getTimestepLevels().data(),
+        nullptr,
+        nullptr,
+        nullptr
+    };
+    const size_t sizes[static_cast<size_t>(Section::COUNT)] = {
+        count * sizeof(glm::vec3),
+        count * sizeof(glm::vec3),
+        count * sizeof(glm::vec3),
+        count * sizeof(double),
+        count * sizeof(float),
+        count * sizeof(glm::vec4),
+        count * sizeof(uint8_t),
+        count * sizeof(uint8_t),
+        count * sizeof(uint8_t),
+        (count + 1) * sizeof(uint32_t),
+        nameBytes
+    };
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(Header);
+    header.bodyCount = count;
+    header.stepCount = state.stepCount;
+    header.simulationTime = state.simulationTime;
+    header.blackHoleMass = state.blackHoleMass;
+    header.blackHolePosition[0] = state.blackHolePosition.x;
+    header.blackHolePosition[1] = state.blackHolePosition.y;
+    header.blackHolePosition[2] = state.blackHolePosition.z;
+    header.flags = state.accelerationsValid ? static_cast<uint32_t>(ACCELERATIONS_VALID) : 0u;
+
+    size_t offset = sizeof(Header);
+    for (size_t s = 0; s < static_cast<size_t>(Section::COUNT); ++s) {
+        offset = alignOffset(offset);
+        header.offsets[s] = offset;
+        header.sizes[s] = sizes[s];
+        offset += sizes[s];
+    }
+    header.fileSize = offset;
+
+    // Padding between sections is zeroed so identical states give identical files
+    out.assign(offset, 0);
+    for (size_t s = 0; s < static_cast<size_t>(Section::COUNT); ++s) {
+        if (sizes[s] > 0 && sources[s]) {
+            std::memcpy(out.data() + header.offsets[s], sources[s], sizes[s]);
+        }
+    }
+
+    // Written in place, so a reused buffer makes encoding allocation-free
+    unsigned char* colors = out.data() + header.offsets[static_cast<size_t>(Section::COLORS)];
+    unsigned char* types = out.data() + header.offsets[static_cast<size_t>(Section::TYPES)];
+    unsigned char* nameOffsets = out.data() + header.offsets[static_cast<size_t>(Section::NAME_OFFSETS)];
+    unsigned char* names = out.data() + header.offsets[static_cast<size_t>(Section::NAMES)];
+    uint32_t nameOffset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const ParticleStore::ParticleInfo& info = particles.getInfo(i);
+        std::memcpy(colors + i * sizeof(glm::vec4), &info.color, sizeof(glm::vec4));
+        types[i] = static_cast<uint8_t>(info.type);
+        std::memcpy(nameOffsets + i * sizeof(uint32_t), &nameOffset, sizeof(uint32_t));
+        std::memcpy(names + nameOffset, info.name.data(), info.name.size());
+        nameOffset += static_cast<uint32_t>(info.name.size());
+    }
+    std::memcpy(nameOffsets + count * sizeof(uint32_t), &nameOffset, sizeof(uint32_t));
+    std::memcpy(out.data(), &header, sizeof(Header));
+
+    header.checksum = crc32(0, out.data(), out.size());
+    std::memcpy(out.data() + offsetof(Header, checksum), &header.checksum, sizeof(header.checksum));
+}
+
+bool SnapshotFile::write(const std::string& path, const std::vector<unsigned char>& bytes) {
+    std::filesystem::path target(path);
+    if (target.has_parent_path()) {
+        std::error_code error;
+        std::filesystem::create_directories(target.parent_path(), error);
+    }
+
+    // Readers never see a half-written snapshot under the final name
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, target, error);
+    return !error;
+}
+
+bool SnapshotFile::open(const std::string& path, std::string& error) {
+    close();
+
+    if (!isLittleEndian()) {
+        error = "snapshots are little-endian and this host is not";
+        return false;
+    }
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open file";
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        error = "file is too small to be a snapshot";
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        error = "cannot map file";
+        return false;
+    }
+    m_data = static_cast<const unsigned char*>(mapping);
+    m_size = static_cast<size_t>(info.st_size);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        error = "cannot open file";
+        return false;
+    }
+    m_buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    if (!file || m_buffer.size() < sizeof(Header)) {
+        m_buffer.clear();
+        error = "file is too small to be a snapshot";
+        return false;
+    }
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#endif
+
+    const Header& header = getHeader();
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error = "not a snapshot file";
+    } else if (header.version != VERSION || header.headerSize != sizeof(Header)) {
+        error = "unsupported snapshot version " + std::to_string(header.version);
+    } else if (header.fileSize != m_size) {
+        error = "file is truncated";
+    } else if (header.bodyCount > m_size / sizeof(glm::vec3)) {
+        // Every body needs a position, so larger counts are corrupt; this also keeps the products below from overflowing
+        error = "corrupt body count";
+    } else {
+        const uint64_t count = header.bodyCount;
+        const uint64_t elementSizes[static_cast<size_t>(Section::COUNT)] = {
+            sizeof(glm::vec3), sizeof(glm::vec3), sizeof(glm::vec3), sizeof(double), sizeof(float),
+            sizeof(glm::vec4), sizeof(uint8_t), sizeof(uint8_t), sizeof(uint8_t), sizeof(uint32_t), 0
+        };
+        for (size_t s = 0; s < static_cast<size_t>(Section::COUNT) && error.empty(); ++s) {
+            const uint64_t expected = s == static_cast<size_t>(Section::NAME_OFFSETS)
+                ? (count + 1) * elementSizes[s] : count * elementSizes[s];
+            const bool sized = s == static_cast<size_t>(Section::NAMES) || header.sizes[s] == expected;
+            if (!sized || header.offsets[s] % SECTION_ALIGNMENT != 0 ||
+                header.offsets[s] > m_size || header.sizes[s] > m_size - header.offsets[s]) {
+                error = "corrupt section table";
+            }
+        }
+    }
+
+    if (error.empty()) {
+        // Checksum with the stored value treated as zero, as it was when written
+        const size_t field = offsetof(Header, checksum);
+        const uint32_t zero = 0;
+        uint32_t crc = crc32(0, m_data, field);
+        crc = crc32(crc, reinterpret_cast<const unsigned char*>(&zero), sizeof(zero));
+        crc = crc32(crc, m_data + field + sizeof(zero), m_size - field - sizeof(zero));
+        if (crc != header.checksum) {
+            error = "checksum mismatch";
+        }
+    }
+
+    if (error.empty()) {
+        // Names must stay inside the blob
+        const uint32_t* offsets = section<uint32_t>(Section::NAME_OFFSETS);
+        const uint64_t blobSize = header.sizes[static_cast<size_t>(Section::NAMES)];
+        for (uint64_t i = 0; i < header.bodyCount; ++i) {
+            if (offsets[i] > offsets[i + 1] || offsets[i + 1] > blobSize) {
+                error = "corrupt name table";
+                break;
+            }
+        }
+    }
+
+    if (!error.empty()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SnapshotFile::close() {
+#ifndef _WIN32
+    if (m_data) {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+#endif
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+}
+
+SnapshotFile::State SnapshotFile::getState() const {
+    const Header& header = getHeader();
+    State state;
+    state.stepCount = header.stepCount;
+    state.simulationTime = header.simulationTime;
+    state.blackHoleMass = header.blackHoleMass;
+    state.blackHolePosition = glm::vec3(header.blackHolePosition[0],
+                                        header.blackHolePosition[1],
+                                        header.blackHolePosition[2]);
+    state.accelerationsValid = (header.flags & ACCELERATIONS_VALID) != 0;
+    return state;
+}
+
+std::string_view SnapshotFile::getName(size_t index) const {
+    const uint32_t* offsets = section<uint32_t>(Section::NAME_OFFSETS);
+    return std::string_view(section<char>(Section::NAMES) + offsets[index], offsets[index + 1] - offsets[index]);
+}
+
+uint32_t SnapshotFile::crc32(uint32_t crc, const unsigned char* data, size_t length) {
+    const auto& t = crcTables();
+    crc = ~crc;
+
+    // Eight bytes per iteration through the sliced tables
+    while (length >= 8) {
+        uint32_t low, high;
+        std::memcpy(&low, data, 4);
+        std::memcpy(&high, data + 4, 4);
+        low ^= crc;
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = t[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file SnapshotFile.h
+ * @brief Versioned binary snapshot format for simulation checkpoints
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ParticleStore.h"
+
+/**
+ * @brief Checkpoint file with the particle store's arrays stored as-is
+ *
+ * A file is a fixed header followed by one section per array, each starting on
+ * a 64-byte boundary and holding exactly the bytes of the matching
+ * ParticleStore vector (little-endian, glm vectors as packed floats). Names are
+ * an offset table plus one character blob. A CRC-32 over the header and all
+ * sections guards against truncated or corrupt files.
+ *
+ * Reading maps the file into memory and points straight into it: open()
+ * checks the header, bounds and checksum, and section() then returns typed
+ * pointers that can be copied into the store without any parsing.
+ */
+class SnapshotFile {
+public:
+    static constexpr uint32_t VERSION = 1;      ///< Current format version
+
+    /**
+     * @brief Arrays stored in a snapshot, in file order
+     */
+    enum class Section : uint32_t {
+        POSITIONS,      ///< glm::vec3 per body
+        VELOCITIES,     ///< glm::vec3 per body
+        ACCELERATIONS,  ///< glm::vec3 per body
+        MASSES,         ///< double per body
+        RADII,          ///< float per body
+        COLORS,         ///< glm::vec4 per body
+        ACTIVE,         ///< uint8_t per body
+        LEVELS,         ///< uint8_t block timestep level per body
+        TYPES,          ///< uint8_t Object::Type per body
+        NAME_OFFSETS,   ///< uint32_t per body plus one, into NAMES
+        NAMES,          ///< Concatenated body names
+        COUNT
+    };
+
+    /**
+     * @brief Header flags
+     */
+    enum Flags : uint32_t {
+        ACCELERATIONS_VALID = 1u << 0  ///< Stored accelerations belong to the stored positions
+    };
+
+    /**
+     * @brief Fixed-size file header (little-endian)
+     */
+    struct Header {
+        char magic[8];                                  ///< "BHSNAP" followed by two zero bytes
+        uint32_t version;                               ///< Format version
+        uint32_t headerSize;                            ///< sizeof(Header)
+        uint64_t fileSize;                              ///< Total file size in bytes
+        uint64_t bodyCount;                             ///< Bodies in every per-body section
+        uint64_t stepCount;                             ///< Physics steps taken
+        double simulationTime;                          ///< Simulated time (s)
+        double blackHoleMass;                           ///< Black hole mass (kg)
+        float blackHolePosition[3];                     ///< Black hole position (m)
+        uint32_t flags;                                 ///< Flags bits
+        uint64_t offsets[static_cast<size_t>(Section::COUNT)];  ///< Section start within the file
+        uint64_t sizes[static_cast<size_t>(Section::COUNT)];    ///< Section length in bytes
+        uint32_t checksum;                              ///< CRC-32 of the file with this field zeroed
+        uint32_t reserved;                              ///< Zero
+    };
+
+    /**
+     * @brief Simulation state stored next to the particle arrays
+     */
+    struct State {
+        uint64_t stepCount = 0;                         ///< Physics steps taken
+        double simulationTime = 0.0;                    ///< Simulated time (s)
+        double blackHoleMass = 0.0;                     ///< Black hole mass (kg)
+        glm::vec3 blackHolePosition{0.0f};              ///< Black hole position (m)
+        bool accelerationsValid = false;                ///< Accelerations match the positions
+    };
+
+    SnapshotFile() = default;
+
+    /**
+     * @brief Unmap the file
+     */
+    ~SnapshotFile();
+
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+    /**
+     * @brief Serialize the bodies and state into a complete file image
+     * @param particles Bodies to store
+     * @param state Simulation state to store
+     * @param out Receives the file bytes (reuses its capacity)
+     */
+    static void encode(const ParticleStore& particles, const State& state,
+                       std::vector<unsigned char>& out);
+
+    /**
+     * @brief Write a file image atomically (temporary file, then rename)
+     * @param path Destination path
+     * @param bytes File image from encode()
+     * @return True on success
+     */
+    static bool write(const std::string& path, const std::vector<unsigned char>& bytes);
+
+    /**
+     * @brief Map a snapshot file and validate it
+     * @param path Snapshot path
+     * @param error Receives the reason on failure
+     * @return True if the file is a complete snapshot of this version
+     */
+    bool open(const std::string& path, std::string& error);
+
+    /**
+     * @brief Unmap the current file
+     */
+    void close();
+
+    /**
+     * @brief Get the validated header
+     * @return Header of the open file
+     */
+    const Header& getHeader() const { return *reinterpret_cast<const Header*>(m_data); }
+
+    /**
+     * @brief Get the state stored in the header
+     * @return Simulation state of the open file
+     */
+    State getState() const;
+
+    /**
+     * @brief Get a typed pointer into a section of the mapped file
+     * @param section Section to access
+     * @return Pointer to the first element
+     */
+    template <typename T>
+    const T* section(Section section) const {
+        return reinterpret_cast<const T*>(m_data + getHeader().offsets[static_cast<size_t>(section)]);
+    }
+
+    /**
+     * @brief Get the name of a stored body
+     * @param index Body index in the file
+     * @return View into the mapped name blob
+     */
+    std::string_view getName(size_t index) const;
+
+    /**
+     * @brief CRC-32 (IEEE) of a byte range
+     * @param crc Running CRC (0 to start)
+     * @param data Bytes to add
+     * @param length Number of bytes
+     * @return Updated CRC
+     */
+    static uint32_t crc32(uint32_t crc, const unsigned char* data, size_t length);
+
+private:
+    const unsigned char* m_data = nullptr;  ///< Mapped file
+    size_t m_size = 0;                      ///< Mapped length
+    std::vector<unsigned char> m_buffer;    ///< File contents where mmap is unavailable
+};
@@ -0,0 +1,81 @@
+/**
+ * @file TrailPool.cpp
+ * @brief Implementation of the shared trail ring buffers
+ */
+
+#include "TrailPool.h"
+#include <algorithm>
+
+TrailPool::TrailPool(size_t length, size_t sampleInterval)
+    : m_length(1)
+    , m_sampleInterval(1)
+    , m_sampleClock(0)
+    , m_version(0) {
+    configure(length, sampleInterval);
+}
+
+void TrailPool::configure(size_t length, size_t sampleInterval) {
+    m_length = static_cast<uint32_t>(std::max<size_t>(1, length));
+    m_sampleInterval = static_cast<uint32_t>(std::max<size_t>(1, sampleInterval));
+    clear();
+}
+
+TrailPool::Slot TrailPool::allocate(const glm::vec3& position) {
+    Slot slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        // Grows geometrically through std::vector, so adding bodies is amortized O(length)
+        slot = static_cast<Slot>(m_heads.size());
+        m_heads.push_back(0);
+        m_counts.push_back(0);
+        m_samples.resize(m_samples.size() + m_length);
+    }
+
+    m_heads[slot] = 0;
+    m_counts[slot] = 0;
+    record(slot, position);
+    ++m_version;
+    return slot;
+}
+
+void TrailPool::reserve(size_t slots) {
+    m_heads.reserve(slots);
+    m_counts.reserve(slots);
+    m_samples.reserve(slots * m_length);
+}
+
+void TrailPool::release(Slot slot) {
+    if (slot == INVALID_SLOT || slot >= m_heads.size()) return;
+    m_counts[slot] = 0;
+    m_freeSlots.push_back(slot);
+    ++m_version;
+}
+
+void TrailPool::clear() {
+    m_samples.clear();
+    m_heads.clear();
+    m_counts.clear();
+    m_freeSlots.clear();
+    m_sampleClock = 0;
+    ++m_version;
+}
+
+bool TrailPool::beginSample() {
+    if (++m_sampleClock < m_sampleInterval) return false;
+    m_sampleClock = 0;
+    return true;
+}
+
+void TrailPool::copyTrail(Slot slot, std::vector<glm::vec3>& out) const {
+    const uint32_t count = m_counts[slot];
+    const glm::vec3* ring = m_samples.data() + static_cast<size_t>(slot) * m_length;
+
+    out.resize(count);
+    uint32_t index = (m_heads[slot] + m_length - count) % m_length;
+    for (uint32_t i = 0; i < count; ++i) {
+        out[i] = ring[index];
+        index = (index + 1 == m_length) ? 0 : index + 1;
+    }
+}
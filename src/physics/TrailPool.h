@@ -0,0 +1,151 @@
+/**
+ * @file TrailPool.h
+ * @brief Shared fixed-capacity ring buffers holding the recent path of every body
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief One contiguous sample array holding a ring of recent positions per body
+ *
+ * Every body owns a slot of getLength() samples inside a single array, so
+ * recording a sample is one store and a head increment, adding or removing a
+ * body never moves other trails, and the whole pool can be uploaded to the GPU
+ * as one vertex stream. Slot s occupies samples [s * length, (s + 1) * length);
+ * its newest sample sits just before its head (mod length), and only the last
+ * getCount(s) samples are valid. Freed slots are reused before the pool grows.
+ */
+class TrailPool {
+public:
+    /**
+     * @brief Index of a trail slot
+     */
+    using Slot = uint32_t;
+
+    /**
+     * @brief Slot value meaning "no trail"
+     */
+    static constexpr Slot INVALID_SLOT = ~Slot(0);
+
+    /**
+     * @brief Create an empty pool
+     * @param length Samples kept per trail
+     * @param sampleInterval Record one sample every this many calls to record()
+     */
+    explicit TrailPool(size_t length = 100, size_t sampleInterval = 1);
+
+    /**
+     * @brief Change the trail length and sample rate (drops every trail)
+     * @param length Samples kept per trail
+     * @param sampleInterval Record one sample every this many calls to record()
+     */
+    void configure(size_t length, size_t sampleInterval);
+
+    /**
+     * @brief Give a body a trail starting at its current position
+     * @param position Initial position
+     * @return Slot of the new trail
+     */
+    Slot allocate(const glm::vec3& position);
+
+    /**
+     * @brief Reserve storage for a number of trails
+     * @param slots Number of trails to reserve space for
+     */
+    void reserve(size_t slots);
+
+    /**
+     * @brief Return a trail slot to the pool
+     * @param slot Slot to free
+     */
+    void release(Slot slot);
+
+    /**
+     * @brief Drop every trail
+     */
+    void clear();
+
+    /**
+     * @brief Advance the sample clock
+     * @return True if this call falls on a sample and trails should be recorded
+     */
+    bool beginSample();
+
+    /**
+     * @brief Append a position to a trail, overwriting its oldest sample when full
+     * @param slot Trail slot
+     * @param position Position to record
+     */
+    void record(Slot slot, const glm::vec3& position) {
+        const uint32_t head = m_heads[slot];
+        m_samples[static_cast<size_t>(slot) * m_length + head] = position;
+        m_heads[slot] = (head + 1 == m_length) ? 0 : head + 1;
+        if (m_counts[slot] < m_length) m_counts[slot]++;
+    }
+
+    /**
+     * @brief Mark the end of a recording pass
+     */
+    void endSample() { ++m_version; }
+
+    /**
+     * @brief Get the ring storage of every slot
+     * @return getSlotCount() * getLength() samples
+     */
+    const std::vector<glm::vec3>& getSamples() const { return m_samples; }
+
+    /**
+     * @brief Get the ring position written next
+     * @param slot Trail slot
+     * @return Head index in [0, getLength())
+     */
+    uint32_t getHead(Slot slot) const { return m_heads[slot]; }
+
+    /**
+     * @brief Get the number of valid samples
+     * @param slot Trail slot
+     * @return Sample count in [1, getLength()]
+     */
+    uint32_t getCount(Slot slot) const { return m_counts[slot]; }
+
+    /**
+     * @brief Get a trail in chronological order
+     * @param slot Trail slot
+     * @param out Receives the samples, oldest first
+     */
+    void copyTrail(Slot slot, std::vector<glm::vec3>& out) const;
+
+    /**
+     * @brief Get the number of samples kept per trail
+     * @return Trail length
+     */
+    uint32_t getLength() const { return m_length; }
+
+    /**
+     * @brief Get the number of slots (used and free)
+     * @return Slot count
+     */
+    size_t getSlotCount() const { return m_heads.size(); }
+
+    /**
+     * @brief Get a counter that changes whenever the samples or slots change
+     * @return Version number
+     */
+    uint64_t getVersion() const { return m_version; }
+
+private:
+    uint32_t m_length;                      ///< Samples per trail
+    uint32_t m_sampleInterval;              ///< Calls to beginSample() per sample
+    uint32_t m_sampleClock;                 ///< Calls since the last sample
+    uint64_t m_version;                     ///< Bumped on every change
+
+    std::vector<glm::vec3> m_samples;       ///< Ring storage of all slots
+    std::vector<uint32_t> m_heads;          ///< Next write index per slot
+    std::vector<uint32_t> m_counts;         ///< Valid samples per slot
+    std::vector<Slot> m_freeSlots;          ///< Released slots available for reuse
+};
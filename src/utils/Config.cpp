@@ -199,6 +199,14 @@ void Config::setBool(const std::string& key, bool value) {
     setNestedValue(key, nlohmann::json(value));
 }
 
+void Config::merge(const Config& other) {
+    m_json.merge_patch(other.m_json);
+}
+
+void Config::setIntArray(const std::string& key, const std::vector<int>& value) {
+    setNestedValue(key, nlohmann::json(value));
+}
+
 bool Config::hasKey(const std::string& key) const {
     return getNestedValue(key) != nullptr;
 }
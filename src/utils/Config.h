@@ -143,6 +143,19 @@ public:
      */
     void setBool(const std::string& key, bool value);
     
+    /**
+     * @brief Overlay another configuration onto this one
+     * @param other Configuration whose values take precedence
+     */
+    void merge(const Config& other);
+    
+    /**
+     * @brief Set array of integers
+     * @param key Configuration key
+     * @param value Values to set
+     */
+    void setIntArray(const std::string& key, const std::vector<int>& value);
+    
     /**
      * @brief Check if a key exists in the configuration
      * @param key Configuration key to check
@@ -0,0 +1,49 @@
+/**
+ * @file ConfigWatcher.cpp
+ * @brief Implementation of configuration hot reload
+ */
+
+#include "ConfigWatcher.h"
+#include "Logger.h"
+#include <algorithm>
+
+ConfigWatcher::ConfigWatcher(const std::string& filename, const Config& overrides, double intervalSeconds)
+    : m_filename(filename)
+    , m_overrides(overrides)
+    , m_interval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(std::max(0.05, intervalSeconds))))
+    , m_nextCheck(std::chrono::steady_clock::now() + m_interval)
+    , m_lastWrite() {
+    if (!readWriteTime(m_lastWrite)) {
+        Logger::getInstance().log(Logger::Level::WARNING,
+            "Cannot watch configuration file " + m_filename + " for changes");
+    } else {
+        Logger::getInstance().log(Logger::Level::INFO, "Watching " + m_filename + " for changes");
+    }
+}
+
+bool ConfigWatcher::poll(Config& config) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now < m_nextCheck) return false;
+    m_nextCheck = now + m_interval;
+
+    std::filesystem::file_time_type writeTime;
+    if (!readWriteTime(writeTime) || writeTime == m_lastWrite) return false;
+    m_lastWrite = writeTime;
+
+    Config reloaded;
+    if (!reloaded.loadFromFile(m_filename)) {
+        Logger::getInstance().log(Logger::Level::WARNING,
+            "Ignoring edited configuration file " + m_filename + " (failed to load)");
+        return false;
+    }
+    reloaded.merge(m_overrides);
+    config = reloaded;
+    return true;
+}
+
+bool ConfigWatcher::readWriteTime(std::filesystem::file_time_type& time) const {
+    std::error_code error;
+    time = std::filesystem::last_write_time(m_filename, error);
+    return !error;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file ConfigWatcher.h
+ * @brief Polls the configuration file and reloads it when it changes
+ */
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include "Config.h"
+
+/**
+ * @brief Detects edits to the configuration file for hot reload
+ *
+ * poll() is cheap enough to call every frame: it only looks at the file's
+ * modification time once per interval. When the time changes the file is
+ * parsed again and the command line overrides are laid back over it, so a
+ * reload never undoes a flag the program was started with. A file that
+ * fails to parse is reported and ignored until it is saved again.
+ */
+class ConfigWatcher {
+public:
+    /**
+     * @brief Start watching a configuration file
+     * @param filename Configuration file the program was started with
+     * @param overrides Command line values that take precedence over the file
+     * @param intervalSeconds Minimum time between modification checks
+     */
+    ConfigWatcher(const std::string& filename, const Config& overrides, double intervalSeconds);
+
+    /**
+     * @brief Reload the configuration if the file changed since the last poll
+     * @param config Receives the reloaded configuration (untouched otherwise)
+     * @return True if config was replaced
+     */
+    bool poll(Config& config);
+
+private:
+    std::string m_filename;                                 ///< Watched file
+    Config m_overrides;                                     ///< Re-applied after every reload
+    std::chrono::steady_clock::duration m_interval;         ///< Time between checks
+    std::chrono::steady_clock::time_point m_nextCheck;      ///< Earliest next check
+    std::filesystem::file_time_type m_lastWrite;            ///< Modification time last loaded
+
+    /**
+     * @brief Read the file's modification time
+     * @param time Receives the time
+     * @return False if the file cannot be examined
+     */
+    bool readWriteTime(std::filesystem::file_time_type& time) const;
+};
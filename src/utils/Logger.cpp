@@ -5,9 +5,9 @@
 
 #include "Logger.h"
 #include <iostream>
-#include <iomanip>
-#include <sstream>
 #include <chrono>
+#include <cstdio>
+#include <ctime>
 #include <map>
 #include <string>
 #include <vector>
@@ -17,12 +17,35 @@ Logger::Logger()
     : m_currentLevel(Level::INFO)
     , m_consoleOutput(true)
     , m_fileOutput(false)
-    , m_logFilename("black_hole_simulation.log") {
+    , m_logFilename("black_hole_simulation.log")
+    , m_queue(new Entry[QUEUE_CAPACITY])
+    , m_enqueuePos(0)
+    , m_dequeuePos(0)
+    , m_writtenPos(0)
+    , m_dropped(0)
+    , m_stopping(false)
+    , m_cachedSecond(-1)
+    , m_cachedTimestamp{} {
+    
+    for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+        m_queue[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_writer = std::thread(&Logger::run, this);
 }
 
 Logger::~Logger() {
     if (m_logFile.is_open()) {
         log(Level::INFO, "Logger shutting down");
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_writer.join();
+    
+    if (m_logFile.is_open()) {
         m_logFile.close();
     }
 }
@@ -33,8 +56,7 @@ Logger& Logger::getInstance() {
 }
 
 void Logger::setLevel(Level level) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_currentLevel = level;
+    m_currentLevel.store(level, std::memory_order_relaxed);
 }
 
 void Logger::setConsoleOutput(bool enabled) {
@@ -63,26 +85,51 @@ void Logger::setFileOutput(bool enabled, const std::string& filename) {
         } else {
             // Write header to log file
             m_logFile << "\n" << std::string(80, '=') << "\n";
-            m_logFile << "Black Hole Simulation Log - " << getCurrentTimestamp() << "\n";
+            m_logFile << "Black Hole Simulation Log - " << formatTimestamp(std::chrono::system_clock::now()) << "\n";
             m_logFile << std::string(80, '=') << "\n";
         }
     }
 }
 
 void Logger::log(Level level, const std::string& message) {
-    if (level < m_currentLevel) return;
-    
-    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!isEnabled(level)) return;
     
-    std::string timestamp = getCurrentTimestamp();
+    std::string copy = message;
+    enqueue(level, copy);
+}
+
+void Logger::log(Level level, std::string&& message) {
+    if (!isEnabled(level)) return;
     
-    if (m_consoleOutput) {
-        writeToConsole(level, timestamp, message);
+    enqueue(level, message);
+}
+
+void Logger::enqueue(Level level, std::string& message) {
+    // Claim a slot: its sequence equals the position while it is free
+    size_t position = m_enqueuePos.load(std::memory_order_relaxed);
+    Entry* entry = nullptr;
+    while (true) {
+        entry = &m_queue[position & (QUEUE_CAPACITY - 1)];
+        size_t sequence = entry->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        
+        if (difference == 0) {
+            if (m_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (difference < 0) {
+            // The writer has not freed this slot yet: the queue is full
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = m_enqueuePos.load(std::memory_order_relaxed);
+        }
     }
     
-    if (m_fileOutput && m_logFile.is_open()) {
-        writeToFile(level, timestamp, message);
-    }
+    entry->level = level;
+    entry->time = std::chrono::system_clock::now();
+    entry->message = std::move(message);
+    entry->sequence.store(position + 1, std::memory_order_release);
+    
+    m_wake.notify_one();
 }
 
 void Logger::debug(const std::string& message) {
@@ -105,34 +152,17 @@ void Logger::critical(const std::string& message) {
     log(Level::CRITICAL, message);
 }
 
-void Logger::startTimer(const std::string& name) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_timers[name] = std::chrono::high_resolution_clock::now();
-    debug("Timer '" + name + "' started");
-}
-
-void Logger::stopTimer(const std::string& name) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
-    auto it = m_timers.find(name);
-    if (it != m_timers.end()) {
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - it->second);
-        
-        double milliseconds = duration.count() / 1000.0;
-        
-        std::stringstream ss;
-        ss << std::fixed << std::setprecision(3);
-        ss << "Timer '" << name << "' elapsed: " << milliseconds << "ms";
-        
-        info(ss.str());
-        m_timers.erase(it);
-    } else {
-        warning("Attempted to stop non-existent timer: " + name);
-    }
-}
-
 void Logger::flush() {
+    // Messages queued before this call; the writer signals as it catches up
+    const size_t target = m_enqueuePos.load(std::memory_order_acquire);
+    {
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.notify_one();
+        m_drained.wait_for(lock, std::chrono::seconds(1), [this, target] {
+            return m_writtenPos.load(std::memory_order_acquire) >= target;
+        });
+    }
+    
     std::lock_guard<std::mutex> lock(m_mutex);
     
     if (m_consoleOutput) {
@@ -156,17 +186,78 @@ std::string Logger::levelToString(Level level) const {
     }
 }
 
-std::string Logger::getCurrentTimestamp() const {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
+std::string Logger::formatTimestamp(std::chrono::system_clock::time_point time) {
+    auto seconds = std::chrono::system_clock::to_time_t(time);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+        time.time_since_epoch()) % 1000;
     
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
+    // localtime only runs when the second changes
+    if (seconds != m_cachedSecond) {
+        std::tm local{};
+        localtime_r(&seconds, &local);
+        std::strftime(m_cachedTimestamp, sizeof(m_cachedTimestamp), "%Y-%m-%d %H:%M:%S", &local);
+        m_cachedSecond = seconds;
+    }
     
-    return ss.str();
+    char timestamp[40];
+    std::snprintf(timestamp, sizeof(timestamp), "%s.%03d", m_cachedTimestamp, static_cast<int>(ms.count()));
+    return timestamp;
+}
+
+void Logger::run() {
+    while (true) {
+        bool wrote = drain();
+        
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        if (wrote) m_drained.notify_all();
+        if (m_stopping && !wrote) break;
+        
+        // Producers notify without the lock, so a missed wake-up costs at most the timeout
+        if (!wrote) m_wake.wait_for(lock, std::chrono::milliseconds(20));
+    }
+    m_drained.notify_all();
+}
+
+bool Logger::drain() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    bool wrote = false;
+    while (true) {
+        Entry& entry = m_queue[m_dequeuePos & (QUEUE_CAPACITY - 1)];
+        if (entry.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) break;
+        
+        std::string timestamp = formatTimestamp(entry.time);
+        if (m_consoleOutput) {
+            writeToConsole(entry.level, timestamp, entry.message);
+        }
+        if (m_fileOutput && m_logFile.is_open()) {
+            writeToFile(entry.level, timestamp, entry.message);
+        }
+        
+        // Hand the slot back to producers one lap later
+        entry.message.clear();
+        entry.sequence.store(m_dequeuePos + QUEUE_CAPACITY, std::memory_order_release);
+        ++m_dequeuePos;
+        m_writtenPos.store(m_dequeuePos, std::memory_order_release);
+        wrote = true;
+    }
+    
+    uint64_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        std::string message = std::to_string(dropped) + " log messages dropped (queue full)";
+        std::string timestamp = formatTimestamp(std::chrono::system_clock::now());
+        if (m_consoleOutput) writeToConsole(Level::WARNING, timestamp, message);
+        if (m_fileOutput && m_logFile.is_open()) writeToFile(Level::WARNING, timestamp, message);
+        wrote = true;
+    }
+    
+    // One flush per batch instead of one per line
+    if (wrote) {
+        std::cout.flush();
+        std::cerr.flush();
+        if (m_logFile.is_open()) m_logFile.flush();
+    }
+    return wrote;
 }
 
 void Logger::writeToConsole(Level level, const std::string& timestamp, const std::string& message) {
@@ -197,10 +288,10 @@ void Logger::writeToConsole(Level level, const std::string& timestamp, const std
     
     *stream << colorCode << "[" << timestamp << "] " 
             << levelToString(level) << ": " << message 
-            << "\033[0m" << std::endl;
+            << "\033[0m" << '\n';
 }
 
 void Logger::writeToFile(Level level, const std::string& timestamp, const std::string& message) {
     m_logFile << "[" << timestamp << "] " 
-              << levelToString(level) << ": " << message << std::endl;
+              << levelToString(level) << ": " << message << '\n';
 }
\ No newline at end of file
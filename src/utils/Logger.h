@@ -8,16 +8,27 @@
 #include <string>
 #include <fstream>
 #include <mutex>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <thread>
 #include <vector>
-#include <map>
 #include <GLFW/glfw3.h>
 
 /**
  * @brief Thread-safe singleton logging system
  * 
- * Provides different log levels, file output, and performance tracking.
- * Supports both console and file logging with timestamps and thread safety.
+ * Provides different log levels and file output. Supports both console and
+ * file logging with timestamps and thread safety. Timing lives in Metrics.
+ * 
+ * log() never blocks on output: messages below the current level return
+ * before any work, and the rest are stamped with the clock and pushed onto a
+ * bounded lock-free queue that a writer thread formats and writes. If the
+ * queue is full the message is dropped and counted, and the writer reports
+ * the count once it catches up.
  */
 class Logger {
 public:
@@ -64,6 +75,23 @@ public:
      */
     void log(Level level, const std::string& message);
     
+    /**
+     * @brief Log a message, moving it into the queue without copying
+     * @param level Message severity level
+     * @param message Message text
+     */
+    void log(Level level, std::string&& message);
+    
+    /**
+     * @brief Check whether a level would be logged
+     * 
+     * Lets hot paths skip building messages that would be filtered out.
+     * 
+     * @param level Message severity level
+     * @return True if messages of this level are written
+     */
+    bool isEnabled(Level level) const { return level >= m_currentLevel.load(std::memory_order_relaxed); }
+    
     /**
      * @brief Log a debug message (convenience method)
      * @param message Debug message
@@ -95,19 +123,7 @@ public:
     void critical(const std::string& message);
     
     /**
-     * @brief Start a performance timer
-     * @param name Timer name
-     */
-    void startTimer(const std::string& name);
-    
-    /**
-     * @brief Stop a performance timer and log the duration
-     * @param name Timer name
-     */
-    void stopTimer(const std::string& name);
-    
-    /**
-     * @brief Flush all pending log messages
+     * @brief Wait until every queued message is written, then flush the streams
      */
     void flush();
     
@@ -116,15 +132,39 @@ public:
     Logger& operator=(const Logger&) = delete;
 
 private:
-    Level m_currentLevel;           ///< Current minimum log level
+    static constexpr size_t QUEUE_CAPACITY = 4096;  ///< Queued messages (power of two)
+    
+    /**
+     * @brief Queued message; sequence orders producers and the writer
+     */
+    struct Entry {
+        std::atomic<size_t> sequence{0};                    ///< Slot state (Vyukov bounded queue)
+        Level level = Level::INFO;                          ///< Message severity
+        std::chrono::system_clock::time_point time;         ///< Time log() was called
+        std::string message;                                ///< Message text
+    };
+    
+    std::atomic<Level> m_currentLevel;  ///< Current minimum log level
     bool m_consoleOutput;           ///< Enable console output
     bool m_fileOutput;              ///< Enable file output
     std::string m_logFilename;      ///< Log file name
     std::ofstream m_logFile;        ///< Log file stream
-    std::mutex m_mutex;             ///< Thread safety mutex
+    std::mutex m_mutex;             ///< Guards the output streams and their settings
     
-    // Performance timing
-    std::map<std::string, std::chrono::high_resolution_clock::time_point> m_timers;
+    std::unique_ptr<Entry[]> m_queue;       ///< Message ring
+    std::atomic<size_t> m_enqueuePos;       ///< Next slot claimed by a producer
+    size_t m_dequeuePos;                    ///< Next slot read by the writer
+    std::atomic<size_t> m_writtenPos;       ///< Messages written so far (for flush)
+    std::atomic<uint64_t> m_dropped;        ///< Messages lost to a full queue
+    
+    std::thread m_writer;                   ///< Background writer thread
+    std::mutex m_wakeMutex;                 ///< Guards m_stopping for the condition variables
+    std::condition_variable m_wake;         ///< Wakes the writer
+    std::condition_variable m_drained;      ///< Signals flush() that the queue emptied
+    bool m_stopping;                        ///< Writer should exit once drained
+    
+    time_t m_cachedSecond;                  ///< Second m_cachedTimestamp was formatted for
+    char m_cachedTimestamp[32];             ///< "YYYY-mm-dd HH:MM:SS" of m_cachedSecond
     
     /**
      * @brief Private constructor (singleton)
@@ -144,10 +184,29 @@ private:
     std::string levelToString(Level level) const;
     
     /**
-     * @brief Get current timestamp as string
-     * @return Formatted timestamp
+     * @brief Format a timestamp, reusing the date and time of the last one
+     * @param time Time to format
+     * @return Formatted timestamp with milliseconds
+     */
+    std::string formatTimestamp(std::chrono::system_clock::time_point time);
+    
+    /**
+     * @brief Queue a message for the writer thread
+     * @param level Message severity level
+     * @param message Message text (moved from on success)
+     */
+    void enqueue(Level level, std::string& message);
+    
+    /**
+     * @brief Writer thread main loop
+     */
+    void run();
+    
+    /**
+     * @brief Write every queued message
+     * @return True if anything was written
      */
-    std::string getCurrentTimestamp() const;
+    bool drain();
     
     /**
      * @brief Write message to console
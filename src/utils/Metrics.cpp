@@ -0,0 +1,250 @@
+/**
+ * @file Metrics.cpp
+ * @brief Implementation of the scoped timer registry and trace writer
+ */
+
+#include "Metrics.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+thread_local void* t_ring = nullptr;    ///< Calling thread's ring (owned by Metrics)
+
+/**
+ * @brief Convert steady_clock ticks to microseconds
+ */
+double ticksToMicroseconds(int64_t ticks) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::duration(ticks)).count();
+}
+
+}
+
+std::atomic<bool> Metrics::s_enabled{false};
+
+Metrics::Metrics()
+    : m_running(false)
+    , m_flushInterval(100)
+    , m_firstTraceEvent(true)
+    , m_epoch(std::chrono::steady_clock::now()) {
+}
+
+Metrics::~Metrics() {
+    stop();
+}
+
+Metrics& Metrics::getInstance() {
+    static Metrics instance;
+    return instance;
+}
+
+void Metrics::start(const Config& config) {
+    if (m_aggregator.joinable() || !config.getBool("metrics.enabled", true)) return;
+
+    m_flushInterval = std::chrono::milliseconds(std::max(1, config.getInt("metrics.flushInterval", 100)));
+    m_tracePath = config.getString("metrics.traceOutput", "");
+    m_epoch = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(m_summaryMutex);
+        m_summaries.fill(Summary());
+    }
+
+    if (!m_tracePath.empty()) {
+        m_trace.open(m_tracePath, std::ios::out | std::ios::trunc);
+        if (m_trace) {
+            m_trace << "{\"traceEvents\":[\n";
+            m_firstTraceEvent = true;
+            char text[128];
+            int length = std::snprintf(text, sizeof(text),
+                "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"black_hole_3d\"}}");
+            writeTraceEvent(text, length);
+
+            // Rings registered before start() still need their names written
+            std::lock_guard<std::mutex> lock(m_ringMutex);
+            for (auto& ring : m_rings) {
+                if (ring->name[0]) ring->nameChanged.store(true, std::memory_order_release);
+            }
+        } else {
+            Logger::getInstance().log(Logger::Level::WARNING, "Could not open trace output: " + m_tracePath);
+        }
+    }
+
+    m_running = true;
+    s_enabled.store(true, std::memory_order_relaxed);
+    m_aggregator = std::thread(&Metrics::run, this);
+
+    Logger::getInstance().log(Logger::Level::INFO,
+        "Metrics enabled" + (m_trace.is_open() ? ", writing trace to " + m_tracePath : std::string()));
+}
+
+void Metrics::stop() {
+    if (!m_aggregator.joinable()) return;
+
+    s_enabled.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+    m_aggregator.join();
+
+    if (m_trace.is_open()) {
+        m_trace << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        m_trace.close();
+    }
+
+    uint64_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_ringMutex);
+        for (auto& ring : m_rings) {
+            dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    for (size_t i = 0; i < ID_COUNT; ++i) {
+        Summary summary = getSummary(static_cast<Id>(i));
+        if (summary.count == 0) continue;
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "Metrics: %-12s %8llu scopes, %9.3f ms mean, %9.3f ms max",
+                      getName(static_cast<Id>(i)), static_cast<unsigned long long>(summary.count),
+                      summary.totalMilliseconds / summary.count, summary.maxMilliseconds);
+        Logger::getInstance().log(Logger::Level::INFO, line);
+    }
+    if (dropped > 0) {
+        Logger::getInstance().log(Logger::Level::WARNING,
+            "Metrics dropped " + std::to_string(dropped) + " events (rings full)");
+    }
+}
+
+void Metrics::record(Id id, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+    ThreadRing& ring = getThreadRing();
+
+    uint32_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+        ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring.events[head & (RING_CAPACITY - 1)] = {
+        begin.time_since_epoch().count(), end.time_since_epoch().count(), id
+    };
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Metrics::setThreadName(const char* name) {
+    ThreadRing& ring = getThreadRing();
+    std::strncpy(ring.name.data(), name, NAME_LENGTH - 1);
+    ring.nameChanged.store(true, std::memory_order_release);
+}
+
+Metrics::Summary Metrics::getSummary(Id id) const {
+    std::lock_guard<std::mutex> lock(m_summaryMutex);
+    return m_summaries[static_cast<size_t>(id)];
+}
+
+const char* Metrics::getName(Id id) {
+    switch (id) {
+        case Id::Frame:       return "frame";
+        case Id::Events:      return "events";
+        case Id::Render:      return "render";
+        case Id::Upload:      return "upload";
+        case Id::PhysicsStep: return "physics_step";
+        case Id::Forces:      return "forces";
+        case Id::OctreeBuild: return "octree_build";
+        case Id::Collisions:  return "collisions";
+        case Id::Readback:    return "readback";
+        case Id::Encode:      return "encode";
+        default:              return "unknown";
+    }
+}
+
+const char* Metrics::getCategory(Id id) {
+    switch (id) {
+        case Id::Render:
+        case Id::Upload:      return "render";
+        case Id::PhysicsStep:
+        case Id::Forces:
+        case Id::OctreeBuild:
+        case Id::Collisions:  return "physics";
+        case Id::Readback:
+        case Id::Encode:      return "io";
+        default:              return "engine";
+    }
+}
+
+Metrics::ThreadRing& Metrics::getThreadRing() {
+    if (t_ring) return *static_cast<ThreadRing*>(t_ring);
+
+    // First event on this thread: the only allocation a thread ever makes here
+    std::lock_guard<std::mutex> lock(m_ringMutex);
+    m_rings.push_back(std::make_unique<ThreadRing>());
+    m_rings.back()->threadId = static_cast<uint32_t>(m_rings.size());
+    t_ring = m_rings.back().get();
+    return *m_rings.back();
+}
+
+void Metrics::run() {
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    while (m_running) {
+        m_wake.wait_for(lock, m_flushInterval, [this] { return !m_running; });
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+}
+
+void Metrics::drain() {
+    std::vector<ThreadRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(m_ringMutex);
+        rings.reserve(m_rings.size());
+        for (auto& ring : m_rings) rings.push_back(ring.get());
+    }
+
+    const int64_t epoch = m_epoch.time_since_epoch().count();
+    char text[256];
+
+    std::lock_guard<std::mutex> lock(m_summaryMutex);
+    for (ThreadRing* ring : rings) {
+        if (ring->nameChanged.exchange(false, std::memory_order_acquire) && m_trace.is_open()) {
+            int length = std::snprintf(text, sizeof(text),
+                "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                ring->threadId, ring->name.data());
+            writeTraceEvent(text, length);
+        }
+
+        const uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+        const uint32_t head = ring->head.load(std::memory_order_acquire);
+        for (uint32_t i = tail; i != head; ++i) {
+            const Event& event = ring->events[i & (RING_CAPACITY - 1)];
+
+            Summary& summary = m_summaries[static_cast<size_t>(event.id)];
+            double duration = ticksToMicroseconds(event.end - event.begin);
+            summary.count++;
+            summary.totalMilliseconds += duration * 1e-3;
+            summary.maxMilliseconds = std::max(summary.maxMilliseconds, duration * 1e-3);
+
+            if (m_trace.is_open()) {
+                int length = std::snprintf(text, sizeof(text),
+                    "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    getName(event.id), getCategory(event.id), ring->threadId,
+                    ticksToMicroseconds(event.begin - epoch), duration);
+                writeTraceEvent(text, length);
+            }
+        }
+        ring->tail.store(head, std::memory_order_release);
+    }
+
+    if (m_trace.is_open()) m_trace.flush();
+}
+
+void Metrics::writeTraceEvent(const char* text, int length) {
+    if (length <= 0) return;
+    if (!m_firstTraceEvent) m_trace << ",\n";
+    m_trace.write(text, std::min<int>(length, 255));
+    m_firstTraceEvent = false;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file Metrics.h
+ * @brief Low-overhead scoped timers with a background trace writer
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Config.h"
+
+/**
+ * @brief Process-wide instrumentation for CPU work
+ *
+ * Instrumented code creates a ScopedTimer with one of the fixed Metrics::Id
+ * values. Timing a scope takes two clock reads and a store into a ring buffer
+ * owned by the calling thread: no lock, no allocation and no string work on
+ * the measured thread. A background aggregator drains every thread's ring
+ * each metrics.flushInterval milliseconds, keeps per-id totals and, when
+ * metrics.traceOutput is set, streams the events as Chrome trace-event JSON
+ * (load it in chrome://tracing or ui.perfetto.dev).
+ *
+ * When the aggregator falls behind, a full ring drops new events instead of
+ * blocking; the number dropped is reported on shutdown.
+ */
+class Metrics {
+public:
+    /**
+     * @brief Instrumented scopes
+     */
+    enum class Id : uint16_t {
+        Frame,          ///< One windowed or headless frame
+        Events,         ///< Window event polling
+        Render,         ///< Renderer::render command submission
+        Upload,         ///< Uniform and storage buffer uploads
+        PhysicsStep,    ///< One fixed physics step
+        Forces,         ///< Gravitational force evaluation
+        OctreeBuild,    ///< Barnes-Hut tree construction
+        Collisions,     ///< Collision detection and merging
+        Readback,       ///< Mapping a captured frame
+        Encode,         ///< Writing one output frame
+        Count
+    };
+
+    /**
+     * @brief Running totals of one id since start()
+     */
+    struct Summary {
+        uint64_t count = 0;             ///< Completed scopes
+        double totalMilliseconds = 0.0; ///< Sum of durations
+        double maxMilliseconds = 0.0;   ///< Longest scope
+    };
+
+    /**
+     * @brief Get the singleton instance
+     * @return Reference to the metrics registry
+     */
+    static Metrics& getInstance();
+
+    /**
+     * @brief Start recording and launch the aggregator thread
+     * @param config Configuration object (metrics section)
+     */
+    void start(const Config& config);
+
+    /**
+     * @brief Drain the remaining events, stop the aggregator and close the trace
+     */
+    void stop();
+
+    /**
+     * @brief Check whether scoped timers record (cheap, any thread)
+     * @return True between start() and stop() with metrics.enabled
+     */
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Record a finished scope into the calling thread's ring
+     * @param id Scope identifier
+     * @param begin Time the scope started
+     * @param end Time the scope ended
+     */
+    void record(Id id, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+
+    /**
+     * @brief Name the calling thread in the trace (allocates its ring if needed)
+     * @param name Thread name (truncated to 31 characters)
+     */
+    void setThreadName(const char* name);
+
+    /**
+     * @brief Get the totals the aggregator has collected so far
+     * @param id Scope identifier
+     * @return Totals since start()
+     */
+    Summary getSummary(Id id) const;
+
+    /**
+     * @brief Get the trace name of an id
+     * @param id Scope identifier
+     * @return Lowercase name
+     */
+    static const char* getName(Id id);
+
+    /**
+     * @brief Get the trace category of an id
+     * @param id Scope identifier
+     * @return Category ("engine", "render", "physics" or "io")
+     */
+    static const char* getCategory(Id id);
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+private:
+    static constexpr size_t ID_COUNT = static_cast<size_t>(Id::Count);
+    static constexpr uint32_t RING_CAPACITY = 8192;     ///< Events per thread (power of two)
+    static constexpr size_t NAME_LENGTH = 32;
+
+    /**
+     * @brief One finished scope
+     */
+    struct Event {
+        int64_t begin;      ///< steady_clock ticks
+        int64_t end;        ///< steady_clock ticks
+        Id id;              ///< Scope identifier
+    };
+
+    /**
+     * @brief Single-producer, single-consumer ring of one thread's events
+     */
+    struct ThreadRing {
+        std::array<Event, RING_CAPACITY> events;        ///< Ring storage
+        std::atomic<uint32_t> head{0};                  ///< Next slot written (owning thread)
+        std::atomic<uint32_t> tail{0};                  ///< Next slot read (aggregator)
+        std::atomic<uint64_t> dropped{0};               ///< Events lost to a full ring
+        std::array<char, NAME_LENGTH> name{};           ///< Trace thread name
+        std::atomic<bool> nameChanged{false};           ///< Name not yet written to the trace
+        uint32_t threadId = 0;                          ///< Trace thread id
+    };
+
+    static std::atomic<bool> s_enabled;                 ///< Fast check for ScopedTimer
+
+    mutable std::mutex m_ringMutex;                     ///< Guards m_rings (registration only)
+    std::vector<std::unique_ptr<ThreadRing>> m_rings;   ///< Every thread that has recorded
+
+    mutable std::mutex m_summaryMutex;                  ///< Guards m_summaries
+    std::array<Summary, ID_COUNT> m_summaries;          ///< Totals per id
+
+    std::thread m_aggregator;                           ///< Background drain thread
+    std::mutex m_wakeMutex;                             ///< Guards m_running for m_wake
+    std::condition_variable m_wake;                     ///< Ends the aggregator's sleep early
+    bool m_running;                                     ///< Aggregator should keep running
+    std::chrono::milliseconds m_flushInterval;          ///< Time between drains
+
+    std::ofstream m_trace;                              ///< Chrome trace output (closed if unused)
+    std::string m_tracePath;                            ///< Trace file name
+    bool m_firstTraceEvent;                             ///< No comma before the next event
+    std::chrono::steady_clock::time_point m_epoch;      ///< Trace timestamp zero
+
+    /**
+     * @brief Private constructor (singleton)
+     */
+    Metrics();
+
+    /**
+     * @brief Stops the aggregator if still running
+     */
+    ~Metrics();
+
+    /**
+     * @brief Get the calling thread's ring, registering it on first use
+     * @return Ring owned by the calling thread
+     */
+    ThreadRing& getThreadRing();
+
+    /**
+     * @brief Aggregator thread main loop
+     */
+    void run();
+
+    /**
+     * @brief Move every ring's pending events into the totals and the trace
+     */
+    void drain();
+
+    /**
+     * @brief Append one JSON object to the trace array
+     * @param text Serialized event
+     * @param length Characters in text
+     */
+    void writeTraceEvent(const char* text, int length);
+};
+
+/**
+ * @brief Times the enclosing scope under a fixed Metrics::Id
+ *
+ * Costs one relaxed atomic load when metrics are disabled.
+ */
+class ScopedTimer {
+public:
+    /**
+     * @brief Start timing
+     * @param id Scope identifier
+     */
+    explicit ScopedTimer(Metrics::Id id)
+        : m_id(id)
+        , m_active(Metrics::isEnabled()) {
+        if (m_active) m_begin = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Stop timing and record the event
+     */
+    ~ScopedTimer() {
+        if (m_active) Metrics::getInstance().record(m_id, m_begin, std::chrono::steady_clock::now());
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Metrics::Id m_id;                                   ///< Scope identifier
+    bool m_active;                                      ///< Metrics were enabled at construction
+    std::chrono::steady_clock::time_point m_begin;      ///< Start of the scope
+};
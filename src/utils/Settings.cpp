@@ -0,0 +1,98 @@
+/**
+ * @file Settings.cpp
+ * @brief Implementation of the pre-resolved configuration values
+ */
+
+#include "Settings.h"
+#include <algorithm>
+#include <vector>
+
+bool Settings::BlackHoleSettings::operator==(const BlackHoleSettings& other) const {
+    return position == other.position && mass == other.mass && name == other.name;
+}
+
+bool Settings::DiskSettings::operator==(const DiskSettings& other) const {
+    return innerRadius == other.innerRadius && outerRadius == other.outerRadius &&
+           temperature == other.temperature && thickness == other.thickness;
+}
+
+bool Settings::GeodesicSettings::operator==(const GeodesicSettings& other) const {
+    return tolerance == other.tolerance && maxSteps == other.maxSteps && movingSteps == other.movingSteps;
+}
+
+bool Settings::GridSettings::operator==(const GridSettings& other) const {
+    return size == other.size && spacing == other.spacing;
+}
+
+Settings::BlackHoleSettings Settings::BlackHoleSettings::fromConfig(const Config& config) {
+    BlackHoleSettings settings;
+    std::vector<double> position = config.getDoubleArray("blackHole.position", {0.0, 0.0, 0.0});
+    for (size_t axis = 0; axis < std::min<size_t>(3, position.size()); ++axis) {
+        settings.position[static_cast<int>(axis)] = static_cast<float>(position[axis]);
+    }
+    settings.mass = config.getDouble("blackHole.mass", settings.mass);
+    settings.name = config.getString("blackHole.name", settings.name);
+    return settings;
+}
+
+Settings::DiskSettings Settings::DiskSettings::fromConfig(const Config& config) {
+    DiskSettings settings;
+    settings.innerRadius = config.getFloat("accretionDisk.innerRadius", settings.innerRadius);
+    settings.outerRadius = config.getFloat("accretionDisk.outerRadius", settings.outerRadius);
+    settings.temperature = config.getFloat("accretionDisk.temperature", settings.temperature);
+    settings.thickness = config.getFloat("accretionDisk.thickness", settings.thickness);
+    return settings;
+}
+
+Settings::GeodesicSettings Settings::GeodesicSettings::fromConfig(const Config& config) {
+    GeodesicSettings settings;
+    settings.tolerance = std::max(1e-6f, config.getFloat("rendering.geodesicTolerance", settings.tolerance));
+    settings.maxSteps = config.getInt("rendering.maxGeodesicSteps", settings.maxSteps);
+    settings.movingSteps = config.getInt("rendering.movingGeodesicSteps", settings.movingSteps);
+    return settings;
+}
+
+Settings::GridSettings Settings::GridSettings::fromConfig(const Config& config) {
+    GridSettings settings;
+    settings.size = std::max(1, config.getInt("rendering.gridSize", settings.size));
+    settings.spacing = config.getFloat("rendering.gridSpacing", settings.spacing);
+    return settings;
+}
+
+Settings Settings::fromConfig(const Config& config) {
+    Settings settings;
+    settings.blackHole = BlackHoleSettings::fromConfig(config);
+    settings.disk = DiskSettings::fromConfig(config);
+    settings.geodesic = GeodesicSettings::fromConfig(config);
+    settings.grid = GridSettings::fromConfig(config);
+    return settings;
+}
+
+uint32_t Settings::compare(const Settings& previous) const {
+    uint32_t changes = NONE;
+    if (blackHole != previous.blackHole) changes |= BLACK_HOLE;
+    if (disk != previous.disk) changes |= DISK;
+    if (geodesic != previous.geodesic) changes |= GEODESIC;
+    if (grid != previous.grid) changes |= GRID;
+    return changes;
+}
+
+std::string Settings::describe(uint32_t changes) {
+    static const struct {
+        Change change;
+        const char* name;
+    } groups[] = {
+        {BLACK_HOLE, "blackHole"},
+        {DISK, "accretionDisk"},
+        {GEODESIC, "geodesic"},
+        {GRID, "grid"}
+    };
+
+    std::string text;
+    for (const auto& group : groups) {
+        if (!(changes & group.change)) continue;
+        if (!text.empty()) text += ", ";
+        text += group.name;
+    }
+    return text.empty() ? "none" : text;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file Settings.h
+ * @brief Typed, pre-resolved configuration values read on the frame path
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+
+#include "Config.h"
+
+/**
+ * @brief Configuration values resolved once from Config into plain fields
+ *
+ * Config lookups split the dotted key and walk the JSON tree on every call,
+ * which is fine at startup but not per frame. Subsystems build a Settings
+ * when they are created and read its fields afterwards; on hot reload a new
+ * Settings is built and compare() reports which groups actually changed, so
+ * only the affected GPU buffers are re-uploaded.
+ */
+struct Settings {
+    /**
+     * @brief Groups reported by compare()
+     */
+    enum Change : uint32_t {
+        NONE = 0,
+        BLACK_HOLE = 1 << 0,    ///< blackHole.*
+        DISK = 1 << 1,          ///< accretionDisk.*
+        GEODESIC = 1 << 2,      ///< rendering geodesic step limits and tolerance
+        GRID = 1 << 3           ///< rendering grid size and spacing
+    };
+
+    /**
+     * @brief Central black hole (blackHole section)
+     */
+    struct BlackHoleSettings {
+        glm::vec3 position{0.0f};               ///< Position (m)
+        double mass = 8.54e36;                  ///< Mass (kg)
+        std::string name = "Sagittarius A*";    ///< Display name
+
+        /**
+         * @brief Resolve the group from a configuration
+         * @param config Configuration object (blackHole section)
+         * @return Config values or the defaults above
+         */
+        static BlackHoleSettings fromConfig(const Config& config);
+
+        bool operator==(const BlackHoleSettings& other) const;
+        bool operator!=(const BlackHoleSettings& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Accretion disk shading parameters (accretionDisk section), in AccretionDisk UBO order
+     */
+    struct DiskSettings {
+        float innerRadius = 2.785e10f;  ///< Inner edge (m)
+        float outerRadius = 6.595e10f;  ///< Outer edge (m)
+        float temperature = 10000.0f;   ///< Peak temperature (K)
+        float thickness = 1e9f;         ///< Half thickness (m)
+
+        /**
+         * @brief Resolve the group from a configuration
+         * @param config Configuration object (accretionDisk section)
+         * @return Config values or the defaults above
+         */
+        static DiskSettings fromConfig(const Config& config);
+
+        bool operator==(const DiskSettings& other) const;
+        bool operator!=(const DiskSettings& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Geodesic integration limits (rendering section)
+     */
+    struct GeodesicSettings {
+        float tolerance = 1e-5f;    ///< Error tolerance for a still camera (at least 1e-6)
+        int maxSteps = 2000;        ///< Step limit for a still camera
+        int movingSteps = 1000;     ///< Step limit while the camera moves
+
+        /**
+         * @brief Resolve the group from a configuration
+         * @param config Configuration object (rendering section)
+         * @return Config values or the defaults above
+         */
+        static GeodesicSettings fromConfig(const Config& config);
+
+        bool operator==(const GeodesicSettings& other) const;
+        bool operator!=(const GeodesicSettings& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief Spacetime grid layout (rendering section)
+     */
+    struct GridSettings {
+        int size = 25;              ///< Lines per side (at least 1)
+        float spacing = 1e10f;      ///< Distance between lines (m)
+
+        /**
+         * @brief Resolve the group from a configuration
+         * @param config Configuration object (rendering section)
+         * @return Config values or the defaults above
+         */
+        static GridSettings fromConfig(const Config& config);
+
+        bool operator==(const GridSettings& other) const;
+        bool operator!=(const GridSettings& other) const { return !(*this == other); }
+    };
+
+    BlackHoleSettings blackHole;    ///< blackHole.*
+    DiskSettings disk;              ///< accretionDisk.*
+    GeodesicSettings geodesic;      ///< rendering.geodesicTolerance, maxGeodesicSteps, movingGeodesicSteps
+    GridSettings grid;              ///< rendering.gridSize, gridSpacing
+
+    /**
+     * @brief Resolve every group from a configuration
+     * @param config Configuration object
+     * @return Settings with config values or the built-in defaults
+     */
+    static Settings fromConfig(const Config& config);
+
+    /**
+     * @brief Find the groups that differ from an earlier Settings
+     * @param previous Settings to compare against
+     * @return Bitwise OR of Change values (NONE if nothing changed)
+     */
+    uint32_t compare(const Settings& previous) const;
+
+    /**
+     * @brief Describe a change mask for logging
+     * @param changes Bitwise OR of Change values
+     * @return Comma-separated group names, e.g. "accretionDisk, grid"
+     */
+    static std::string describe(uint32_t changes);
+};